@@ -282,6 +282,10 @@ def addCommonOptions(parser):
                         default=2200,
                         action="store", type=int,
                         help="Message server listen port\nDEFAULT: 2200")
+    parser.add_argument(
+        "--dist-transport", default="tcp", choices=["tcp", "shm"],
+        help="Message transport among dist-gem5 processes; shm needs all "
+        "of them on one host\nDEFAULT: tcp")
     parser.add_argument(
         "--dist-sync-repeat", default="0us", action="store", type=str,
         help="Repeat interval for synchronisation barriers among "
@@ -54,7 +54,8 @@ def build_switch(args):
                                       sync_start = args.dist_sync_start,
                                       sync_repeat = args.dist_sync_repeat,
                                       is_switch = True,
-                                      num_nodes = args.dist_size)
+                                      num_nodes = args.dist_size,
+                                      transport = args.dist_transport)
                        for i in range(args.dist_size)]
 
     for (i, link) in enumerate(switch.portlink):
@@ -21,6 +21,8 @@ system.engine = DuetBarnesEngine (
         num_callers = args.numcpus,
         baseaddr    = args.duet_addr
         )
+if args.trace_record:
+    system.engine.trace_record = args.trace_record
 system.engine.clk_domain = SrcClockDomain (
         clock = '500MHz',
         voltage_domain = VoltageDomain () )
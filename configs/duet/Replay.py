@@ -0,0 +1,58 @@
+import sys, os, argparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from duet.util import add_common_arguments, build_memory_system, integrate
+
+# Replay traces recorded with `--duet-trace-record` against the memory system
+# configured on the command line. The host processors are not simulated: the
+# engines are driven by the recorded SRI accesses, so only engine-side and
+# memory-side parameters are meaningful here.
+
+engine_types = {
+        "barnes":       DuetBarnesEngine,
+        "quadbarnes":   DuetBarnesQuadEngine,
+        "fmmvli":       DuetFmmVLIEngine,
+        }
+
+parser = argparse.ArgumentParser ()
+add_common_arguments ( parser )
+
+parser.add_argument ( "--engine",   dest="engine",  type=str, required=True
+        , choices=engine_types.keys () )
+parser.add_argument ( "--trace",    dest="traces",  type=str, required=True, nargs="+"
+        , help="Recorded trace(s), one per engine" )
+parser.add_argument ( "--fifo-capacity", dest="fifocap", type=int, default=None )
+
+args = parser.parse_args ()
+system = build_memory_system ( args )
+
+system.engines = [engine_types[args.engine] (
+        num_callers     = args.numcpus,
+        baseaddr        = args.duet_addr + (i << 13),   # 8kB per engine
+        trace_replay    = trace,
+        ) for i, trace in enumerate (args.traces)]
+
+for engine in system.engines:
+    if args.fifocap is not None:
+        engine.fifo_capacity = args.fifocap
+    integrate ( args, system, None, engine )
+
+root = Root (full_system = False, system = system)
+m5.instantiate ()
+
+print("Beginning replay!")
+remaining = len (system.engines)
+while True:
+    exit_event = m5.simulate()
+    if exit_event.getCause() == "Duet engine trace replay finished":
+        remaining -= 1
+        if remaining > 0:
+            continue
+    break
+print('Exiting @ tick {} because {}'
+      .format(m5.curTick(), exit_event.getCause()))
@@ -0,0 +1,72 @@
+import m5, os, sys
+from m5.objects import *
+
+# Each call of the naive functor loads a word, stores it back incremented and
+# returns. With the write-combining buffer enabled, the stores are
+# acknowledged once buffered, so the host only reads the right data if the
+# buffer is drained before the calls return. The timeout is long enough that
+# the buffer is never flushed by it, and two memory ports let the flushed
+# writes complete out of order.
+
+num_threads = 4
+range_      = AddrRange('8192MB')
+
+nc_base     = 0xE10298000
+nc_range    = AddrRange(nc_base, size='4kB')
+
+system = System (
+        mem_mode = 'timing',
+        mem_ranges = [range_, nc_range]
+        )
+
+system.clk_domain = SrcClockDomain( clock = '1GHz', voltage_domain = VoltageDomain() )
+system.cpus = [TimingSimpleCPU() for _ in range(num_threads)]
+system.mem_ctrl = MemCtrl( dram = DDR3_1600_8x8( range = range_ ) )
+system.engine = NaiveEngine ()
+system.membus = SystemXBar()
+
+for cpu in system.cpus:
+    cpu.createInterruptController()
+    cpu.icache_port = system.membus.cpu_side_ports
+    cpu.dcache_port = system.membus.cpu_side_ports
+
+system.engine.lanes[0].transition_from_stage = [0, 1, 2, 3, 4]
+system.engine.lanes[0].transition_to_stage   = [1, 2, 3, 4, 5]
+system.engine.lanes[0].transition_latency    = [1, 1, 1, 1, 1]
+system.engine.fifo_capacity = 128
+system.engine.wcb_entries   = 4
+system.engine.wcb_timeout   = 1000000
+
+system.system_port          = system.membus.cpu_side_ports
+system.engine.num_callers   = num_threads
+system.engine.baseaddr      = nc_base
+system.engine.sri_port      = system.membus.mem_side_ports
+system.engine.mem_ports     = [ system.membus.cpu_side_ports ] * 2
+system.mem_ctrl.port        = system.membus.mem_side_ports
+
+binary = os.path.join (os.path.dirname (os.path.abspath(__file__)),
+        "../../tests/test-progs/duet/bin/riscv/linux/test_naive")
+process = Process(
+        cmd = [binary],
+        drivers = DuetDriver(
+            filename = "duet",
+            range = nc_range
+            )
+        )
+
+system.workload = SEWorkload.init_compatible (binary)
+for cpu in system.cpus:
+    cpu.workload = process
+    cpu.createThreads()
+system.engine.process = process
+
+root = Root (full_system = False, system = system)
+m5.instantiate ()
+
+print("Beginning simulation!")
+exit_event = m5.simulate()
+print('Exiting @ tick {} because {}'
+      .format(m5.curTick(), exit_event.getCause()))
+
+# the test program exits with 1 if it reads stale data
+sys.exit (exit_event.getCode ())
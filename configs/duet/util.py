@@ -2,7 +2,7 @@ import sys, os, argparse, math
 
 import m5
 from m5.objects import *
-from m5.util import addToPath
+from m5.util import addToPath, fatal
 
 addToPath('../')
 
@@ -43,6 +43,7 @@ def add_common_arguments ( parser ):
     parser.add_argument ('--l1d-data-latency',  dest='l1d_dlat',    type=int, default=1)
     parser.add_argument ('--l1d-resp-latency',  dest='l1d_rlat',    type=int, default=1)
     parser.add_argument ('--l1d-mshrs',         dest='l1d_mshrs',   type=int, default=8)
+    parser.add_argument ('--l1d-pointer-prefetch', dest='l1d_cdp',  action='store_true', default=False)
     
     #   - CPUs' L1I caches
     parser.add_argument ('--l1i-size',          dest='l1i_size',    type=str, default='32kB')
@@ -88,6 +89,24 @@ def add_common_arguments ( parser ):
             , choices=["soft","hard","both","none","io"] )
     parser.add_argument ('--async-fifo-stages',     dest='afstage', type=int, default=4)
     parser.add_argument ('--async-fifo-capacity',   dest='afcap',   type=int, default=64)
+    parser.add_argument ('--duet-wcb-entries',      dest='wcbentries', type=int, default=0)
+    parser.add_argument ('--duet-wcb-timeout',      dest='wcbtimeout', type=int, default=64)
+    parser.add_argument ('--duet-arbitration',      dest='arbitration', type=str, default='RoundRobin',
+            choices=['RoundRobin', 'Weighted', 'OldestFirst', 'Deadline'])
+    parser.add_argument ('--duet-caller-weights',   dest='weights', type=str, default=None,
+            help='Comma-separated per-caller weights for weighted arbitration')
+    parser.add_argument ('--duet-caller-deadlines', dest='deadlines', type=str, default=None,
+            help='Comma-separated per-caller waiting time targets (engine cycles)')
+    parser.add_argument ('--duet-caller-slots',     dest='callerslots', type=int, default=0,
+            help='Physical caller slots shared by the callers (0: one per caller)')
+    parser.add_argument ('--duet-pointer-prefetch', dest='duet_cdp', action='store_true', default=False,
+            help='Attach a content-directed prefetcher to the soft cache')
+    parser.add_argument ('--duet-dvfs-clks',        dest='dvfsclks', type=str, default=None,
+            help='Comma-separated engine clocks, fastest first. Enables the DVFS governor')
+    parser.add_argument ('--duet-dvfs-volts',       dest='dvfsvolts', type=str, default=None,
+            help='Comma-separated voltages matching --duet-dvfs-clks')
+    parser.add_argument ('--duet-trace-record',     dest='trace_record', type=str, default=None,
+            help='Record SRI and memory accesses of each engine into this trace')
 
     # duet's soft cache config (default same as L1D)
     parser.add_argument ("--ds-size",           dest="ds_size",     type=str, default=None)
@@ -108,7 +127,8 @@ def add_common_arguments ( parser ):
 # ============================================================================
 # == Build Base System based on Arguments ====================================
 # ============================================================================
-def build_system_and_process ( args ):
+def build_memory_system ( args ):
+    """Build the system with its buses, LLC and main memory, but no CPUs"""
 
     # -- System --------------------------------------------------------------
     memrange = AddrRange ( args.memsize )
@@ -152,6 +172,25 @@ def build_system_and_process ( args ):
     system.system_port = system.membus.cpu_side_ports
     system.mem_ctrl.port = system.membus.mem_side_ports
 
+    # -- LLC Caches -----------------------------------------------------------
+    system.llc = Cache (
+            size                = args.llc_size,
+            assoc               = args.llc_assoc,
+            tag_latency         = args.llc_tlat,
+            data_latency        = args.llc_dlat,
+            response_latency    = args.llc_rlat,
+            mshrs               = args.llc_mshrs,
+            tgts_per_mshr       = 32
+            )
+    system.llc.cpu_side = system.llcbus.mem_side_ports
+    system.llc.mem_side = system.membus.cpu_side_ports
+
+    return system
+
+def build_system_and_process ( args ):
+    system = build_memory_system ( args )
+    memrange = AddrRange ( args.memsize )
+
     # -- CPUs and L1 Caches --------------------------------------------------
     system.cpus = [ ObjectList.cpu_list.get ( args.cputype ) ()
             for _ in range ( args.numcpus ) ]
@@ -209,19 +248,6 @@ def build_system_and_process ( args ):
 
         cpu.createInterruptController ()
 
-    # -- LLC Caches -----------------------------------------------------------
-    system.llc = Cache (
-            size                = args.llc_size,
-            assoc               = args.llc_assoc,
-            tag_latency         = args.llc_tlat,
-            data_latency        = args.llc_dlat,
-            response_latency    = args.llc_rlat,
-            mshrs               = args.llc_mshrs,
-            tgts_per_mshr       = 32
-            )
-    system.llc.cpu_side = system.llcbus.mem_side_ports
-    system.llc.mem_side = system.membus.cpu_side_ports
-
     # -- executable ----------------------------------------------------------
     binary = os.path.abspath ( args.binary )
     process = Process (
@@ -244,6 +270,8 @@ def build_system_and_process ( args ):
     system.workload = SEWorkload.init_compatible ( binary )
     for cpu in system.cpus:
         cpu.workload = process
+        if args.l1d_cdp:
+            cpu.dcache.prefetcher = ContentDirectedPrefetcher ( process = process )
         cpu.createThreads ()
     if args.gdb:
         system.workload.wait_for_remote_gdb = True
@@ -260,10 +288,31 @@ def uno (*args):
     return None
 
 def integrate ( args, system, process, engine ):
-    engine.process = process
-    engine.clk_domain = SrcClockDomain (
-            clock = args.duetclk,
-            voltage_domain = VoltageDomain () )
+    if process is not None:
+        engine.process = process
+    if args.trace_record:
+        engine.trace_record = args.trace_record
+    engine.wcb_entries = args.wcbentries
+    engine.wcb_timeout = args.wcbtimeout
+    engine.arbitration = args.arbitration
+    if args.weights:
+        engine.caller_weights = [ int (w) for w in args.weights.split (',') ]
+    if args.deadlines:
+        engine.caller_deadlines = [ int (d) for d in args.deadlines.split (',') ]
+    engine.caller_slots = args.callerslots
+    if args.dvfsclks:
+        clks = args.dvfsclks.split (',')
+        volts = args.dvfsvolts.split (',') if args.dvfsvolts else [ '1.0V' ]
+        if len (volts) not in ( 1, len (clks) ):
+            fatal ( "--duet-dvfs-volts must have one voltage or one per clock" )
+        engine.clk_domain = SrcClockDomain (
+                clock = clks,
+                voltage_domain = VoltageDomain ( voltage = volts ) )
+        engine.governor = DuetDVFSGovernor ()
+    else:
+        engine.clk_domain = SrcClockDomain (
+                clock = args.duetclk,
+                voltage_domain = VoltageDomain () )
     engine.sri_afifo = DuetAsyncFIFO (
             stage = args.afstage, capacity = args.afcap, 
             upstream_clk_domain = system.clk_domain,
@@ -286,6 +335,11 @@ def integrate ( args, system, process, engine ):
                 )
         engine.mem_ports = engine.softcache.cpu_side
 
+        # pointers in the loaded lines are virtual addresses of the process
+        if args.duet_cdp and process is not None:
+            engine.softcache.prefetcher = ContentDirectedPrefetcher (
+                    process = process )
+
     # create hard cache if specified
     if args.duetcache in ["hard", "both"]:
         engine.hardcache = Cache (
@@ -338,7 +338,8 @@ elif len(bm) == 1 and args.dist:
                         args.dist_sync_start,
                         args.ethernet_linkspeed,
                         args.ethernet_linkdelay,
-                        args.etherdump);
+                        args.etherdump,
+                        args.dist_transport);
 elif len(bm) == 1:
     root = Root(full_system=True, system=test_sys)
 else:
@@ -0,0 +1,124 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Host-time scaling benchmark for parallel (multi event queue) simulation.
+#
+# The script builds a number of identical partitions, each with a few
+# memory testers behind an L1 cache, a crossbar and a private memory, and
+# gives every partition its own event queue. The partitions only interact
+# through the quantum barrier (a GlobalSyncEvent) and the cross-queue
+# event posting that comes with it, so the host speedup over a run with
+# one queue shows what the synchronization costs. The amount of work per
+# partition is fixed, so a perfect scaling run takes the same host time
+# for any number of queues when each queue gets its own host thread.
+#
+# Sweep the number of queues with something like:
+#
+#   for n in 1 2 4 8; do
+#       build/NULL/gem5.opt -d m5out/q$n configs/example/parallel_scaling.py \
+#           --queues $n
+#   done
+#
+# and compare the "host seconds" lines. With --queues 1 all partitions
+# share one queue and no barrier is used.
+
+import argparse
+import time
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+from m5.util.convert import anyToLatency
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("--queues", type=int, default=1,
+                    help="Number of event queues (host threads)")
+parser.add_argument("--partitions", type=int, default=0,
+                    help="Number of partitions, defaults to --queues")
+parser.add_argument("--testers", type=int, default=2,
+                    help="Memory testers per partition")
+parser.add_argument("--quantum", default="1us",
+                    help="Simulation quantum between queue barriers")
+parser.add_argument("--sim-time", default="10ms",
+                    help="Simulated time to run for")
+
+args = parser.parse_args()
+
+partitions = args.partitions if args.partitions else args.queues
+if partitions % args.queues:
+    fatal("The partitions must be spread evenly over the queues")
+
+# Each partition owns a 16MiB slice of the address space
+slice_size = 16 * 1024 * 1024
+
+system = System()
+system.voltage_domain = VoltageDomain(voltage = '1V')
+system.clk_domain = SrcClockDomain(clock = '2GHz',
+                                   voltage_domain = system.voltage_domain)
+system.mem_mode = 'timing'
+
+parts = []
+for i in range(partitions):
+    base = i * slice_size
+    part = SubSystem(eventq_index = i * args.queues // partitions)
+    part.mem = SimpleMemory(range = AddrRange(base, size = slice_size),
+                            latency = '30ns')
+    part.xbar = L2XBar()
+    part.cache = NoncoherentCache(size = '32kB', assoc = 4,
+                                  tag_latency = 2, data_latency = 2,
+                                  response_latency = 2, mshrs = 8,
+                                  tgts_per_mshr = 8)
+    part.tester = [MemTest(base_addr_1 = base + 0x100000,
+                           base_addr_2 = base + 0x400000,
+                           uncacheable_base_addr = base + 0x800000,
+                           percent_uncacheable = 0,
+                           percent_functional = 0)
+                   for t in range(args.testers)]
+    for tester in part.tester:
+        tester.port = part.xbar.cpu_side_ports
+    part.xbar.mem_side_ports = part.cache.cpu_side
+    part.cache.mem_side = part.mem.port
+    parts.append(part)
+system.partition = parts
+
+root = Root(full_system = False, system = system)
+if args.queues > 1:
+    root.sim_quantum = int(m5.ticks.fromSeconds(
+        anyToLatency(args.quantum)))
+
+m5.instantiate()
+
+sim_ticks = int(m5.ticks.fromSeconds(
+    anyToLatency(args.sim_time)))
+start = time.time()
+exit_event = m5.simulate(sim_ticks)
+host_seconds = time.time() - start
+
+print("queues: %d partitions: %d quantum: %s" %
+      (args.queues, partitions, args.quantum if args.queues > 1 else "-"))
+print("host seconds: %.3f" % host_seconds)
+print("simulated ticks per host second: %.0f" %
+      (m5.curTick() / host_seconds))
+print("exit: %s" % exit_event.getCause())
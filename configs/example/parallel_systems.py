@@ -0,0 +1,101 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Runs several independent design points in one gem5 process.
+#
+# Every design point is a separate System with a few memory testers behind
+# an L1 cache and a private memory, and gets its own event queue. The root
+# declares the event queues independent, so each System runs on its own
+# host thread without a simulation quantum, and simulate() returns once
+# every System has exited (here, when one of its testers reached
+# --max-loads). The stats of each System are then dumped separately.
+#
+# The design points sweep the memory latency, e.g.:
+#
+#   build/NULL/gem5.opt configs/example/parallel_systems.py \
+#       --mem-latency 10ns 30ns 50ns 100ns
+
+import argparse
+import time
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("--mem-latency", nargs="+",
+                    default=["10ns", "30ns", "50ns", "100ns"],
+                    help="Memory latency of each design point")
+parser.add_argument("--testers", type=int, default=2,
+                    help="Memory testers per design point")
+parser.add_argument("--max-loads", type=int, default=100000,
+                    help="Loads a tester performs before its System exits")
+
+args = parser.parse_args()
+
+systems = []
+for i, latency in enumerate(args.mem_latency):
+    # Children inherit the event queue of their parent
+    system = System(eventq_index = i)
+    system.voltage_domain = VoltageDomain(voltage = '1V')
+    system.clk_domain = SrcClockDomain(clock = '2GHz',
+                                       voltage_domain = system.voltage_domain)
+    system.mem_mode = 'timing'
+    system.mem_ranges = [ AddrRange('16MiB') ]
+
+    system.mem = SimpleMemory(range = system.mem_ranges[0],
+                              latency = latency)
+    system.xbar = L2XBar()
+    system.cache = NoncoherentCache(size = '32kB', assoc = 4,
+                                    tag_latency = 2, data_latency = 2,
+                                    response_latency = 2, mshrs = 8,
+                                    tgts_per_mshr = 8)
+    system.tester = [MemTest(max_loads = args.max_loads,
+                             percent_uncacheable = 0,
+                             percent_functional = 0)
+                     for t in range(args.testers)]
+    for tester in system.tester:
+        tester.port = system.xbar.cpu_side_ports
+    system.xbar.mem_side_ports = system.cache.cpu_side
+    system.cache.mem_side = system.mem.port
+    system.system_port = system.xbar.cpu_side_ports
+    systems.append(system)
+
+root = Root(full_system = False, independent_eventqs = True)
+root.design_point = systems
+
+m5.instantiate()
+
+start = time.time()
+exit_event = m5.simulate()
+host_seconds = time.time() - start
+
+print("design points: %d host seconds: %.3f" %
+      (len(systems), host_seconds))
+print("exit: %s" % exit_event.getCause())
+for i, event in enumerate(m5.getExitEvents()):
+    print("event queue %d exit: %s" % (i, event.getCause()))
+
+for system in systems:
+    m5.stats.dump([ system ])
@@ -0,0 +1,111 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a packet trace recorded by a CommMonitor (or a MemTraceProbe)
+# against a last-level cache and a memory configuration, without the
+# CPUs that produced it. Record the trace with a CommMonitor in front of
+# the part of the memory system to sweep, e.g. between the L1 caches and
+# the L2 bus, and then sweep the configurations with something like:
+#
+#   for size in 512kB 1MB 2MB; do
+#       build/NULL/gem5.opt -d m5out/l2_$size \
+#           configs/example/trace_replay.py --trace-file=cpu.trc \
+#           --l2cache --l2_size=$size --mem-type=DDR4_2400_8x8
+#   done
+#
+# Leave traces uncompressed to replay them at full speed, the replayer
+# maps them into memory. The replay throughput is reported at the end
+# and in the hostRate stat of the replayer.
+
+import argparse
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import Options
+from common import MemConfig
+from common.Caches import L2Cache
+
+parser = argparse.ArgumentParser()
+Options.addNoISAOptions(parser)
+
+parser.add_argument("--trace-file", required=True,
+                    help="Packet trace to replay")
+parser.add_argument("--no-timing", action="store_true",
+                    help="Ignore the recorded timing and replay the "
+                    "requests as fast as the limits allow")
+parser.add_argument("--max-outstanding", type=int, default=0,
+                    help="Maximum outstanding requests, 0 is unlimited")
+parser.add_argument("--max-outstanding-per-requestor", type=int, default=0,
+                    help="Maximum outstanding requests of each recorded "
+                    "requestor, 0 is unlimited")
+parser.add_argument("--dependency-window", type=int, default=0,
+                    help="Hold requests back while an earlier request to "
+                    "the same block, at most this many requests before, "
+                    "is outstanding")
+
+args = parser.parse_args()
+
+system = System(membus = SystemXBar())
+system.voltage_domain = VoltageDomain(voltage = args.sys_voltage)
+system.clk_domain = SrcClockDomain(clock = args.sys_clock,
+                                   voltage_domain = system.voltage_domain)
+system.cache_line_size = args.cacheline_size
+system.mem_ranges = [AddrRange(args.mem_size)]
+system.mem_mode = 'timing'
+
+# The data of the trace is not recorded, do not bother storing it
+system.mmap_using_noreserve = True
+
+system.replayer = TraceReplayer(
+    trace_file = args.trace_file,
+    honor_timing = not args.no_timing,
+    max_outstanding = args.max_outstanding,
+    max_outstanding_per_requestor = args.max_outstanding_per_requestor,
+    dependency_window = args.dependency_window)
+
+if args.l2cache:
+    system.l2 = L2Cache(size = args.l2_size, assoc = args.l2_assoc)
+    system.tol2bus = L2XBar()
+    system.replayer.port = system.tol2bus.cpu_side_ports
+    system.tol2bus.mem_side_ports = system.l2.cpu_side
+    system.l2.mem_side = system.membus.cpu_side_ports
+else:
+    system.replayer.port = system.membus.cpu_side_ports
+
+system.system_port = system.membus.cpu_side_ports
+
+MemConfig.config_mem(args, system)
+for ctrl in system.mem_ctrls:
+    if hasattr(ctrl, "dram"):
+        ctrl.dram.null = True
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+exit_event = m5.simulate(args.abs_max_tick)
+print("Exiting @ tick %i because %s" % (m5.curTick(), exit_event.getCause()))
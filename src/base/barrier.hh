@@ -38,43 +38,88 @@
 #ifndef __BASE_BARRIER_HH__
 #define __BASE_BARRIER_HH__
 
+#include <atomic>
 #include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace gem5
 {
 
+/**
+ * A reusable thread barrier. Threads arrive with an atomic decrement and
+ * the last one to arrive starts the next generation. The others first
+ * spin on the generation counter for a bounded number of iterations, as
+ * barrier phases (e.g., parallel simulation quanta) are often short, and
+ * then block on a condition variable so that a long phase does not burn
+ * CPU time. Threads never spin if there are more of them than hardware
+ * threads, since a spinning thread would then delay the ones it waits for.
+ */
 class Barrier
 {
   private:
-    /// Mutex to protect access to numLeft and generation
+    /// Mutex and condition variable for threads that stopped spinning
     std::mutex bMutex;
-    /// Condition variable for waiting on barrier
     std::condition_variable bCond;
     /// Number of threads we should be waiting for before completing the barrier
-    unsigned numWaiting;
+    const unsigned numWaiting;
+    /// Number of polls of the generation before a thread blocks
+    const unsigned spinLimit;
     /// Generation of this barrier
-    unsigned generation;
+    std::atomic<unsigned> generation;
     /// Number of threads remaining for the current generation
-    unsigned numLeft;
+    std::atomic<unsigned> numLeft;
+
+    static void
+    cpuRelax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
 
   public:
-    Barrier(unsigned _numWaiting)
-        : numWaiting(_numWaiting), generation(0), numLeft(_numWaiting)
+    static constexpr unsigned DefaultSpinLimit = 2048;
+
+    Barrier(unsigned _numWaiting, unsigned spin_limit=DefaultSpinLimit)
+        : numWaiting(_numWaiting),
+          spinLimit(_numWaiting <= std::thread::hardware_concurrency() ?
+                    spin_limit : 0),
+          generation(0), numLeft(_numWaiting)
     {}
 
+    /**
+     * Wait until all threads have arrived.
+     *
+     * @return True in exactly one of the threads (the last to arrive).
+     */
     bool
     wait()
     {
-        std::unique_lock<std::mutex> lock(bMutex);
-        unsigned int gen = generation;
+        unsigned gen = generation.load(std::memory_order_acquire);
 
-        if (--numLeft == 0) {
-            generation++;
-            numLeft = numWaiting;
+        if (numLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Nobody can arrive for the next generation before they see
+            // the generation change, so reset the count first.
+            numLeft.store(numWaiting, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(bMutex);
+                generation.store(gen + 1, std::memory_order_release);
+            }
             bCond.notify_all();
             return true;
         }
-        while (gen == generation)
+
+        for (unsigned i = 0; i < spinLimit; i++) {
+            if (generation.load(std::memory_order_acquire) != gen)
+                return false;
+            cpuRelax();
+        }
+
+        std::unique_lock<std::mutex> lock(bMutex);
+        while (generation.load(std::memory_order_acquire) == gen)
             bCond.wait(lock);
         return false;
     }
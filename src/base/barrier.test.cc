@@ -0,0 +1,88 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "base/barrier.hh"
+
+using namespace gem5;
+
+/**
+ * Exactly one thread completes each generation, and no thread leaves a
+ * generation before all threads arrived.
+ */
+static void
+checkBarrier(unsigned spin_limit)
+{
+    const int num_threads = 4;
+    const int rounds = 2000;
+
+    Barrier barrier(num_threads, spin_limit);
+    std::atomic<int> arrived(0);
+    std::atomic<int> completions(0);
+    std::atomic<bool> overtaken(false);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&]() {
+            for (int r = 0; r < rounds; ++r) {
+                arrived++;
+                if (barrier.wait())
+                    completions++;
+                // Everybody arrived for this round, and nobody can get
+                // past the second barrier before this thread does.
+                if (arrived.load() != (r + 1) * num_threads)
+                    overtaken = true;
+                barrier.wait();
+            }
+        });
+    }
+    for (auto &thread: threads)
+        thread.join();
+
+    EXPECT_EQ(completions, rounds);
+    EXPECT_FALSE(overtaken);
+}
+
+TEST(BarrierTest, Spinning)
+{
+    checkBarrier(Barrier::DefaultSpinLimit);
+}
+
+TEST(BarrierTest, Blocking)
+{
+    checkBarrier(0);
+}
+
+TEST(BarrierTest, SingleThread)
+{
+    Barrier barrier(1);
+    for (int i = 0; i < 10; ++i)
+        EXPECT_TRUE(barrier.wait());
+}
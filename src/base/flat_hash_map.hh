@@ -0,0 +1,480 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_FLAT_HASH_MAP_HH__
+#define __BASE_FLAT_HASH_MAP_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace gem5
+{
+
+/**
+ * An unordered map that keeps its elements in a single array and resolves
+ * collisions by linear probing. Lookups touch consecutive memory instead
+ * of following the bucket lists of std::unordered_map, which makes it a
+ * better fit for large maps that are searched on every access, such as
+ * snoop filters and tag indices.
+ *
+ * The interface is a subset of the one of std::unordered_map, and so are
+ * the iterator guarantees: erasing an element never moves the other ones,
+ * and iterators, pointers and references are only invalidated by an
+ * insertion that rehashes the table. Rehashing happens when the table
+ * grows, and when erased slots have to be reclaimed. The table does not
+ * grow while it holds no more elements than were reserved.
+ *
+ * The hash is mixed before it is used, so identity hashes of aligned
+ * addresses spread well over the table.
+ *
+ * @tparam Key Type of the keys.
+ * @tparam T Type of the mapped values.
+ * @tparam Hash Hash function of the keys.
+ * @tparam KeyEqual Equality of the keys.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+  public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef std::size_t size_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+
+  private:
+    /** State of a slot of the table. */
+    enum SlotState : uint8_t
+    {
+        Empty,
+        Full,
+        /** An erased element that lookups have to probe past. */
+        Deleted
+    };
+
+    /** Smallest number of slots of a non-empty table. */
+    static constexpr size_type minCapacity = 16;
+
+    /**
+     * Position of the end iterator. It does not depend on the capacity,
+     * so end iterators stay valid when the table is rehashed.
+     */
+    static constexpr size_type endPos = ~size_type(0);
+
+    template <typename MapType, typename ValueType>
+    class Iterator
+    {
+      private:
+        MapType *map;
+        size_type pos;
+
+        friend class FlatHashMap;
+        template <typename, typename> friend class Iterator;
+
+        void
+        skipFree()
+        {
+            while (pos < map->_capacity && map->states[pos] != Full)
+                ++pos;
+            if (pos >= map->_capacity)
+                pos = endPos;
+        }
+
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef ValueType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef ValueType *pointer;
+        typedef ValueType &reference;
+
+        Iterator() : map(nullptr), pos(0) {}
+
+        Iterator(MapType *_map, size_type _pos) : map(_map), pos(_pos)
+        {
+            skipFree();
+        }
+
+        /** Conversion from iterator to const_iterator. */
+        template <typename OtherMap, typename OtherValue>
+        Iterator(const Iterator<OtherMap, OtherValue> &other)
+            : map(other.map), pos(other.pos)
+        {}
+
+        reference operator*() const { return map->slots[pos]; }
+        pointer operator->() const { return &map->slots[pos]; }
+
+        Iterator &
+        operator++()
+        {
+            ++pos;
+            skipFree();
+            return *this;
+        }
+
+        Iterator
+        operator++(int)
+        {
+            Iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        template <typename OtherMap, typename OtherValue>
+        bool
+        operator==(const Iterator<OtherMap, OtherValue> &other) const
+        {
+            return pos == other.pos;
+        }
+
+        template <typename OtherMap, typename OtherValue>
+        bool
+        operator!=(const Iterator<OtherMap, OtherValue> &other) const
+        {
+            return pos != other.pos;
+        }
+    };
+
+  public:
+    typedef Iterator<FlatHashMap, value_type> iterator;
+    typedef Iterator<const FlatHashMap, const value_type> const_iterator;
+
+  private:
+    /** The elements, only constructed in Full slots. */
+    value_type *slots = nullptr;
+    std::unique_ptr<SlotState[]> states;
+
+    size_type _capacity = 0;
+    size_type _size = 0;
+    size_type deleted = 0;
+
+    /** Shift that maps a mixed hash to a slot. */
+    unsigned shift = 64;
+
+    Hash hashFunc;
+    KeyEqual keyEqual;
+
+    size_type
+    home(const Key &key) const
+    {
+        // Fibonacci hashing: the top bits of the product depend on all
+        // the bits of the hash
+        return (uint64_t(hashFunc(key)) * 0x9e3779b97f4a7c15ULL) >> shift;
+    }
+
+    size_type
+    next(size_type pos) const
+    {
+        return (pos + 1) & (_capacity - 1);
+    }
+
+    /**
+     * Whether a table of the given capacity can hold n used slots,
+     * including the erased ones, before it has to be rehashed.
+     */
+    static bool
+    fits(size_type n, size_type capacity)
+    {
+        return n * 8 <= capacity * 7;
+    }
+
+    /** Position of the key in the table, or endPos if it is absent. */
+    size_type
+    lookup(const Key &key) const
+    {
+        if (!_size)
+            return endPos;
+        for (size_type pos = home(key); ; pos = next(pos)) {
+            if (states[pos] == Empty)
+                return endPos;
+            if (states[pos] == Full && keyEqual(slots[pos].first, key))
+                return pos;
+        }
+    }
+
+    /**
+     * Find the key, or the slot where it should be inserted, growing the
+     * table first if an insertion would overfill it.
+     *
+     * @return The position, and whether the key was found.
+     */
+    std::pair<size_type, bool>
+    lookupForInsert(const Key &key)
+    {
+        size_type pos = lookup(key);
+        if (pos != endPos)
+            return {pos, true};
+
+        if (!fits(_size + deleted + 1, _capacity)) {
+            // Drop the erased slots, and only grow if the table would be
+            // more than half full
+            size_type capacity = _capacity ? _capacity : minCapacity;
+            while (2 * (_size + 1) > capacity)
+                capacity *= 2;
+            rehash(capacity);
+        }
+
+        pos = home(key);
+        while (states[pos] == Full)
+            pos = next(pos);
+        return {pos, false};
+    }
+
+    void
+    rehash(size_type capacity)
+    {
+        assert((capacity & (capacity - 1)) == 0);
+        value_type *old_slots = slots;
+        std::unique_ptr<SlotState[]> old_states = std::move(states);
+        size_type old_capacity = _capacity;
+
+        slots = std::allocator<value_type>().allocate(capacity);
+        states.reset(new SlotState[capacity]());
+        _capacity = capacity;
+        deleted = 0;
+        shift = 64;
+        while (capacity >>= 1)
+            --shift;
+
+        for (size_type i = 0; i < old_capacity; ++i) {
+            if (old_states[i] != Full)
+                continue;
+            size_type pos = home(old_slots[i].first);
+            while (states[pos] == Full)
+                pos = next(pos);
+            ::new (&slots[pos]) value_type(std::move(old_slots[i]));
+            states[pos] = Full;
+            old_slots[i].~value_type();
+        }
+        if (old_slots)
+            std::allocator<value_type>().deallocate(old_slots, old_capacity);
+    }
+
+    void
+    destroy()
+    {
+        for (size_type i = 0; i < _capacity; ++i) {
+            if (states[i] == Full)
+                slots[i].~value_type();
+        }
+        if (slots)
+            std::allocator<value_type>().deallocate(slots, _capacity);
+        slots = nullptr;
+        states.reset();
+        _capacity = _size = deleted = 0;
+        shift = 64;
+    }
+
+    void
+    eraseAt(size_type pos)
+    {
+        slots[pos].~value_type();
+        // A slot followed by an empty one ends every probe sequence that
+        // reaches it, so it does not need to be kept as deleted
+        if (states[next(pos)] == Empty) {
+            states[pos] = Empty;
+        } else {
+            states[pos] = Deleted;
+            ++deleted;
+        }
+        --_size;
+    }
+
+  public:
+    FlatHashMap() = default;
+
+    FlatHashMap(const FlatHashMap &other)
+        : hashFunc(other.hashFunc), keyEqual(other.keyEqual)
+    {
+        reserve(other.size());
+        for (const auto &value : other)
+            emplace(value.first, value.second);
+    }
+
+    FlatHashMap(FlatHashMap &&other) noexcept
+        : slots(other.slots), states(std::move(other.states)),
+          _capacity(other._capacity), _size(other._size),
+          deleted(other.deleted), shift(other.shift),
+          hashFunc(std::move(other.hashFunc)),
+          keyEqual(std::move(other.keyEqual))
+    {
+        other.slots = nullptr;
+        other._capacity = other._size = other.deleted = 0;
+        other.shift = 64;
+    }
+
+    FlatHashMap &
+    operator=(FlatHashMap other) noexcept
+    {
+        std::swap(slots, other.slots);
+        std::swap(states, other.states);
+        std::swap(_capacity, other._capacity);
+        std::swap(_size, other._size);
+        std::swap(deleted, other.deleted);
+        std::swap(shift, other.shift);
+        std::swap(hashFunc, other.hashFunc);
+        std::swap(keyEqual, other.keyEqual);
+        return *this;
+    }
+
+    ~FlatHashMap() { destroy(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, endPos); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, endPos); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return _size == 0; }
+    size_type size() const { return _size; }
+
+    /** Number of slots of the table. */
+    size_type capacity() const { return _capacity; }
+
+    /**
+     * Make room for n elements, so that no insertion rehashes the table
+     * while there are at most n elements.
+     */
+    void
+    reserve(size_type n)
+    {
+        size_type capacity = minCapacity;
+        while (2 * n > capacity)
+            capacity *= 2;
+        if (capacity > _capacity)
+            rehash(capacity);
+    }
+
+    void
+    clear()
+    {
+        for (size_type i = 0; i < _capacity; ++i) {
+            if (states[i] == Full)
+                slots[i].~value_type();
+            states[i] = Empty;
+        }
+        _size = deleted = 0;
+    }
+
+    iterator find(const Key &key) { return iterator(this, lookup(key)); }
+
+    const_iterator
+    find(const Key &key) const
+    {
+        return const_iterator(this, lookup(key));
+    }
+
+    size_type count(const Key &key) const { return lookup(key) != endPos; }
+
+    template <typename... Args>
+    std::pair<iterator, bool>
+    try_emplace(const Key &key, Args&&... args)
+    {
+        auto [pos, found] = lookupForInsert(key);
+        if (!found) {
+            ::new (&slots[pos]) value_type(std::piecewise_construct,
+                    std::forward_as_tuple(key),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+            if (states[pos] == Deleted)
+                --deleted;
+            states[pos] = Full;
+            ++_size;
+        }
+        return {iterator(this, pos), !found};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool>
+    emplace(const Key &key, M &&obj)
+    {
+        return try_emplace(key, std::forward<M>(obj));
+    }
+
+    std::pair<iterator, bool>
+    insert(const value_type &value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    T &operator[](const Key &key) { return try_emplace(key).first->second; }
+
+    T &
+    at(const Key &key)
+    {
+        size_type pos = lookup(key);
+        if (pos == endPos)
+            throw std::out_of_range("FlatHashMap::at");
+        return slots[pos].second;
+    }
+
+    const T &
+    at(const Key &key) const
+    {
+        size_type pos = lookup(key);
+        if (pos == endPos)
+            throw std::out_of_range("FlatHashMap::at");
+        return slots[pos].second;
+    }
+
+    /**
+     * Erase an element. Only the erased element's iterators are
+     * invalidated.
+     *
+     * @return An iterator to the next element.
+     */
+    iterator
+    erase(const_iterator it)
+    {
+        assert(it.pos < _capacity && states[it.pos] == Full);
+        eraseAt(it.pos);
+        return iterator(this, it.pos + 1);
+    }
+
+    iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    size_type
+    erase(const Key &key)
+    {
+        size_type pos = lookup(key);
+        if (pos == endPos)
+            return 0;
+        eraseAt(pos);
+        return 1;
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_FLAT_HASH_MAP_HH__
@@ -0,0 +1,211 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "base/flat_hash_map.hh"
+
+using namespace gem5;
+
+TEST(FlatHashMapTest, Empty)
+{
+    FlatHashMap<uint64_t, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.begin(), map.end());
+    EXPECT_EQ(map.find(42), map.end());
+    EXPECT_EQ(map.count(42), 0);
+    EXPECT_EQ(map.erase(42), 0);
+}
+
+TEST(FlatHashMapTest, InsertFindErase)
+{
+    FlatHashMap<uint64_t, int> map;
+    auto [it, inserted] = map.emplace(0x1000, 1);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, 0x1000);
+    EXPECT_EQ(it->second, 1);
+
+    // Emplacing an existing key does not overwrite it
+    auto [it2, inserted2] = map.emplace(0x1000, 2);
+    EXPECT_FALSE(inserted2);
+    EXPECT_EQ(it2, it);
+    EXPECT_EQ(it2->second, 1);
+
+    map[0x2000] = 3;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.at(0x2000), 3);
+    EXPECT_EQ(map.find(0x1000)->second, 1);
+    EXPECT_THROW(map.at(0x3000), std::out_of_range);
+
+    EXPECT_EQ(map.erase(0x1000), 1);
+    EXPECT_EQ(map.find(0x1000), map.end());
+    EXPECT_EQ(map.size(), 1);
+
+    map.erase(map.find(0x2000));
+    EXPECT_TRUE(map.empty());
+}
+
+/** Random operations give the same results as a reference map. */
+TEST(FlatHashMapTest, MatchesReference)
+{
+    FlatHashMap<uint64_t, uint64_t> map;
+    std::map<uint64_t, uint64_t> ref;
+    std::mt19937_64 rng(1);
+
+    for (int i = 0; i < 200000; ++i) {
+        // Cache line aligned addresses from a small range, so that keys
+        // are often found and erased
+        uint64_t key = (rng() % 4096) * 64;
+        switch (rng() % 3) {
+          case 0:
+            map[key] = i;
+            ref[key] = i;
+            break;
+          case 1:
+            EXPECT_EQ(map.erase(key), ref.erase(key));
+            break;
+          case 2: {
+            auto it = map.find(key);
+            auto ref_it = ref.find(key);
+            ASSERT_EQ(it == map.end(), ref_it == ref.end());
+            if (it != map.end()) {
+                EXPECT_EQ(it->second, ref_it->second);
+            }
+            break;
+          }
+        }
+        ASSERT_EQ(map.size(), ref.size());
+    }
+
+    std::map<uint64_t, uint64_t> contents(map.begin(), map.end());
+    EXPECT_EQ(contents, ref);
+}
+
+/** Erasing an element does not move the other ones. */
+TEST(FlatHashMapTest, StableOnErase)
+{
+    FlatHashMap<uint64_t, int> map;
+    for (int i = 0; i < 1000; ++i)
+        map[i * 64] = i;
+
+    std::map<uint64_t, int *> addresses;
+    for (auto &value : map)
+        addresses[value.first] = &value.second;
+
+    for (int i = 0; i < 1000; i += 2)
+        map.erase(i * 64);
+
+    for (int i = 1; i < 1000; i += 2) {
+        auto it = map.find(i * 64);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(&it->second, addresses[i * 64]);
+    }
+}
+
+/** Insertions within the reserved capacity do not rehash. */
+TEST(FlatHashMapTest, StableWithinReserve)
+{
+    FlatHashMap<uint64_t, int> map;
+    map.reserve(1000);
+    auto capacity = map.capacity();
+
+    auto first = map.emplace(0, 0).first;
+    for (int i = 1; i < 1000; ++i)
+        map[i] = i;
+
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_EQ(first, map.find(0));
+
+    // Erasing and inserting different keys does not grow the table
+    for (int i = 0; i < 100000; ++i) {
+        map.erase(i);
+        map[i + 1000] = i;
+    }
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_EQ(map.capacity(), capacity);
+}
+
+/** End iterators stay valid when the table grows. */
+TEST(FlatHashMapTest, StableEnd)
+{
+    FlatHashMap<uint64_t, int> map;
+    auto end = map.end();
+    for (int i = 0; i < 1000; ++i)
+        map[i] = i;
+    EXPECT_EQ(end, map.end());
+    EXPECT_EQ(map.find(1000), end);
+}
+
+TEST(FlatHashMapTest, EraseWhileIterating)
+{
+    FlatHashMap<uint64_t, int> map;
+    for (int i = 0; i < 100; ++i)
+        map[i] = i;
+
+    for (auto it = map.begin(); it != map.end(); ) {
+        if (it->second % 3)
+            it = map.erase(it);
+        else
+            ++it;
+    }
+
+    EXPECT_EQ(map.size(), 34);
+    for (const auto &value : map)
+        EXPECT_EQ(value.second % 3, 0);
+}
+
+TEST(FlatHashMapTest, NonTrivialValues)
+{
+    auto tracker = std::make_shared<int>(0);
+    {
+        FlatHashMap<std::string, std::shared_ptr<int>> map;
+        for (int i = 0; i < 100; ++i)
+            map[std::to_string(i)] = tracker;
+        EXPECT_EQ(tracker.use_count(), 101);
+
+        map.erase("5");
+        EXPECT_EQ(tracker.use_count(), 100);
+
+        FlatHashMap<std::string, std::shared_ptr<int>> copy(map);
+        EXPECT_EQ(tracker.use_count(), 199);
+        EXPECT_EQ(copy.size(), 99);
+
+        FlatHashMap<std::string, std::shared_ptr<int>> moved(
+                std::move(copy));
+        EXPECT_EQ(tracker.use_count(), 199);
+        EXPECT_TRUE(copy.empty());
+
+        map.clear();
+        EXPECT_EQ(tracker.use_count(), 100);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
@@ -0,0 +1,168 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_POOL_ALLOCATOR_HH__
+#define __BASE_POOL_ALLOCATOR_HH__
+
+#include <cstddef>
+#include <new>
+
+namespace gem5
+{
+
+/**
+ * A free list of fixed-size memory blocks for objects that are allocated
+ * and freed at a high rate, such as packets and requests.
+ *
+ * Each thread has its own free list, so no locking is needed. Blocks are
+ * carved out of larger chunks, and a block freed by a thread other than
+ * the one that allocated it simply joins the free list of the freeing
+ * thread. Chunks are never returned to the system: the pool only grows up
+ * to the peak number of live blocks.
+ *
+ * @tparam Size Size of a block in bytes.
+ * @tparam Align Alignment of a block in bytes.
+ */
+template <std::size_t Size, std::size_t Align = alignof(std::max_align_t)>
+class FixedSizePool
+{
+  private:
+    struct Node
+    {
+        Node *next;
+    };
+
+    static constexpr std::size_t blockAlign =
+        Align > alignof(Node) ? Align : alignof(Node);
+
+    static constexpr std::size_t blockSize =
+        ((Size > sizeof(Node) ? Size : sizeof(Node)) + blockAlign - 1) /
+        blockAlign * blockAlign;
+
+    /** Number of blocks allocated from the system at a time. */
+    static constexpr std::size_t blocksPerChunk = 256;
+
+    static Node *&
+    freeList()
+    {
+        static thread_local Node *head = nullptr;
+        return head;
+    }
+
+    static void
+    refill()
+    {
+        char *chunk = static_cast<char *>(::operator new(
+                    blockSize * blocksPerChunk, std::align_val_t(blockAlign)));
+
+        Node *&head = freeList();
+        for (std::size_t i = blocksPerChunk; i > 0; --i) {
+            Node *node = reinterpret_cast<Node *>(
+                    chunk + (i - 1) * blockSize);
+            node->next = head;
+            head = node;
+        }
+    }
+
+  public:
+    /** Get a block of (at least) Size bytes. */
+    static void *
+    allocate()
+    {
+        Node *&head = freeList();
+        if (!head)
+            refill();
+
+        Node *node = head;
+        head = node->next;
+        return node;
+    }
+
+    /** Return a block obtained with allocate() to the pool. */
+    static void
+    deallocate(void *p)
+    {
+        Node *node = static_cast<Node *>(p);
+        Node *&head = freeList();
+        node->next = head;
+        head = node;
+    }
+};
+
+/**
+ * A standard allocator that takes single objects from a FixedSizePool,
+ * e.g. to keep a pooled shared_ptr control block with
+ * std::allocate_shared. Arrays are allocated with operator new.
+ */
+template <typename T>
+class PoolAllocator
+{
+  private:
+    typedef FixedSizePool<sizeof(T), alignof(T)> Pool;
+
+  public:
+    typedef T value_type;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        if (n == 1)
+            return static_cast<T *>(Pool::allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T),
+                                               std::align_val_t(alignof(T))));
+    }
+
+    void
+    deallocate(T *p, std::size_t n)
+    {
+        if (n == 1)
+            Pool::deallocate(p);
+        else
+            ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+};
+
+template <typename T, typename U>
+bool
+operator==(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool
+operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return false;
+}
+
+} // namespace gem5
+
+#endif // __BASE_POOL_ALLOCATOR_HH__
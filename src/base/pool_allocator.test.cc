@@ -0,0 +1,116 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "base/pool_allocator.hh"
+
+using namespace gem5;
+
+/** Blocks are distinct, aligned and do not overlap. */
+TEST(FixedSizePoolTest, DistinctAlignedBlocks)
+{
+    typedef FixedSizePool<24, 16> Pool;
+
+    std::set<uintptr_t> blocks;
+    for (int i = 0; i < 1000; ++i) {
+        auto p = reinterpret_cast<uintptr_t>(Pool::allocate());
+        EXPECT_EQ(p % 16, 0);
+        blocks.insert(p);
+    }
+    ASSERT_EQ(blocks.size(), 1000);
+
+    uintptr_t last = 0;
+    for (auto p : blocks) {
+        if (last) {
+            EXPECT_GE(p - last, 24);
+        }
+        last = p;
+    }
+
+    for (auto p : blocks)
+        Pool::deallocate(reinterpret_cast<void *>(p));
+}
+
+/** A freed block is handed out again before new memory is used. */
+TEST(FixedSizePoolTest, ReusesFreedBlocks)
+{
+    typedef FixedSizePool<64> Pool;
+
+    void *a = Pool::allocate();
+    void *b = Pool::allocate();
+    Pool::deallocate(a);
+    EXPECT_EQ(Pool::allocate(), a);
+    Pool::deallocate(b);
+    Pool::deallocate(a);
+}
+
+/** Blocks may be freed by another thread than the one that allocated. */
+TEST(FixedSizePoolTest, CrossThreadFree)
+{
+    typedef FixedSizePool<32> Pool;
+
+    std::vector<void *> blocks;
+    for (int i = 0; i < 300; ++i)
+        blocks.push_back(Pool::allocate());
+
+    std::thread t([&blocks]() {
+        for (void *p : blocks)
+            Pool::deallocate(p);
+        // The freed blocks are reused by this thread
+        EXPECT_EQ(Pool::allocate(), blocks.back());
+    });
+    t.join();
+}
+
+/** The allocator can back a shared_ptr and its control block. */
+TEST(PoolAllocatorTest, AllocateShared)
+{
+    struct Object
+    {
+        int &count;
+        explicit Object(int &count) : count(count) { ++count; }
+        ~Object() { --count; }
+    };
+
+    int count = 0;
+    {
+        auto p = std::allocate_shared<Object>(PoolAllocator<Object>(),
+                                              count);
+        auto q = p;
+        EXPECT_EQ(count, 1);
+        EXPECT_EQ(p.use_count(), 2);
+    }
+    EXPECT_EQ(count, 0);
+
+    std::vector<int, PoolAllocator<int>> v(10, 3);
+    EXPECT_EQ(v[9], 3);
+}
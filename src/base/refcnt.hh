@@ -210,6 +210,13 @@ class RefCountingPtr
     template <bool B = TisConst>
     RefCountingPtr(const NonConstT &r) { copy(r.data); }
 
+    /// Create a pointer to a base class of the object another pointer
+    /// refers to.  Adds a reference.
+    template <class U, typename std::enable_if_t<
+        std::is_convertible_v<U *, T *> &&
+        !std::is_same_v<std::remove_cv_t<U>, std::remove_cv_t<T>>, int> = 0>
+    RefCountingPtr(const RefCountingPtr<U> &r) { copy(r.get()); }
+
     /// Destroy the pointer and any reference it may hold.
     ~RefCountingPtr() { del(); }
 
@@ -70,6 +70,11 @@ class TestRC : public RefCounted
 };
 typedef RefCountingPtr<TestRC> Ptr;
 
+class DerivedTestRC : public TestRC
+{
+};
+typedef RefCountingPtr<DerivedTestRC> DerivedPtr;
+
 } // anonymous namespace
 
 TEST(RefcntTest, NullPointerCheck)
@@ -172,3 +177,17 @@ TEST(RefcntTest, EqualityOperators)
     EXPECT_TRUE(equalTestAPtr != equalTestB);
     EXPECT_TRUE(equalTestAPtr != equalTestBPtr);
 }
+
+TEST(RefcntTest, ConversionToBasePointer)
+{
+    // A pointer to a derived class converts to a pointer to its base,
+    // and both hold a reference.
+    DerivedPtr derived = new DerivedTestRC();
+    Ptr base = derived;
+    EXPECT_EQ(base.get(), derived.get());
+    EXPECT_EQ(1, liveListSize());
+    derived = NULL;
+    EXPECT_EQ(1, liveListSize());
+    base = NULL;
+    EXPECT_EQ(0, liveListSize());
+}
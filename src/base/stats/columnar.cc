@@ -0,0 +1,358 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/columnar.hh"
+
+#include <zlib.h>
+
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+namespace
+{
+
+std::string
+subname(const std::vector<std::string> &subnames, size_t i)
+{
+    return i < subnames.size() && !subnames[i].empty() ?
+        subnames[i] : std::to_string(i);
+}
+
+std::string
+subdesc(const std::vector<std::string> &subdescs, size_t i)
+{
+    return i < subdescs.size() ? subdescs[i] : std::string();
+}
+
+template <typename T>
+void
+put(std::vector<uint8_t> &buf, const T &value)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&value);
+    buf.insert(buf.end(), p, p + sizeof(value));
+}
+
+void
+putString(std::vector<uint8_t> &buf, const std::string &str)
+{
+    put(buf, uint32_t(str.size()));
+    buf.insert(buf.end(), str.begin(), str.end());
+}
+
+/** Columns of a distribution, before its buckets. */
+const char *const distColumns[] = {
+    "samples", "sum", "squares", "min_value", "max_value", "underflows",
+    "overflows", "bucket_min", "bucket_size"
+};
+const size_t numDistColumns = sizeof(distColumns) / sizeof(distColumns[0]);
+
+} // anonymous namespace
+
+Columnar::Columnar(const std::string &file, bool desc, bool formulas,
+                   bool delta, bool compress)
+    : fname(file), enableDescriptions(desc), enableFormula(formulas),
+      enableDelta(delta), enableCompression(compress),
+      stream(file, std::ios::binary | std::ios::trunc),
+      statPos(0), schemaChanged(false), schemaWritten(false)
+{
+    fatal_if(!stream, "Unable to open statistics file %s for writing\n",
+             file);
+
+    const uint32_t reserved = 0;
+    stream.write(Magic, sizeof(Magic));
+    stream.write(reinterpret_cast<const char *>(&Version), sizeof(Version));
+    stream.write(reinterpret_cast<const char *>(&reserved),
+                 sizeof(reserved));
+}
+
+void
+Columnar::begin()
+{
+    path.clear();
+    statPos = 0;
+    schemaChanged = false;
+    values.clear();
+}
+
+void
+Columnar::end()
+{
+    // Stats that were not visited this time have been removed
+    if (statPos != schema.size()) {
+        schema.resize(statPos);
+        schemaChanged = true;
+    }
+
+    if (schemaChanged || !schemaWritten)
+        writeSchema();
+    writeValues();
+    stream.flush();
+}
+
+bool
+Columnar::valid() const
+{
+    return stream.good();
+}
+
+void
+Columnar::beginGroup(const char *name)
+{
+    path.push_back(path.empty() ? name : path.back() + "." + name);
+}
+
+void
+Columnar::endGroup()
+{
+    assert(!path.empty());
+    path.pop_back();
+}
+
+bool
+Columnar::matchSchema(const Info &info, size_t count)
+{
+    if (!schemaChanged && statPos < schema.size() &&
+            schema[statPos].id == info.id && schema[statPos].count == count) {
+        ++statPos;
+        return false;
+    }
+
+    // From here on, the names of all the columns are generated again
+    schemaChanged = true;
+    schema.resize(statPos);
+    schema.push_back({info.id, count, {}, {}});
+    ++statPos;
+    return true;
+}
+
+void
+Columnar::addColumn(const Info &info, const std::string &suffix,
+                    const std::string &desc)
+{
+    StatColumns &stat = schema.back();
+    std::string name = path.empty() ? info.name :
+        path.back() + "." + info.name;
+    stat.names.push_back(name + suffix);
+    if (enableDescriptions)
+        stat.descs.push_back(desc.empty() ? info.desc : desc);
+    else
+        stat.descs.emplace_back();
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    if (matchSchema(info, 1))
+        addColumn(info, "");
+    values.push_back(info.result());
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const VResult &vr = info.result();
+    if (matchSchema(info, vr.size())) {
+        for (size_t i = 0; i < vr.size(); ++i) {
+            addColumn(info, "::" + subname(info.subnames, i),
+                      subdesc(info.subdescs, i));
+        }
+    }
+    values.insert(values.end(), vr.begin(), vr.end());
+}
+
+void
+Columnar::addDistColumns(const Info &info, const std::string &prefix,
+                         const DistData &data)
+{
+    for (auto column : distColumns)
+        addColumn(info, prefix + "::" + column);
+    for (size_t i = 0; i < data.cvec.size(); ++i)
+        addColumn(info, prefix + "::bucket_" + std::to_string(i));
+}
+
+void
+Columnar::appendDist(const DistData &data)
+{
+    values.insert(values.end(), {
+        data.samples, data.sum, data.squares, data.min_val, data.max_val,
+        data.underflow, data.overflow, data.min, data.bucket_size });
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    if (matchSchema(info, numDistColumns + info.data.cvec.size()))
+        addDistColumns(info, "", info.data);
+    appendDist(info.data);
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    size_t count = 0;
+    for (const auto &data : info.data)
+        count += numDistColumns + data.cvec.size();
+
+    if (matchSchema(info, count)) {
+        for (size_t i = 0; i < info.data.size(); ++i) {
+            addDistColumns(info, "::" + subname(info.subnames, i),
+                           info.data[i]);
+        }
+    }
+    for (const auto &data : info.data)
+        appendDist(data);
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    if (matchSchema(info, info.cvec.size())) {
+        for (size_t x = 0; x < info.x; ++x) {
+            for (size_t y = 0; y < info.y; ++y) {
+                addColumn(info, "::" + subname(info.subnames, x) + "::" +
+                          subname(info.y_subnames, y));
+            }
+        }
+    }
+    values.insert(values.end(), info.cvec.begin(), info.cvec.end());
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    if (enableFormula)
+        visit(static_cast<const VectorInfo &>(info));
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    warn_once("Columnar stat files don't support sparse histograms.\n");
+}
+
+void
+Columnar::writeRecord(RecordType type, uint32_t flags,
+                      const std::vector<uint8_t> &payload)
+{
+    const uint32_t header[2] = { type, flags };
+    const uint64_t size = payload.size();
+    stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    stream.write(reinterpret_cast<const char *>(payload.data()),
+                 payload.size());
+}
+
+void
+Columnar::writeSchema()
+{
+    std::vector<uint8_t> payload;
+    put(payload, uint32_t(values.size()));
+    for (const auto &stat : schema) {
+        assert(stat.names.size() == stat.count);
+        for (size_t i = 0; i < stat.count; ++i) {
+            putString(payload, stat.names[i]);
+            putString(payload, stat.descs[i]);
+        }
+    }
+    writeRecord(SchemaRecord, 0, payload);
+
+    schemaWritten = true;
+    // The previous values do not match the new columns
+    lastValues.clear();
+}
+
+void
+Columnar::writeValues()
+{
+    uint32_t flags = 0;
+    std::vector<uint64_t> bits(values.size());
+    std::memcpy(bits.data(), values.data(), values.size() * sizeof(double));
+
+    if (enableDelta && lastValues.size() == values.size()) {
+        flags |= Delta;
+        for (size_t i = 0; i < bits.size(); ++i) {
+            uint64_t last;
+            std::memcpy(&last, &lastValues[i], sizeof(last));
+            bits[i] ^= last;
+        }
+    }
+
+    const uint8_t *raw = reinterpret_cast<const uint8_t *>(bits.data());
+    const uint64_t raw_size = bits.size() * sizeof(uint64_t);
+    std::vector<uint8_t> payload;
+    if (enableCompression) {
+        uLongf size = compressBound(raw_size);
+        payload.resize(sizeof(raw_size) + size);
+        std::memcpy(payload.data(), &raw_size, sizeof(raw_size));
+        if (compress2(payload.data() + sizeof(raw_size), &size, raw,
+                      raw_size, Z_BEST_SPEED) == Z_OK) {
+            flags |= Compressed;
+            payload.resize(sizeof(raw_size) + size);
+        } else {
+            payload.assign(raw, raw + raw_size);
+        }
+    } else {
+        payload.assign(raw, raw + raw_size);
+    }
+    writeRecord(ValuesRecord, flags, payload);
+
+    lastValues.swap(values);
+}
+
+std::unique_ptr<Output>
+initColumnar(const std::string &filename, bool desc, bool formulas,
+             bool delta, bool compress)
+{
+    return std::unique_ptr<Output>(new Columnar(
+        simout.resolve(filename), desc, formulas, delta, compress));
+}
+
+} // namespace statistics
+} // namespace gem5
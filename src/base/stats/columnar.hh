@@ -0,0 +1,170 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+class Info;
+struct DistData;
+
+/**
+ * Binary, columnar stat output for frequent periodic dumps.
+ *
+ * Every stat is flattened into one or more columns of doubles. The names
+ * of the columns are written once, in a schema record, and each dump then
+ * only writes a record with the vector of values. A new schema record is
+ * written if the set of stats changes between dumps. Values can be
+ * delta-encoded, by XORing their bits with the ones of the previous dump
+ * so that unchanged stats become zeros, and compressed with zlib.
+ *
+ * File layout, in host byte order:
+ *   header:  char magic[8] = "gem5col", uint32_t version, uint32_t 0
+ *   record:  uint32_t type, uint32_t flags, uint64_t size, payload[size]
+ *   schema:  uint32_t columns, then for each column a uint32_t length
+ *            and the name, and a uint32_t length and the description
+ *   values:  if compressed, uint64_t size before compression, then the
+ *            zlib stream of the values; otherwise double values[columns]
+ *
+ * util/columnar_stats.py reads these files.
+ */
+class Columnar : public Output
+{
+  public:
+    static constexpr char Magic[8] = {'g', 'e', 'm', '5', 'c', 'o', 'l', 0};
+    static constexpr uint32_t Version = 1;
+
+    enum RecordType : uint32_t
+    {
+        SchemaRecord = 1,
+        ValuesRecord = 2
+    };
+
+    enum RecordFlags : uint32_t
+    {
+        /** Values are XORed with the values of the previous dump. */
+        Delta = 0x1,
+        /** The payload is compressed with zlib. */
+        Compressed = 0x2
+    };
+
+    Columnar(const std::string &file, bool desc, bool formulas, bool delta,
+             bool compress);
+
+    Columnar() = delete;
+    Columnar(const Columnar &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** The columns of a stat, in the order the stats are visited. */
+    struct StatColumns
+    {
+        int id;
+        size_t count;
+        std::vector<std::string> names;
+        std::vector<std::string> descs;
+    };
+
+    /**
+     * Check that the next stat in the schema has the expected columns.
+     * If it does not, the schema has changed and the names of the
+     * columns are generated again.
+     *
+     * @return Whether the names need to be added to the schema.
+     */
+    bool matchSchema(const Info &info, size_t count);
+
+    /** Add a column of the current stat to a changed schema. */
+    void addColumn(const Info &info, const std::string &suffix,
+                   const std::string &desc = "");
+
+    void addDistColumns(const Info &info, const std::string &prefix,
+                        const DistData &data);
+    void appendDist(const DistData &data);
+
+    void writeRecord(RecordType type, uint32_t flags,
+                     const std::vector<uint8_t> &payload);
+    void writeSchema();
+    void writeValues();
+
+  protected:
+    const std::string fname;
+    const bool enableDescriptions;
+    const bool enableFormula;
+    const bool enableDelta;
+    const bool enableCompression;
+
+    std::ofstream stream;
+
+    /** Dotted path of the current group. */
+    std::vector<std::string> path;
+
+    std::vector<StatColumns> schema;
+    /** Position of the next stat in the schema during a dump. */
+    size_t statPos;
+    bool schemaChanged;
+    bool schemaWritten;
+
+    std::vector<double> values;
+    std::vector<double> lastValues;
+};
+
+std::unique_ptr<Output> initColumnar(const std::string &filename,
+                                     bool desc = true, bool formulas = true,
+                                     bool delta = true, bool compress = true);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_COLUMNAR_HH__
@@ -0,0 +1,261 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "base/stats/columnar.hh"
+#include "base/stats/info.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class TestScalarInfo : public statistics::ScalarInfo
+{
+  public:
+    double val = 0;
+
+    TestScalarInfo(const std::string &name)
+    {
+        setName(name, false);
+        flags.set(statistics::display);
+    }
+
+    statistics::Counter value() const override { return val; }
+    statistics::Result result() const override { return val; }
+    statistics::Result total() const override { return val; }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override { val = 0; }
+    bool zero() const override { return val == 0; }
+    void visit(statistics::Output &visitor) override
+    {
+        visitor.visit(*this);
+    }
+};
+
+class TestVectorInfo : public statistics::VectorInfo
+{
+  public:
+    statistics::VCounter vals;
+    mutable statistics::VResult results;
+
+    TestVectorInfo(const std::string &name, size_t size) : vals(size)
+    {
+        setName(name, false);
+        flags.set(statistics::display);
+    }
+
+    statistics::size_type size() const override { return vals.size(); }
+    const statistics::VCounter &value() const override { return vals; }
+
+    const statistics::VResult &
+    result() const override
+    {
+        results.assign(vals.begin(), vals.end());
+        return results;
+    }
+
+    statistics::Result total() const override { return 0; }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return false; }
+    void visit(statistics::Output &visitor) override
+    {
+        visitor.visit(*this);
+    }
+};
+
+/** The contents of a columnar stat file. */
+struct Contents
+{
+    std::vector<std::vector<std::string>> schemas;
+    /** Schema index and values of each dump. */
+    std::vector<std::pair<size_t, std::vector<double>>> dumps;
+    std::vector<uint32_t> flags;
+};
+
+template <typename T>
+T
+get(const std::vector<uint8_t> &buf, size_t &pos)
+{
+    T value;
+    std::memcpy(&value, buf.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return value;
+}
+
+Contents
+readFile(const std::string &file)
+{
+    std::ifstream is(file, std::ios::binary);
+    std::vector<uint8_t> buf((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+    Contents contents;
+    EXPECT_EQ(std::memcmp(buf.data(), statistics::Columnar::Magic, 8), 0);
+
+    size_t pos = 16;
+    std::vector<double> last;
+    while (pos < buf.size()) {
+        auto type = get<uint32_t>(buf, pos);
+        auto flags = get<uint32_t>(buf, pos);
+        auto size = get<uint64_t>(buf, pos);
+        std::vector<uint8_t> payload(buf.begin() + pos,
+                                     buf.begin() + pos + size);
+        pos += size;
+
+        size_t p = 0;
+        if (type == statistics::Columnar::SchemaRecord) {
+            contents.schemas.emplace_back();
+            auto count = get<uint32_t>(payload, p);
+            for (uint32_t i = 0; i < count; ++i) {
+                auto len = get<uint32_t>(payload, p);
+                contents.schemas.back().emplace_back(
+                        payload.begin() + p, payload.begin() + p + len);
+                p += len;
+                p += get<uint32_t>(payload, p);
+            }
+            continue;
+        }
+
+        if (flags & statistics::Columnar::Compressed) {
+            uLongf raw_size = get<uint64_t>(payload, p);
+            std::vector<uint8_t> raw(raw_size);
+            EXPECT_EQ(uncompress(raw.data(), &raw_size, payload.data() + p,
+                                 payload.size() - p), Z_OK);
+            payload = raw;
+        }
+        std::vector<double> values(payload.size() / sizeof(double));
+        std::memcpy(values.data(), payload.data(), payload.size());
+        if (flags & statistics::Columnar::Delta) {
+            for (size_t i = 0; i < values.size(); ++i) {
+                uint64_t a, b;
+                std::memcpy(&a, &values[i], 8);
+                std::memcpy(&b, &last[i], 8);
+                a ^= b;
+                std::memcpy(&values[i], &a, 8);
+            }
+        }
+        last = values;
+        contents.dumps.emplace_back(contents.schemas.size() - 1, values);
+        contents.flags.push_back(flags);
+    }
+    return contents;
+}
+
+void
+dump(statistics::Output &out, std::vector<statistics::Info *> stats)
+{
+    out.begin();
+    out.beginGroup("system");
+    for (auto stat : stats)
+        stat->visit(out);
+    out.endGroup();
+    out.end();
+}
+
+} // anonymous namespace
+
+class StatsColumnarTest : public testing::TestWithParam<std::pair<bool, bool>>
+{
+  protected:
+    std::string file;
+
+    void
+    SetUp() override
+    {
+        char name[] = "/tmp/columnar.test.XXXXXX";
+        int fd = mkstemp(name);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        file = name;
+    }
+
+    void TearDown() override { std::remove(file.c_str()); }
+};
+
+/** Values read back match the dumped ones, and the schema is only
+ * written when the stats change. */
+TEST_P(StatsColumnarTest, RoundTrip)
+{
+    auto [delta, compress] = GetParam();
+
+    TestScalarInfo cycles("cycles");
+    TestVectorInfo hits("hits", 2);
+    hits.subnames = {"read", ""};
+    TestScalarInfo late("late");
+
+    {
+        statistics::Columnar out(file, true, true, delta, compress);
+        for (int i = 0; i < 3; ++i) {
+            cycles.val = 1000 * i;
+            hits.vals = {double(i), 7};
+            dump(out, {&cycles, &hits});
+        }
+        late.val = 3.5;
+        dump(out, {&cycles, &hits, &late});
+    }
+
+    Contents contents = readFile(file);
+    ASSERT_EQ(contents.schemas.size(), 2);
+    EXPECT_EQ(contents.schemas[0], (std::vector<std::string>{
+        "system.cycles", "system.hits::read", "system.hits::1"}));
+    EXPECT_EQ(contents.schemas[1].size(), 4);
+    EXPECT_EQ(contents.schemas[1][3], "system.late");
+
+    ASSERT_EQ(contents.dumps.size(), 4);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(contents.dumps[i].first, 0);
+        EXPECT_EQ(contents.dumps[i].second,
+                  (std::vector<double>{1000. * i, double(i), 7}));
+    }
+    EXPECT_EQ(contents.dumps[3].first, 1);
+    EXPECT_EQ(contents.dumps[3].second,
+              (std::vector<double>{2000, 2, 7, 3.5}));
+
+    // Only dumps following one with the same schema are delta-encoded
+    EXPECT_FALSE(contents.flags[0] & statistics::Columnar::Delta);
+    EXPECT_EQ(bool(contents.flags[1] & statistics::Columnar::Delta), delta);
+    EXPECT_FALSE(contents.flags[3] & statistics::Columnar::Delta);
+}
+
+INSTANTIATE_TEST_SUITE_P(Encodings, StatsColumnarTest,
+                         testing::Values(std::make_pair(false, false),
+                                         std::make_pair(true, false),
+                                         std::make_pair(false, true),
+                                         std::make_pair(true, true)));
@@ -145,6 +145,21 @@ Logger::dump(Tick when, const std::string &name,
     }
 }
 
+void
+Logger::logDeferred(Tick when, const std::string &name,
+        const std::string &flag, const char *fmt,
+        const LogArg *args, size_t num_args)
+{
+    std::ostringstream line;
+    {
+        cp::Print print(line, fmt);
+        for (size_t i = 0; i < num_args; ++i)
+            args[i].addTo(print);
+        print.endArgs();
+    }
+    logMessage(when, name, flag, line.str());
+}
+
 void
 OstreamLogger::logMessage(Tick when, const std::string &name,
         const std::string &flag, const std::string &message)
@@ -170,5 +185,115 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     }
 }
 
+BinaryLogger::BinaryLogger(std::ostream &stream_)
+    : stream(stream_), nextId(1), textBuf(*this), textStream(&textBuf)
+{
+    deferFormatting = true;
+
+    stream.write(Magic, sizeof(Magic));
+    stream.write(reinterpret_cast<const char *>(&Version), sizeof(Version));
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    textStream.flush();
+    stream.flush();
+}
+
+uint32_t
+BinaryLogger::stringId(const std::string &str)
+{
+    if (str.empty())
+        return 0;
+
+    auto it = stringIds.find(str);
+    if (it != stringIds.end())
+        return it->second;
+
+    uint32_t id = nextId++;
+    stringIds.emplace(str, id);
+    writeString(id, str.data(), str.size());
+    return id;
+}
+
+uint32_t
+BinaryLogger::formatId(const char *fmt)
+{
+    auto &entry = formatIds[fmt];
+    if (entry.first == 0 || entry.second != fmt) {
+        entry.first = nextId++;
+        entry.second = fmt;
+        writeString(entry.first, fmt, entry.second.size());
+    }
+    return entry.first;
+}
+
+void
+BinaryLogger::writeString(uint32_t id, const char *str, size_t len)
+{
+    record.clear();
+    put(StringRecord);
+    put(id);
+    put(uint32_t(len));
+    record.append(str, len);
+    stream.write(record.data(), record.size());
+}
+
+void
+BinaryLogger::logMessage(Tick when, const std::string &name,
+        const std::string &flag, const std::string &message)
+{
+    LogArg arg(message);
+    logDeferred(when, name, flag, "%s", &arg, 1);
+}
+
+void
+BinaryLogger::logDeferred(Tick when, const std::string &name,
+        const std::string &flag, const char *fmt,
+        const LogArg *args, size_t num_args)
+{
+    panic_if(num_args > UINT8_MAX, "Too many arguments to a debug message");
+
+    // The IDs may emit string records, so get them first
+    uint32_t name_id = stringId(name);
+    uint32_t flag_id = stringId(flag);
+    uint32_t fmt_id = formatId(fmt);
+
+    record.clear();
+    put(MessageRecord);
+    put(uint64_t(when));
+    put(name_id);
+    put(flag_id);
+    put(fmt_id);
+    put(uint8_t(num_args));
+    for (size_t i = 0; i < num_args; ++i) {
+        const LogArg &arg = args[i];
+        put(arg.type);
+        put(arg.size);
+        if (arg.type != LogArg::String)
+            put(arg.u);
+        if (arg.hasText()) {
+            put(uint32_t(arg.str.size()));
+            record.append(arg.str);
+        }
+    }
+    stream.write(record.data(), record.size());
+}
+
+int
+BinaryLogger::TextBuf::sync()
+{
+    std::string text = str();
+    size_t start = 0;
+    size_t end;
+    while ((end = text.find('\n', start)) != std::string::npos) {
+        logger.logMessage(MaxTick, "", "",
+                          text.substr(start, end - start + 1));
+        start = end + 1;
+    }
+    str(text.substr(start));
+    return 0;
+}
+
 } // namespace Trace
 } // namespace gem5
@@ -32,9 +32,14 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <ostream>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <unordered_map>
 
 #include "base/compiler.hh"
 #include "base/cprintf.hh"
@@ -53,6 +58,219 @@ namespace gem5
 
 namespace Trace {
 
+/**
+ * An argument of a debug message that is recorded rather than formatted
+ * (see Logger::logDeferred). Arithmetic values and pointers keep their
+ * exact type so that they format exactly as the original argument would;
+ * strings are copied, and any other type is rendered with operator<<.
+ *
+ * Enums and classes that convert implicitly to an integer, like Cycles or
+ * Flags, are recorded as that integer so that integer conversions such as
+ * %x still apply to them. Their operator<< text, if any, is kept as well
+ * and used for %s. The one difference to direct formatting is a type whose
+ * operator<< prints something other than its value, which %d and %x print
+ * as the value.
+ */
+class LogArg
+{
+  public:
+    enum Type : uint8_t
+    {
+        Signed,
+        Unsigned,
+        Bool,
+        Char,
+        Floating,
+        Pointer,
+        String,
+        /** Integers with the operator<< text of the original type. */
+        SignedText,
+        UnsignedText
+    };
+
+    Type type;
+    /** Size in bytes of the original integer type. */
+    uint8_t size;
+    union
+    {
+        int64_t s;
+        uint64_t u;
+        double d;
+    };
+    std::string str;
+
+  private:
+    /** The integer type of +arg, or void if there is none. */
+    template <typename T, typename = void>
+    struct Promoted { using type = void; };
+
+    template <typename T>
+    struct Promoted<T, std::void_t<decltype(+std::declval<const T &>())>>
+    {
+        using type = decltype(+std::declval<const T &>());
+    };
+
+    template <typename T, typename = void>
+    struct Streamable : std::false_type {};
+
+    template <typename T>
+    struct Streamable<T, std::void_t<decltype(
+            std::declval<std::ostream &>() << std::declval<const T &>())>>
+        : std::true_type {};
+
+    template <typename I, typename T>
+    void
+    setInteger(I value, const T &arg)
+    {
+        static_assert(std::is_integral_v<I>);
+        size = sizeof(I);
+        if constexpr (std::is_signed_v<I>) {
+            type = SignedText;
+            s = value;
+        } else {
+            type = UnsignedText;
+            u = value;
+        }
+        if constexpr (Streamable<T>::value) {
+            std::ostringstream os;
+            os << arg;
+            str = os.str();
+        }
+    }
+
+    /** Call f with the recorded integer, in its original type. */
+    template <typename F>
+    void
+    visitInteger(F f) const
+    {
+        if (type == Signed || type == SignedText) {
+            switch (size) {
+              case 1: f((int8_t)s); break;
+              case 2: f((int16_t)s); break;
+              case 4: f((int32_t)s); break;
+              default: f((int64_t)s); break;
+            }
+        } else {
+            switch (size) {
+              case 1: f((uint8_t)u); break;
+              case 2: f((uint16_t)u); break;
+              case 4: f((uint32_t)u); break;
+              default: f((uint64_t)u); break;
+            }
+        }
+    }
+
+  public:
+    /**
+     * An integer with text, which cprintf formats as the text in %s
+     * conversions and as the integer otherwise.
+     */
+    struct IntegerText { const LogArg &arg; };
+
+    LogArg() : type(Unsigned), size(sizeof(uint64_t)), u(0) {}
+
+    /** Whether str is part of the recorded value. */
+    bool
+    hasText() const
+    {
+        return type == String || type == SignedText || type == UnsignedText;
+    }
+
+    template <typename T>
+    explicit LogArg(const T &arg) : size(0), u(0)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            type = Bool;
+            u = arg;
+        } else if constexpr (std::is_same_v<T, char>) {
+            type = Char;
+            s = arg;
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            type = Signed;
+            size = sizeof(T);
+            s = arg;
+        } else if constexpr (std::is_integral_v<T>) {
+            type = Unsigned;
+            size = sizeof(T);
+            u = arg;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            type = Floating;
+            d = arg;
+        } else if constexpr (std::is_enum_v<T>) {
+            setInteger(static_cast<std::underlying_type_t<T>>(arg), arg);
+        } else if constexpr (std::is_convertible_v<T, const char *>) {
+            type = String;
+            const char *c = arg;
+            str = c ? c : "(null)";
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            type = String;
+            str = arg;
+        } else if constexpr (std::is_pointer_v<T>) {
+            type = Pointer;
+            u = reinterpret_cast<uintptr_t>(arg);
+        } else if constexpr (std::is_class_v<T> &&
+                std::is_integral_v<typename Promoted<T>::type>) {
+            setInteger(+arg, arg);
+        } else {
+            type = String;
+            std::ostringstream os;
+            os << arg;
+            str = os.str();
+        }
+    }
+
+    /** Format this argument as the next one of a cprintf. */
+    void
+    addTo(cp::Print &print) const
+    {
+        switch (type) {
+          case Signed:
+          case Unsigned:
+            visitInteger([&print](auto v) { print.addArg(v); });
+            break;
+          case SignedText:
+          case UnsignedText:
+            print.addArg(IntegerText{*this});
+            break;
+          case Bool: print.addArg((bool)u); break;
+          case Char: print.addArg((char)s); break;
+          case Floating: print.addArg(d); break;
+          case Pointer: print.addArg((const void *)(uintptr_t)u); break;
+          default: print.addArg(str); break;
+        }
+    }
+
+    /** @{ */
+    /** cprintf conversions of an IntegerText, found by ADL. */
+    friend void
+    formatChar(std::ostream &out, const IntegerText &i, cp::Format &fmt)
+    {
+        i.arg.visitInteger([&](auto v) { cp::formatChar(out, v, fmt); });
+    }
+
+    friend void
+    formatInteger(std::ostream &out, const IntegerText &i, cp::Format &fmt)
+    {
+        i.arg.visitInteger([&](auto v) { cp::formatInteger(out, v, fmt); });
+    }
+
+    friend void
+    formatFloat(std::ostream &out, const IntegerText &i, cp::Format &fmt)
+    {
+        i.arg.visitInteger([&](auto v) { cp::formatFloat(out, v, fmt); });
+    }
+
+    friend void
+    formatString(std::ostream &out, const IntegerText &i, cp::Format &fmt)
+    {
+        if (i.arg.str.empty())
+            formatInteger(out, i, fmt);
+        else
+            cp::formatString(out, i.arg.str, fmt);
+    }
+    /** @} */
+};
+
 /** Debug logging base class.  Handles formatting and outputting
  *  time/name/message messages */
 class Logger
@@ -61,6 +279,12 @@ class Logger
     /** Name match for objects to ignore */
     ObjectMatch ignore;
 
+    /**
+     * Pass messages to logDeferred() with their raw arguments instead of
+     * formatting them first.
+     */
+    bool deferFormatting = false;
+
   public:
     /** Log a single message */
     template <typename ...Args>
@@ -78,6 +302,14 @@ class Logger
     {
         if (!name.empty() && ignore.match(name))
             return;
+        if (deferFormatting) {
+            const std::array<LogArg, sizeof...(Args)> log_args{{
+                LogArg(args)...
+            }};
+            logDeferred(when, name, flag, fmt, log_args.data(),
+                        log_args.size());
+            return;
+        }
         std::ostringstream line;
         ccprintf(line, fmt, args...);
         logMessage(when, name, flag, line.str());
@@ -91,6 +323,12 @@ class Logger
     virtual void logMessage(Tick when, const std::string &name,
             const std::string &flag, const std::string &message) = 0;
 
+    /** Log a message that has not been formatted. By default, format it
+     *  and pass it to logMessage */
+    virtual void logDeferred(Tick when, const std::string &name,
+            const std::string &flag, const char *fmt,
+            const LogArg *args, size_t num_args);
+
     /** Return an ostream that can be used to send messages to
      *  the 'same place' as formatted logMessage messages.  This
      *  can be implemented to use a logger's underlying ostream,
@@ -124,6 +362,93 @@ class OstreamLogger : public Logger
     std::ostream &getOstream() override { return stream; }
 };
 
+/**
+ * Logging to a compact binary stream. Messages are not formatted: each
+ * one records the tick, the IDs of the object name, the flag and the
+ * format string, and the raw arguments. Names, flags and format strings
+ * are written out once, when they are first used. The tracedecode tool
+ * (base/tracedecode.cc) renders the stream as text, in the same format
+ * as OstreamLogger.
+ *
+ * The stream starts with the 8 byte magic and a 32 bit version, followed
+ * by records in host byte order:
+ *  - String: the type, a 32 bit ID, a 32 bit length and the characters.
+ *  - Message: the type, the 64 bit tick, the 32 bit name, flag and
+ *    format IDs, an 8 bit argument count, and for each argument its
+ *    LogArg type, its size, its value (64 bits, except for strings) and,
+ *    for strings and integers with text, a 32 bit length and the
+ *    characters.
+ * ID 0 is the empty string.
+ */
+class BinaryLogger : public Logger
+{
+  public:
+    static constexpr char Magic[8] = {'g', 'e', 'm', '5', 'd', 'b', 'g', 0};
+    static constexpr uint32_t Version = 2;
+
+    enum RecordType : uint8_t
+    {
+        StringRecord = 1,
+        MessageRecord = 2
+    };
+
+  protected:
+    std::ostream &stream;
+
+    /** IDs of the names and flags seen so far. */
+    std::unordered_map<std::string, uint32_t> stringIds;
+
+    /** IDs of the format strings seen so far, by address. The contents
+     *  are kept to detect a different string at a reused address. */
+    std::unordered_map<const char *, std::pair<uint32_t, std::string>>
+        formatIds;
+
+    uint32_t nextId;
+
+    /** Buffer to assemble a record, kept to avoid allocations. */
+    std::string record;
+
+    /** Text written with getOstream(), logged a line at a time. */
+    class TextBuf : public std::stringbuf
+    {
+      private:
+        BinaryLogger &logger;
+
+      protected:
+        int sync() override;
+
+      public:
+        TextBuf(BinaryLogger &logger) : logger(logger) {}
+    };
+
+    TextBuf textBuf;
+    std::ostream textStream;
+
+    uint32_t stringId(const std::string &str);
+    uint32_t formatId(const char *fmt);
+    void writeString(uint32_t id, const char *str, size_t len);
+
+    template <typename T>
+    void
+    put(const T &value)
+    {
+        record.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+  public:
+    BinaryLogger(std::ostream &stream_);
+    ~BinaryLogger();
+
+    void logMessage(Tick when, const std::string &name,
+            const std::string &flag, const std::string &message) override;
+
+    void logDeferred(Tick when, const std::string &name,
+            const std::string &flag, const char *fmt,
+            const LogArg *args, size_t num_args) override;
+
+    std::ostream &getOstream() override { return textStream; }
+};
+
 /** Get the current global debug logger.  This takes ownership of the given
  *  logger which should be allocated using 'new' */
 Logger *getDebugLogger();
@@ -32,6 +32,7 @@
 #include <string>
 
 #include "base/gtest/cur_tick_fake.hh"
+#include "base/flags.hh"
 #include "base/gtest/logging.hh"
 #include "base/named.hh"
 #include "base/trace.hh"
@@ -608,3 +609,103 @@ TEST(TraceTest, GlobalName)
     DPRINTF(TraceTestDebugFlag, "Test message");
     ASSERT_EQ(getString(Trace::output()), "");
 }
+
+/** A text logger that formats messages only after recording them. */
+class DeferredOstreamLogger : public Trace::OstreamLogger
+{
+  public:
+    DeferredOstreamLogger(std::ostream &stream_)
+        : Trace::OstreamLogger(stream_)
+    {
+        deferFormatting = true;
+    }
+};
+
+/** A type that is formatted with operator<<. */
+struct TracePrintable
+{
+    int value;
+};
+
+std::ostream &
+operator<<(std::ostream &os, const TracePrintable &p)
+{
+    return os << "<" << p.value << ">";
+}
+
+/** An unscoped enum, which formats as an integer. */
+enum TraceEnum { TraceEnumValue = 255 };
+
+/** A scoped enum that is formatted with operator<<. */
+enum class TraceColor : int8_t { Red = -2 };
+
+std::ostream &
+operator<<(std::ostream &os, TraceColor c)
+{
+    return os << "red";
+}
+
+/** Test that recorded arguments format like the original ones. */
+TEST(TraceTest, DeferredFormatting)
+{
+    const char *fmt = "%d %x %#x %c %s %s %s %.3f %c %d %s %*d\n";
+    const std::string str("string");
+    const TracePrintable obj{7};
+
+    std::stringstream direct_ss, deferred_ss;
+    Trace::OstreamLogger direct(direct_ss);
+    DeferredOstreamLogger deferred(deferred_ss);
+
+    direct.dprintf_flag(Tick(1), "Foo", "Bar", fmt, -5, int8_t(-1),
+        uint16_t(0xabc), 'q', true, "literal", str, 3.14159, 'c',
+        uint8_t(200), obj, 6, 42);
+    deferred.dprintf_flag(Tick(1), "Foo", "Bar", fmt, -5, int8_t(-1),
+        uint16_t(0xabc), 'q', true, "literal", str, 3.14159, 'c',
+        uint8_t(200), obj, 6, 42);
+
+    ASSERT_EQ(getString(&deferred), getString(&direct));
+
+    // Enums and classes that convert to integers keep integer conversions
+    const char *int_fmt = "%d %x %#x %s %s %#x %d %s %#06x %s\n";
+    const Cycles cycles(0xbeef);
+    const Flags<uint32_t> flags(0x81);
+
+    direct.dprintf_flag(Tick(2), "Foo", "Bar", int_fmt, TraceEnumValue,
+        TraceEnumValue, TraceEnumValue, TraceEnumValue, TraceColor::Red,
+        cycles, cycles, cycles, flags, flags);
+    deferred.dprintf_flag(Tick(2), "Foo", "Bar", int_fmt, TraceEnumValue,
+        TraceEnumValue, TraceEnumValue, TraceEnumValue, TraceColor::Red,
+        cycles, cycles, cycles, flags, flags);
+
+    const std::string direct_str = getString(&direct);
+    ASSERT_EQ(getString(&deferred), direct_str);
+    ASSERT_NE(direct_str.find("255 ff 0xff 255 red 0xbeef 48879 48879 "
+        "0x0081 129"), std::string::npos);
+}
+
+/** Test that the binary logger writes each string only once. */
+TEST(TraceTest, BinaryLoggerStrings)
+{
+    std::stringstream ss;
+    Trace::BinaryLogger logger(ss);
+
+    logger.dprintf_flag(Tick(100), "Foo", "Bar", "Format %d\n", 1);
+    logger.dprintf_flag(Tick(200), "Foo", "Bar", "Format %d\n", 2);
+    logger.getOstream().flush();
+
+    const std::string out = ss.str();
+    ASSERT_EQ(out.compare(0, sizeof(Trace::BinaryLogger::Magic),
+        Trace::BinaryLogger::Magic, sizeof(Trace::BinaryLogger::Magic)), 0);
+
+    auto count = [&out](const std::string &str) {
+        size_t n = 0;
+        for (size_t pos = out.find(str); pos != std::string::npos;
+             pos = out.find(str, pos + 1)) {
+            ++n;
+        }
+        return n;
+    };
+    EXPECT_EQ(count("Foo"), 1);
+    EXPECT_EQ(count("Bar"), 1);
+    EXPECT_EQ(count("Format %d\n"), 1);
+}
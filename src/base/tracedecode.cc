@@ -0,0 +1,197 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Render the binary debug output of Trace::BinaryLogger (gem5 run with
+ * --debug-binary) as text, in the same format as the default text output.
+ *
+ * Usage: tracedecode [-f] [-t] [-F FLAG[,FLAG]] <file>
+ *   -f  print the flag of each message (like the FmtFlag debug flag)
+ *   -t  do not print ticks (like the FmtTicksOff debug flag)
+ *   -F  only print messages with one of the given flags
+ */
+
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/trace.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+template <typename T>
+bool
+get(std::istream &is, T &value)
+{
+    return bool(is.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+bool
+getString(std::istream &is, std::string &str)
+{
+    uint32_t len;
+    if (!get(is, len))
+        return false;
+    str.resize(len);
+    return len == 0 || bool(is.read(&str[0], len));
+}
+
+void
+usage(const char *prog)
+{
+    std::cerr << "Usage: " << prog << " [-f] [-t] [-F FLAG[,FLAG]] <file>"
+              << std::endl;
+    exit(1);
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char *argv[])
+{
+    bool print_flags = false;
+    bool print_ticks = true;
+    std::set<std::string> only_flags;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "ftF:")) != -1) {
+        switch (opt) {
+          case 'f':
+            print_flags = true;
+            break;
+          case 't':
+            print_ticks = false;
+            break;
+          case 'F': {
+            std::istringstream flags(optarg);
+            std::string flag;
+            while (std::getline(flags, flag, ','))
+                only_flags.insert(flag);
+            break;
+          }
+          default:
+            usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1)
+        usage(argv[0]);
+
+    std::ifstream is(argv[optind], std::ios::binary);
+    if (!is) {
+        std::cerr << "Cannot open " << argv[optind] << std::endl;
+        return 1;
+    }
+
+    char magic[sizeof(Trace::BinaryLogger::Magic)];
+    uint32_t version;
+    if (!is.read(magic, sizeof(magic)) ||
+            memcmp(magic, Trace::BinaryLogger::Magic, sizeof(magic)) ||
+            !get(is, version)) {
+        std::cerr << argv[optind] << " is not a binary debug trace"
+                  << std::endl;
+        return 1;
+    }
+    if (version != Trace::BinaryLogger::Version) {
+        std::cerr << "Unsupported trace version " << version << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<uint32_t, std::string> strings;
+    strings[0] = "";
+
+    std::vector<Trace::LogArg> args;
+    bool truncated = false;
+    uint8_t type;
+    while (get(is, type)) {
+        if (type == Trace::BinaryLogger::StringRecord) {
+            uint32_t id;
+            if (!get(is, id) || !getString(is, strings[id])) {
+                truncated = true;
+                break;
+            }
+            continue;
+        } else if (type != Trace::BinaryLogger::MessageRecord) {
+            std::cerr << "Corrupt record in trace" << std::endl;
+            return 1;
+        }
+
+        uint64_t when;
+        uint32_t name_id, flag_id, fmt_id;
+        uint8_t num_args;
+        if (!get(is, when) || !get(is, name_id) || !get(is, flag_id) ||
+                !get(is, fmt_id) || !get(is, num_args)) {
+            truncated = true;
+            break;
+        }
+
+        args.resize(num_args);
+        bool complete = true;
+        for (auto &arg : args) {
+            complete = get(is, arg.type) && get(is, arg.size) &&
+                (arg.type == Trace::LogArg::String || get(is, arg.u)) &&
+                (!arg.hasText() || getString(is, arg.str));
+            if (!complete)
+                break;
+        }
+        if (!complete) {
+            truncated = true;
+            break;
+        }
+
+        const std::string &flag = strings[flag_id];
+        if (!only_flags.empty() && !only_flags.count(flag))
+            continue;
+
+        if (print_ticks && when != MaxTick)
+            ccprintf(std::cout, "%7d: ", when);
+        if (print_flags && !flag.empty())
+            std::cout << flag << ": ";
+        const std::string &name = strings[name_id];
+        if (!name.empty())
+            std::cout << name << ": ";
+
+        cp::Print print(std::cout, strings[fmt_id]);
+        for (const auto &arg : args)
+            arg.addTo(print);
+        print.endArgs();
+    }
+
+    if (truncated) {
+        std::cerr << "Truncated trace" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -60,6 +60,9 @@ class BaseAtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    decoded_block_cache = Param.Bool(False, "Execute cached decoded basic "
+        "blocks without fetching them, to speed up fast-forwarding. Only "
+        "writes seen by this CPU or snooped invalidate the cache.")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
@@ -89,6 +89,17 @@ AtomicSimpleCPU::AtomicSimpleCPU(const BaseAtomicSimpleCPUParams &p)
     data_read_req = std::make_shared<Request>();
     data_write_req = std::make_shared<Request>();
     data_amo_req = std::make_shared<Request>();
+
+    if (p.decoded_block_cache) {
+        fatal_if(numThreads > 1, "%s: The decoded block cache only supports "
+                 "a single thread\n", name());
+        fatal_if(simulate_inst_stalls, "%s: The decoded block cache does "
+                 "not fetch instructions, so it cannot simulate icache "
+                 "stalls\n", name());
+        fatal_if(branchPred, "%s: The decoded block cache cannot be used "
+                 "with a branch predictor\n", name());
+        blockCache = std::make_unique<DecodedBlockCache>(this);
+    }
 }
 
 
@@ -149,6 +160,11 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Memory may have changed while drained, e.g., by restoring a
+    // checkpoint
+    if (blockCache)
+        blockCache->flush();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -205,6 +221,9 @@ AtomicSimpleCPU::takeOverFrom(BaseCPU *old_cpu)
 {
     BaseSimpleCPU::takeOverFrom(old_cpu);
 
+    if (blockCache)
+        blockCache->flush();
+
     // The tick event should have been descheduled by drain()
     assert(!tickEvent.scheduled());
 }
@@ -297,6 +316,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
     if (pkt->isInvalidate() || pkt->isWrite()) {
         DPRINTF(SimpleCPU, "received invalidation for addr:%#x\n",
                 pkt->getAddr());
+        cpu->checkCodeWrite(pkt->getAddr());
         for (auto &t_info : cpu->threadInfo) {
             t_info->thread->getIsaPtr()->handleLockedSnoop(pkt,
                     cacheBlockMask);
@@ -320,6 +340,9 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
         }
     }
 
+    if (pkt->isWrite())
+        cpu->checkCodeWrite(pkt->getAddr());
+
     // if snoop invalidates, release any associated locks
     if (pkt->isInvalidate()) {
         DPRINTF(SimpleCPU, "received invalidation for addr:%#x\n",
@@ -498,6 +521,7 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
             if (do_access && !req->getFlags().isSet(Request::NO_ACCESS)) {
                 Packet pkt(req, Packet::makeWriteCmd(req));
                 pkt.dataStatic(data);
+                checkCodeWrite(req->getPaddr());
 
                 if (req->isLocalAccess()) {
                     dcache_latency +=
@@ -589,6 +613,7 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
         // data will hold the return data of the AMO access
         Packet pkt(req, Packet::makeWriteCmd(req));
         pkt.dataStatic(data);
+        checkCodeWrite(req->getPaddr());
 
         if (req->isLocalAccess()) {
             dcache_latency += req->localAccessor(thread->getTC(), &pkt);
@@ -656,6 +681,20 @@ AtomicSimpleCPU::tick()
         const PCStateBase &pc = thread->pcState();
 
         bool needToFetch = !isRomMicroPC(pc.microPC()) && !curMacroStaticInst;
+
+        // Instructions of cached blocks are neither fetched nor decoded.
+        // Otherwise, remember where the instruction is decoded to add it
+        // to the block being recorded.
+        bool cached = false;
+        std::unique_ptr<PCStateBase> fetch_pc;
+        if (needToFetch && blockCache && t_info.fetchOffset == 0) {
+            cached = preExecuteCached();
+            if (cached)
+                needToFetch = false;
+            else
+                fetch_pc.reset(pc.clone());
+        }
+
         if (needToFetch) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
@@ -681,7 +720,19 @@ AtomicSimpleCPU::tick()
                 //}
             }
 
-            preExecute();
+            if (!cached)
+                preExecute();
+
+            if (fetch_pc) {
+                if (curStaticInst && !t_info.stayAtPC &&
+                        !curMacroStaticInst) {
+                    blockCache->record(*fetch_pc, thread->pcState(),
+                                       curStaticInst,
+                                       ifetch_req->getPaddr());
+                } else {
+                    blockCache->endBlock();
+                }
+            }
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
@@ -727,6 +778,15 @@ AtomicSimpleCPU::tick()
             }
 
         }
+
+        // Faults, system calls and serializing instructions may change
+        // the code or its translation
+        if (blockCache && (fault != NoFault || (curStaticInst &&
+                (curStaticInst->isSyscall() ||
+                 curStaticInst->isSerializing())))) {
+            blockCache->flush();
+        }
+
         if (fault != NoFault || !t_info.stayAtPC)
             advancePC(fault);
     }
@@ -760,6 +820,32 @@ AtomicSimpleCPU::fetchInstMem()
     return latency;
 }
 
+bool
+AtomicSimpleCPU::preExecuteCached()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread *thread = t_info.thread;
+
+    const DecodedBlockCache::Entry *entry =
+        blockCache->lookup(thread->pcState());
+    if (!entry)
+        return false;
+
+    // Do what preExecute does for an instruction decoded from memory
+    t_info.setPredicate(true);
+    t_info.setMemAccPredicate(true);
+    t_info.stayAtPC = false;
+    thread->pcState(*entry->decodedPC);
+    curStaticInst = entry->inst;
+
+#if TRACING_ON
+    traceData = tracer->getInstRecord(curTick(), thread->getTC(),
+            curStaticInst, thread->pcState(), curMacroStaticInst);
+#endif // TRACING_ON
+
+    return true;
+}
+
 void
 AtomicSimpleCPU::regProbePoints()
 {
@@ -41,7 +41,10 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <memory>
+
 #include "cpu/simple/base.hh"
+#include "cpu/simple/block_cache.hh"
 #include "cpu/simple/exec_context.hh"
 #include "mem/request.hh"
 #include "params/BaseAtomicSimpleCPU.hh"
@@ -67,9 +70,28 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
 
+    /** Decoded basic blocks, if enabled. */
+    std::unique_ptr<DecodedBlockCache> blockCache;
+
     // main simulation loop (one cycle)
     void tick();
 
+    /**
+     * Take the instruction at the current PC from the block cache
+     * instead of fetching and decoding it.
+     *
+     * @return Whether the instruction was cached.
+     */
+    bool preExecuteCached();
+
+    /** Flush the block cache if a write to an address may change code. */
+    void
+    checkCodeWrite(Addr paddr)
+    {
+        if (blockCache && blockCache->isCode(paddr))
+            blockCache->flush();
+    }
+
     /**
      * Check if a system is in a drained state.
      *
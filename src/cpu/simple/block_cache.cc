@@ -0,0 +1,107 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/block_cache.hh"
+
+#include "base/trace.hh"
+#include "debug/SimpleCPU.hh"
+
+namespace gem5
+{
+
+DecodedBlockCache::CacheStats::CacheStats(statistics::Group *parent)
+    : statistics::Group(parent, "blockCache"),
+      ADD_STAT(hits, statistics::units::Count::get(),
+               "Number of instructions taken from cached blocks"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of instructions fetched and decoded from memory"),
+      ADD_STAT(flushes, statistics::units::Count::get(),
+               "Number of times all cached blocks were dropped")
+{
+}
+
+DecodedBlockCache::DecodedBlockCache(statistics::Group *parent)
+    : stats(parent)
+{
+}
+
+const DecodedBlockCache::Entry *
+DecodedBlockCache::lookup(const PCStateBase &pc)
+{
+    if (current && currentPos < current->size() &&
+            *(*current)[currentPos].pc == pc) {
+        stats.hits++;
+        return &(*current)[currentPos++];
+    }
+
+    current = nullptr;
+    auto it = blocks.find(pc.instAddr());
+    if (it != blocks.end() && &it->second != recording &&
+            *it->second.front().pc == pc) {
+        // Following a cached block, so there is nothing to record
+        recording = nullptr;
+        current = &it->second;
+        currentPos = 1;
+        stats.hits++;
+        return &current->front();
+    }
+
+    stats.misses++;
+    return nullptr;
+}
+
+void
+DecodedBlockCache::record(const PCStateBase &pc,
+                          const PCStateBase &decoded_pc,
+                          const StaticInstPtr &inst, Addr paddr)
+{
+    if (!recording) {
+        recording = &blocks[pc.instAddr()];
+        recording->clear();
+    }
+
+    recording->push_back({inst, std::unique_ptr<PCStateBase>(pc.clone()),
+                          std::unique_ptr<PCStateBase>(decoded_pc.clone())});
+    codePages.insert(paddr >> codePageShift);
+
+    if (inst->isControl() || recording->size() >= maxBlockSize)
+        recording = nullptr;
+}
+
+void
+DecodedBlockCache::flush()
+{
+    if (blocks.empty())
+        return;
+
+    DPRINTF(SimpleCPU, "Flushing %d decoded blocks\n", blocks.size());
+    blocks.clear();
+    codePages.clear();
+    current = nullptr;
+    recording = nullptr;
+    stats.flushes++;
+}
+
+} // namespace gem5
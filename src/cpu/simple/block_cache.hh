@@ -0,0 +1,139 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_BLOCK_CACHE_HH__
+#define __CPU_SIMPLE_BLOCK_CACHE_HH__
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "arch/generic/pcstate.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/static_inst.hh"
+
+namespace gem5
+{
+
+/**
+ * A cache of decoded basic blocks for fast-forwarding with the atomic
+ * CPU. It maps the address of the first instruction of a block to the
+ * instructions decoded when the block was last executed, along with the
+ * PC state before and after each of them was decoded. While execution
+ * follows a cached block, the CPU can take each instruction from the
+ * block instead of translating the fetch address, reading instruction
+ * memory and decoding.
+ *
+ * Blocks are recorded as they are executed, and end at control
+ * instructions. The cache holds no copy of the instruction memory, so it
+ * has to be flushed whenever the code or its translation may have
+ * changed: on writes to a page that blocks were fetched from, and on
+ * faults, system calls and serializing instructions.
+ */
+class DecodedBlockCache
+{
+  public:
+    struct Entry
+    {
+        StaticInstPtr inst;
+        /** The PC state the instruction was decoded at. */
+        std::unique_ptr<PCStateBase> pc;
+        /** The PC state after the instruction was decoded. */
+        std::unique_ptr<PCStateBase> decodedPC;
+    };
+
+    /** Maximum number of instructions in a block. */
+    static constexpr size_t maxBlockSize = 64;
+
+    /** Granularity at which writes to code are detected. */
+    static constexpr unsigned codePageShift = 12;
+
+  private:
+    typedef std::vector<Entry> Block;
+
+    std::unordered_map<Addr, Block> blocks;
+
+    /** Physical pages that instructions of cached blocks come from. */
+    std::unordered_set<Addr> codePages;
+
+    /** The block being followed, and the position in it. */
+    const Block *current = nullptr;
+    size_t currentPos = 0;
+
+    /** The block being recorded. */
+    Block *recording = nullptr;
+
+    struct CacheStats : public statistics::Group
+    {
+        CacheStats(statistics::Group *parent);
+
+        statistics::Scalar hits;
+        statistics::Scalar misses;
+        statistics::Scalar flushes;
+    } stats;
+
+  public:
+    DecodedBlockCache(statistics::Group *parent);
+
+    /**
+     * Find the decoded instruction at a PC state, either the next one of
+     * the block being followed, or the first one of a cached block.
+     *
+     * @return The entry, or nullptr on a miss.
+     */
+    const Entry *lookup(const PCStateBase &pc);
+
+    /**
+     * Add an instruction decoded from memory to the block being recorded,
+     * starting a block at this PC if none is.
+     *
+     * @param pc The PC state the instruction was decoded at.
+     * @param decoded_pc The PC state after decoding.
+     * @param inst The decoded instruction.
+     * @param paddr Physical address the instruction was fetched from.
+     */
+    void record(const PCStateBase &pc, const PCStateBase &decoded_pc,
+                const StaticInstPtr &inst, Addr paddr);
+
+    /** Stop recording, if the next instruction cannot be cached. */
+    void endBlock() { recording = nullptr; }
+
+    /** Whether a physical address is in a page that code is cached from. */
+    bool
+    isCode(Addr paddr) const
+    {
+        return !codePages.empty() &&
+            codePages.count(paddr >> codePageShift);
+    }
+
+    /** Drop all the blocks. */
+    void flush();
+};
+
+} // namespace gem5
+
+#endif // __CPU_SIMPLE_BLOCK_CACHE_HH__
@@ -0,0 +1,58 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+
+from m5.objects.ClockedObject import ClockedObject
+
+class TraceReplayer(ClockedObject):
+    type = 'TraceReplayer'
+    cxx_header = "cpu/testers/trace_replayer/trace_replayer.hh"
+    cxx_class = 'gem5::TraceReplayer'
+
+    # Packet trace recorded by a CommMonitor or a MemTraceProbe. Traces
+    # that are not compressed are memory mapped, which is much faster.
+    trace_file = Param.String("Packet trace to replay")
+
+    # Keep the recorded gaps between requests, or issue a request per
+    # cycle as fast as the limits below allow
+    honor_timing = Param.Bool(True, "Keep the recorded request timing")
+
+    # Limits on the outstanding requests, 0 means unlimited. The
+    # requestors are the requestor ids recorded in the trace.
+    max_outstanding = Param.Unsigned(0, "Maximum outstanding requests")
+    max_outstanding_per_requestor = Param.Unsigned(0,
+        "Maximum outstanding requests of each recorded requestor")
+
+    # A request is not issued while an earlier request to the same
+    # block, at most this many requests before it in the trace, is
+    # outstanding. 0 disables the check.
+    dependency_window = Param.Unsigned(0,
+        "Window, in requests, of the same-block dependency check")
+
+    exit_when_done = Param.Bool(True,
+        "Exit the simulation loop when the whole trace is replayed")
+
+    port = RequestPort("Port to the memory system")
+    system = Param.System(Parent.any, "System this replayer is part of")
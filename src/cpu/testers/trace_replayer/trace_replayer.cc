@@ -0,0 +1,392 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/trace_replayer/trace_replayer.hh"
+
+#include <algorithm>
+
+#include "base/cast.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/TraceReplayer.hh"
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+#include "sim/stats.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+bool
+TraceReplayer::ReplayPort::recvTimingResp(PacketPtr pkt)
+{
+    replayer.completeRequest(pkt);
+    return true;
+}
+
+void
+TraceReplayer::ReplayPort::recvReqRetry()
+{
+    replayer.recvRetry();
+}
+
+TraceReplayer::TraceReplayer(const Params &p)
+    : ClockedObject(p),
+      issueEvent([this]{ issue(); }, name()),
+      port("port", *this),
+      traceFile(p.trace_file),
+      requestorId(p.system->getRequestorId(this)),
+      honorTiming(p.honor_timing),
+      maxOutstanding(p.max_outstanding),
+      maxOutstandingPerRequestor(p.max_outstanding_per_requestor),
+      dependencyWindow(p.dependency_window),
+      exitWhenDone(p.exit_when_done),
+      blockAddrMask(p.system->cacheLineSize() - 1),
+      hasNextElement(false), nextSeqNum(0),
+      retryPkt(nullptr), retryStart(0), tickOffset(0),
+      waitResponse(false), waitStart(0), numOutstanding(0),
+      stats(this)
+{
+    // Uncompressed traces are parsed in place, compressed ones have to
+    // go through the decompressing stream
+    if (ProtoMappedInputStream::isMappable(traceFile)) {
+        mappedStream.reset(new ProtoMappedInputStream(traceFile));
+    } else {
+        stream.reset(new ProtoInputStream(traceFile));
+    }
+
+    ProtoMessage::PacketHeader header;
+    fatal_if(!readMessage(header), "%s: failed to read the header of %s",
+             name(), traceFile);
+    fatal_if(header.tick_freq() != sim_clock::Frequency,
+             "%s: trace %s was recorded with tick frequency %d, but the "
+             "current tick frequency is %d", name(), traceFile,
+             header.tick_freq(), sim_clock::Frequency);
+
+    // The requestor ids must all be allocated before the stats are
+    // registered
+    for (const auto &id_string : header.id_strings()) {
+        requestorIds[id_string.key()] =
+            p.system->getRequestorId(this, id_string.value());
+    }
+
+    hasNextElement = readNextElement();
+}
+
+TraceReplayer::~TraceReplayer()
+{
+}
+
+Port &
+TraceReplayer::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "port")
+        return port;
+    else
+        return ClockedObject::getPort(if_name, idx);
+}
+
+void
+TraceReplayer::startup()
+{
+    hostStart = std::chrono::steady_clock::now();
+
+    if (hasNextElement) {
+        // Shift the trace so that its first request is issued now
+        tickOffset = curTick() - nextElement.tick;
+        schedule(issueEvent, curTick());
+    } else {
+        checkDone();
+    }
+}
+
+bool
+TraceReplayer::readMessage(google::protobuf::Message &msg)
+{
+    return mappedStream ? mappedStream->read(msg) : stream->read(msg);
+}
+
+bool
+TraceReplayer::readNextElement()
+{
+    ProtoMessage::Packet pkt_msg;
+    while (readMessage(pkt_msg)) {
+        const MemCmd cmd = pkt_msg.cmd();
+
+        // The trace may have been recorded below a cache, in which case
+        // it contains writebacks and evictions. Writebacks are replayed
+        // as writes, messages without data are dropped.
+        if (cmd.isRead()) {
+            nextElement.cmd = MemCmd::ReadReq;
+        } else if (cmd.isWrite()) {
+            nextElement.cmd = MemCmd::WriteReq;
+        } else {
+            DPRINTF(TraceReplayer, "Skipping %s to %#x\n", cmd.toString(),
+                    pkt_msg.addr());
+            stats.numSkipped++;
+            continue;
+        }
+
+        nextElement.tick = pkt_msg.tick();
+        nextElement.addr = pkt_msg.addr();
+        nextElement.size = pkt_msg.size();
+        nextElement.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+        nextElement.requestor = pkt_msg.has_pkt_id() ? pkt_msg.pkt_id() : 0;
+        return true;
+    }
+
+    return false;
+}
+
+bool
+TraceReplayer::canIssue() const
+{
+    if (maxOutstanding && numOutstanding >= maxOutstanding)
+        return false;
+
+    if (maxOutstandingPerRequestor) {
+        auto it = outstandingPerRequestor.find(nextElement.requestor);
+        if (it != outstandingPerRequestor.end() &&
+            it->second >= maxOutstandingPerRequestor) {
+            return false;
+        }
+    }
+
+    if (dependencyWindow) {
+        auto it = outstandingBlocks.find(nextElement.addr & ~blockAddrMask);
+        if (it != outstandingBlocks.end()) {
+            for (auto seq_num : it->second) {
+                if (nextSeqNum - seq_num <= dependencyWindow)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void
+TraceReplayer::issue()
+{
+    assert(!retryPkt);
+
+    while (hasNextElement) {
+        if (honorTiming && nextElement.tick + tickOffset > curTick()) {
+            schedule(issueEvent, nextElement.tick + tickOffset);
+            return;
+        }
+
+        // Wait for a response if the request is held back. A
+        // response re-runs the issue event.
+        if (!canIssue()) {
+            if (!waitResponse) {
+                waitResponse = true;
+                waitStart = curTick();
+            }
+            return;
+        }
+
+        if (waitResponse) {
+            stats.dependencyTicks += curTick() - waitStart;
+            waitResponse = false;
+        }
+
+        // Anything that held the request back delays the rest of the
+        // trace by as much
+        if (honorTiming)
+            tickOffset = curTick() - nextElement.tick;
+
+        auto it = requestorIds.find(nextElement.requestor);
+        RequestPtr req = std::make_shared<Request>(
+            nextElement.addr, nextElement.size, nextElement.flags,
+            it != requestorIds.end() ? it->second : requestorId);
+
+        PacketPtr pkt = new Packet(req, nextElement.cmd);
+        pkt->allocate();
+        if (pkt->isWrite())
+            std::fill_n(pkt->getPtr<uint8_t>(), pkt->getSize(), 0);
+
+        const Addr block_addr = nextElement.addr & ~blockAddrMask;
+        pkt->pushSenderState(new ReplayState(nextSeqNum,
+            nextElement.requestor, block_addr, curTick()));
+
+        DPRINTF(TraceReplayer, "Issuing %s to %#x size %d (#%d)\n",
+                pkt->cmdString(), pkt->getAddr(), pkt->getSize(),
+                nextSeqNum);
+
+        numOutstanding++;
+        if (maxOutstandingPerRequestor)
+            outstandingPerRequestor[nextElement.requestor]++;
+        if (dependencyWindow)
+            outstandingBlocks[block_addr].push_back(nextSeqNum);
+
+        nextSeqNum++;
+        hasNextElement = readNextElement();
+
+        if (!port.sendTimingReq(pkt)) {
+            retryPkt = pkt;
+            retryStart = curTick();
+            stats.numRetries++;
+            return;
+        }
+
+        // Without the recorded timing, issue a request per cycle
+        if (!honorTiming) {
+            if (hasNextElement)
+                schedule(issueEvent, clockEdge(Cycles(1)));
+            return;
+        }
+    }
+}
+
+void
+TraceReplayer::recvRetry()
+{
+    assert(retryPkt);
+    if (port.sendTimingReq(retryPkt)) {
+        retryPkt = nullptr;
+        stats.retryTicks += curTick() - retryStart;
+
+        if (hasNextElement) {
+            schedule(issueEvent,
+                     honorTiming ? curTick() : clockEdge(Cycles(1)));
+        }
+    }
+}
+
+void
+TraceReplayer::completeRequest(PacketPtr pkt)
+{
+    auto state = safe_cast<ReplayState *>(pkt->popSenderState());
+    const Tick latency = curTick() - state->issueTick;
+
+    DPRINTF(TraceReplayer, "Completed %s to %#x (#%d) after %d ticks\n",
+            pkt->cmdString(), pkt->getAddr(), state->seqNum, latency);
+
+    if (pkt->isRead()) {
+        stats.numReads++;
+        stats.bytesRead += pkt->getSize();
+        stats.totalReadLatency += latency;
+    } else {
+        stats.numWrites++;
+        stats.bytesWritten += pkt->getSize();
+        stats.totalWriteLatency += latency;
+    }
+
+    numOutstanding--;
+    if (maxOutstandingPerRequestor) {
+        auto it = outstandingPerRequestor.find(state->requestor);
+        assert(it != outstandingPerRequestor.end());
+        if (--it->second == 0)
+            outstandingPerRequestor.erase(it);
+    }
+    if (dependencyWindow) {
+        auto it = outstandingBlocks.find(state->blockAddr);
+        assert(it != outstandingBlocks.end());
+        auto &seq_nums = it->second;
+        seq_nums.erase(std::find(seq_nums.begin(), seq_nums.end(),
+                                 state->seqNum));
+        if (seq_nums.empty())
+            outstandingBlocks.erase(it);
+    }
+
+    delete state;
+    delete pkt;
+
+    if (waitResponse && !issueEvent.scheduled())
+        schedule(issueEvent, curTick());
+
+    checkDone();
+}
+
+void
+TraceReplayer::checkDone()
+{
+    if (hasNextElement || numOutstanding || retryPkt)
+        return;
+
+    const double host_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - hostStart).count();
+    stats.hostSeconds = host_seconds;
+
+    const double num_requests = stats.numReads.value() +
+        stats.numWrites.value();
+    inform("%s: replayed %d requests in %.3f host seconds (%.0f requests/s)",
+           name(), (uint64_t)num_requests, host_seconds,
+           host_seconds > 0 ? num_requests / host_seconds : 0.0);
+
+    if (exitWhenDone)
+        exitSimLoop("trace replay complete");
+}
+
+TraceReplayer::TraceReplayerStats::TraceReplayerStats(
+    statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(numReads, statistics::units::Count::get(),
+               "Number of reads replayed"),
+      ADD_STAT(numWrites, statistics::units::Count::get(),
+               "Number of writes replayed"),
+      ADD_STAT(numSkipped, statistics::units::Count::get(),
+               "Number of trace entries without data that were skipped"),
+      ADD_STAT(bytesRead, statistics::units::Byte::get(),
+               "Number of bytes read"),
+      ADD_STAT(bytesWritten, statistics::units::Byte::get(),
+               "Number of bytes written"),
+      ADD_STAT(totalReadLatency, statistics::units::Tick::get(),
+               "Total latency of read requests"),
+      ADD_STAT(totalWriteLatency, statistics::units::Tick::get(),
+               "Total latency of write requests"),
+      ADD_STAT(numRetries, statistics::units::Count::get(),
+               "Number of retries"),
+      ADD_STAT(retryTicks, statistics::units::Tick::get(),
+               "Time spent waiting due to back-pressure"),
+      ADD_STAT(dependencyTicks, statistics::units::Tick::get(),
+               "Time spent waiting for the outstanding request limits and "
+               "the dependencies"),
+      ADD_STAT(hostSeconds, statistics::units::Second::get(),
+               "Host time spent replaying the trace"),
+      ADD_STAT(avgReadLatency, statistics::units::Rate<
+                    statistics::units::Tick, statistics::units::Count>::get(),
+               "Avg latency of read requests", totalReadLatency / numReads),
+      ADD_STAT(avgWriteLatency, statistics::units::Rate<
+                    statistics::units::Tick, statistics::units::Count>::get(),
+               "Avg latency of write requests",
+               totalWriteLatency / numWrites),
+      ADD_STAT(readBW, statistics::units::Rate<
+                    statistics::units::Byte, statistics::units::Second>::get(),
+               "Read bandwidth", bytesRead / simSeconds),
+      ADD_STAT(writeBW, statistics::units::Rate<
+                    statistics::units::Byte, statistics::units::Second>::get(),
+               "Write bandwidth", bytesWritten / simSeconds),
+      ADD_STAT(hostRate, statistics::units::Rate<
+                    statistics::units::Count, statistics::units::Second>::get(),
+               "Requests replayed per host second",
+               (numReads + numWrites) / hostSeconds)
+{
+}
+
+} // namespace gem5
@@ -0,0 +1,241 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_TESTERS_TRACE_REPLAYER_TRACE_REPLAYER_HH__
+#define __CPU_TESTERS_TRACE_REPLAYER_TRACE_REPLAYER_HH__
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/packet.hh"
+#include "mem/port.hh"
+#include "params/TraceReplayer.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+
+class ProtoInputStream;
+class ProtoMappedInputStream;
+
+namespace google
+{
+namespace protobuf
+{
+class Message;
+} // namespace protobuf
+} // namespace google
+
+namespace gem5
+{
+
+/**
+ * The TraceReplayer replays a packet trace recorded by a CommMonitor
+ * (or a MemTraceProbe) against the memory system it is connected to,
+ * so that different cache and memory configurations can be evaluated
+ * without simulating the CPUs that produced the trace.
+ *
+ * Uncompressed traces are mapped into memory and parsed in place;
+ * compressed traces are streamed. Requests are issued in trace
+ * order. By default the recorded gaps between requests are kept, and
+ * any time a request is held back delays all the requests after
+ * it. A request is held back while the total or the per-requestor
+ * number of outstanding requests is at its limit, or while an earlier
+ * request to the same block, within the dependency window, is still
+ * outstanding.
+ */
+class TraceReplayer : public ClockedObject
+{
+  public:
+
+    typedef TraceReplayerParams Params;
+    TraceReplayer(const Params &p);
+    ~TraceReplayer();
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    void startup() override;
+
+  protected:
+
+    class ReplayPort : public RequestPort
+    {
+        TraceReplayer &replayer;
+
+      public:
+
+        ReplayPort(const std::string &_name, TraceReplayer &_replayer)
+            : RequestPort(_name, &_replayer), replayer(_replayer)
+        { }
+
+      protected:
+
+        bool recvTimingResp(PacketPtr pkt) override;
+
+        void recvReqRetry() override;
+    };
+
+    /** A request read from the trace. */
+    struct TraceElement
+    {
+        /** Tick at which the request was recorded. */
+        Tick tick;
+
+        MemCmd cmd;
+        Addr addr;
+        unsigned size;
+        Request::FlagsType flags;
+
+        /** Requestor id recorded in the trace. */
+        uint64_t requestor;
+    };
+
+    /** Bookkeeping for an outstanding request. */
+    struct ReplayState : public Packet::SenderState
+    {
+        /** Position of the request in the trace. */
+        uint64_t seqNum;
+        uint64_t requestor;
+        Addr blockAddr;
+        Tick issueTick;
+
+        ReplayState(uint64_t seq_num, uint64_t _requestor,
+                    Addr block_addr, Tick issue_tick)
+            : seqNum(seq_num), requestor(_requestor),
+              blockAddr(block_addr), issueTick(issue_tick)
+        { }
+    };
+
+    /**
+     * Read the next replayable request of the trace into nextElement.
+     *
+     * @return False at the end of the trace
+     */
+    bool readNextElement();
+
+    /**
+     * Check if the limits on outstanding requests allow nextElement to
+     * be issued.
+     */
+    bool canIssue() const;
+
+    /** Issue as many requests as the timing and the limits allow. */
+    void issue();
+
+    /** Update the bookkeeping and the stats for a response. */
+    void completeRequest(PacketPtr pkt);
+
+    void recvRetry();
+
+    /** Exit the simulation loop once the whole trace is replayed. */
+    void checkDone();
+
+    /** Read the next message of whichever stream is used. */
+    bool readMessage(google::protobuf::Message &msg);
+
+    EventFunctionWrapper issueEvent;
+
+    ReplayPort port;
+
+    const std::string traceFile;
+
+    /** Exactly one of the streams is used. */
+    std::unique_ptr<ProtoMappedInputStream> mappedStream;
+    std::unique_ptr<ProtoInputStream> stream;
+
+    /**
+     * Requestor ids used for the requestors named in the trace header,
+     * so that the per-requestor stats of the memory system still tell
+     * them apart. Other requests use requestorId.
+     */
+    std::unordered_map<uint64_t, RequestorID> requestorIds;
+    RequestorID requestorId;
+
+    const bool honorTiming;
+    const unsigned maxOutstanding;
+    const unsigned maxOutstandingPerRequestor;
+    const unsigned dependencyWindow;
+    const bool exitWhenDone;
+
+    const Addr blockAddrMask;
+
+    /** Next request to issue and whether there is one. */
+    TraceElement nextElement;
+    bool hasNextElement;
+
+    /** Position of nextElement in the trace. */
+    uint64_t nextSeqNum;
+
+    /** Packet that was refused by the port, if any. */
+    PacketPtr retryPkt;
+    Tick retryStart;
+
+    /**
+     * Difference between the tick a request is replayed at and the
+     * tick it was recorded at, grown every time a request is held back.
+     */
+    Tick tickOffset;
+
+    /** Set when a request is held back until a response arrives. */
+    bool waitResponse;
+    Tick waitStart;
+
+    unsigned numOutstanding;
+    std::unordered_map<uint64_t, unsigned> outstandingPerRequestor;
+
+    /** Trace positions of the outstanding requests of each block. */
+    std::unordered_map<Addr, std::vector<uint64_t>> outstandingBlocks;
+
+    std::chrono::steady_clock::time_point hostStart;
+
+    struct TraceReplayerStats : public statistics::Group
+    {
+        TraceReplayerStats(statistics::Group *parent);
+
+        statistics::Scalar numReads;
+        statistics::Scalar numWrites;
+        statistics::Scalar numSkipped;
+        statistics::Scalar bytesRead;
+        statistics::Scalar bytesWritten;
+        statistics::Scalar totalReadLatency;
+        statistics::Scalar totalWriteLatency;
+        statistics::Scalar numRetries;
+        statistics::Scalar retryTicks;
+        statistics::Scalar dependencyTicks;
+        statistics::Scalar hostSeconds;
+        statistics::Formula avgReadLatency;
+        statistics::Formula avgWriteLatency;
+        statistics::Formula readBW;
+        statistics::Formula writeBW;
+        statistics::Formula hostRate;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif // __CPU_TESTERS_TRACE_REPLAYER_TRACE_REPLAYER_HH__
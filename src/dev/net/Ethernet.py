@@ -65,6 +65,8 @@ class EtherLink(SimObject):
     speed = Param.NetworkBandwidth('1Gbps', "link speed")
     dump = Param.EtherDump(NULL, "dump object")
 
+class DistTransport(Enum): vals = ['tcp', 'shm']
+
 class DistEtherLink(SimObject):
     type = 'DistEtherLink'
     cxx_header = "dev/net/dist_etherlink.hh"
@@ -84,6 +86,12 @@ class DistEtherLink(SimObject):
     is_switch = Param.Bool(False, "true if this a link in etherswitch")
     dist_sync_on_pseudo_op = Param.Bool(False, "Start sync with pseudo_op")
     num_nodes = Param.UInt32('2', "Number of simulate nodes")
+    transport = Param.DistTransport('tcp', "Message transport between the "
+        "gem5 processes (shm requires all of them to run on one host)")
+    shm_name = Param.String('', "Name of the shared memory segment "
+        "(shm transport), derived from server_port if empty")
+    shm_ring_size = Param.MemorySize('1MiB', "Size of each shared memory "
+        "ring (shm transport)")
 
 class EtherBus(SimObject):
     type = 'EtherBus'
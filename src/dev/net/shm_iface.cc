@@ -0,0 +1,465 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class for dist-gem5 runs.
+ */
+
+#include "dev/net/shm_iface.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/DistEthernet.hh"
+#include "debug/DistEthernetCmd.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+const uint64_t shmMagic = 0x67656d3573686d31ULL; // "gem5shm1"
+
+/** The segment header sits in its own page, the rings follow. */
+const size_t headerSize = 4096;
+
+/** Spin iterations before a waiter goes to sleep on the futex. */
+const unsigned spinLimit = 4096;
+
+enum SegmentState : uint32_t
+{
+    Creating = 0,
+    Ready = 1,
+    Closed = 2,
+};
+
+void
+futexWait(std::atomic<uint32_t> *addr, uint32_t val)
+{
+#if defined(__linux__)
+    // Not FUTEX_PRIVATE: the word is shared with the peer process.
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(addr), FUTEX_WAIT, val,
+            nullptr, nullptr, 0);
+#else
+    if (addr->load() == val)
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+}
+
+void
+futexWake(std::atomic<uint32_t> *addr)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(addr), FUTEX_WAKE,
+            INT32_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+} // anonymous namespace
+
+struct ShmIface::SegmentHeader
+{
+    uint64_t magic;
+    uint32_t numChannels;
+    uint64_t ringSize;
+    uint64_t ringStride;
+    std::atomic<uint32_t> state;
+};
+
+struct ShmIface::Ring
+{
+    /** Total number of bytes produced, only written by the producer. */
+    alignas(64) std::atomic<uint64_t> head;
+    /** Total number of bytes consumed, only written by the consumer. */
+    alignas(64) std::atomic<uint64_t> tail;
+    /** Futex word, bumped every time head or tail moves. */
+    alignas(64) std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> waiters;
+    std::atomic<uint32_t> closed;
+};
+
+ShmIface::SegmentHeader *ShmIface::segment = nullptr;
+size_t ShmIface::segmentSize = 0;
+uint64_t ShmIface::ringSize = 0;
+std::string ShmIface::segmentName;
+std::vector<ShmIface *> ShmIface::ifaceRegistry;
+
+ShmIface::ShmIface(std::string shm_name, uint64_t ring_size,
+                   unsigned dist_rank, unsigned dist_size,
+                   Tick sync_start, Tick sync_repeat,
+                   EventManager *em, bool use_pseudo_op, bool is_switch,
+                   int num_nodes) :
+    DistIface(dist_rank, dist_size, sync_start, sync_repeat, em, use_pseudo_op,
+              is_switch, num_nodes),
+    isSwitch(is_switch), txRing(nullptr), rxRing(nullptr)
+{
+    if (shm_name.empty() || shm_name.front() != '/')
+        shm_name = "/" + shm_name;
+    if (segmentName.empty()) {
+        segmentName = shm_name;
+        ringSize = uint64_t(1) << ceilLog2(std::max<uint64_t>(ring_size,
+                                                              4096));
+    }
+    fatal_if(shm_name != segmentName, "All dist links of a process must use "
+             "the same shm segment (%s vs %s)", shm_name, segmentName);
+
+    // The switch owns the segment. The compute nodes might be started
+    // before or after the switch and attach to it in initTransport().
+    if (is_switch && isPrimary)
+        createSegment(size);
+    ifaceRegistry.push_back(this);
+}
+
+ShmIface::Ring *
+ShmIface::ring(SegmentHeader *hdr, unsigned idx)
+{
+    auto base = reinterpret_cast<uint8_t *>(hdr);
+    return reinterpret_cast<Ring *>(base + headerSize +
+                                    idx * hdr->ringStride);
+}
+
+uint8_t *
+ShmIface::ringData(Ring *ring)
+{
+    return reinterpret_cast<uint8_t *>(ring) + sizeof(Ring);
+}
+
+void
+ShmIface::createSegment(unsigned num_channels)
+{
+    static_assert(sizeof(SegmentHeader) <= headerSize,
+                  "Segment header does not fit into its page");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "Shared memory rings need address-free atomics");
+
+    // Two rings per compute node: node -> switch and switch -> node.
+    uint64_t stride = roundUp(sizeof(Ring) + ringSize, 4096);
+    segmentSize = headerSize + 2 * num_channels * stride;
+
+    // Remove a segment left behind by an earlier run that did not exit
+    // cleanly. Nodes that already attached to it see it closed and exit.
+    int fd = shm_open(segmentName.c_str(), O_RDWR, 0600);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > (off_t)headerSize) {
+            void *old = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd, 0);
+            if (old != MAP_FAILED) {
+                auto hdr = static_cast<SegmentHeader *>(old);
+                if (hdr->magic == shmMagic && hdr->state.load() == Ready &&
+                    headerSize + 2 * hdr->numChannels * hdr->ringStride <=
+                    (uint64_t)st.st_size) {
+                    closeSegment(hdr);
+                }
+                munmap(old, st.st_size);
+            }
+        }
+        close(fd);
+        shm_unlink(segmentName.c_str());
+    }
+
+    fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    panic_if(fd < 0, "shm_open(%s) failed: %s", segmentName,
+             strerror(errno));
+    panic_if(ftruncate(fd, segmentSize) != 0, "ftruncate() failed: %s",
+             strerror(errno));
+    void *addr = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    panic_if(addr == MAP_FAILED, "mmap() failed: %s", strerror(errno));
+    close(fd);
+
+    // The new segment is zero filled, which is an empty, open ring.
+    segment = static_cast<SegmentHeader *>(addr);
+    segment->magic = shmMagic;
+    segment->numChannels = num_channels;
+    segment->ringSize = ringSize;
+    segment->ringStride = stride;
+    segment->state.store(Ready);
+
+    inform("shm_iface created segment %s (%d nodes, %d byte rings)",
+           segmentName, num_channels, ringSize);
+}
+
+void
+ShmIface::openSegment()
+{
+    bool waiting = false;
+    for (;;) {
+        int fd = shm_open(segmentName.c_str(), O_RDWR, 0600);
+        if (fd >= 0) {
+            struct stat st;
+            void *addr = MAP_FAILED;
+            if (fstat(fd, &st) == 0 && st.st_size > (off_t)headerSize) {
+                addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+            }
+            close(fd);
+            if (addr != MAP_FAILED) {
+                auto hdr = static_cast<SegmentHeader *>(addr);
+                if (hdr->state.load() == Ready) {
+                    panic_if(hdr->magic != shmMagic,
+                             "%s is not a dist-gem5 segment", segmentName);
+                    segment = hdr;
+                    segmentSize = st.st_size;
+                    ringSize = hdr->ringSize;
+                    return;
+                }
+                munmap(addr, st.st_size);
+            }
+        }
+        if (!waiting) {
+            inform("shm_iface waiting for the switch to create %s",
+                   segmentName);
+            waiting = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void
+ShmIface::waitRing(Ring *ring, bool producer)
+{
+    auto ready = [ring, producer]() {
+        uint64_t used = ring->head.load() - ring->tail.load();
+        return ring->closed.load() ||
+            (producer ? used < ringSize : used > 0);
+    };
+
+    for (unsigned i = 0; i < spinLimit; i++) {
+        if (ready())
+            return;
+    }
+
+    for (;;) {
+        ring->waiters.fetch_add(1);
+        uint32_t seq = ring->seq.load();
+        if (ready()) {
+            ring->waiters.fetch_sub(1);
+            return;
+        }
+        futexWait(&ring->seq, seq);
+        ring->waiters.fetch_sub(1);
+    }
+}
+
+void
+ShmIface::wakeRing(Ring *ring)
+{
+    ring->seq.fetch_add(1);
+    if (ring->waiters.load())
+        futexWake(&ring->seq);
+}
+
+void
+ShmIface::closeRing(Ring *ring)
+{
+    ring->closed.store(1);
+    wakeRing(ring);
+}
+
+void
+ShmIface::closeSegment(SegmentHeader *hdr)
+{
+    hdr->state.store(Closed);
+    for (unsigned i = 0; i < 2 * hdr->numChannels; i++)
+        closeRing(ring(hdr, i));
+}
+
+void
+ShmIface::sendShm(const void *buf, size_t length)
+{
+    auto src = static_cast<const uint8_t *>(buf);
+    uint8_t *data = ringData(txRing);
+    const uint64_t mask = ringSize - 1;
+
+    while (length > 0) {
+        uint64_t head = txRing->head.load(std::memory_order_relaxed);
+        uint64_t space = ringSize - (head - txRing->tail.load());
+        if (space == 0) {
+            if (txRing->closed.load()) {
+                exitSimLoop("Message server closed connection, simulation "
+                            "is exiting");
+                return;
+            }
+            waitRing(txRing, true);
+            continue;
+        }
+
+        size_t n = std::min<uint64_t>(length, space);
+        size_t off = head & mask;
+        size_t first = std::min<size_t>(n, ringSize - off);
+        std::memcpy(data + off, src, first);
+        std::memcpy(data, src + first, n - first);
+
+        txRing->head.store(head + n);
+        wakeRing(txRing);
+        src += n;
+        length -= n;
+    }
+}
+
+bool
+ShmIface::recvShm(void *buf, size_t length)
+{
+    auto dst = static_cast<uint8_t *>(buf);
+    const uint8_t *data = ringData(rxRing);
+    const uint64_t mask = ringSize - 1;
+
+    while (length > 0) {
+        uint64_t tail = rxRing->tail.load(std::memory_order_relaxed);
+        uint64_t avail = rxRing->head.load() - tail;
+        if (avail == 0) {
+            if (rxRing->closed.load()) {
+                inform("recvShm(): Connection closed");
+                return false;
+            }
+            waitRing(rxRing, false);
+            continue;
+        }
+
+        size_t n = std::min<uint64_t>(length, avail);
+        size_t off = tail & mask;
+        size_t first = std::min<size_t>(n, ringSize - off);
+        std::memcpy(dst, data + off, first);
+        std::memcpy(dst + first, data, n - first);
+
+        rxRing->tail.store(tail + n);
+        wakeRing(rxRing);
+        dst += n;
+        length -= n;
+    }
+    return true;
+}
+
+void
+ShmIface::sendPacket(const Header &header, const EthPacketPtr &packet)
+{
+    std::lock_guard<std::mutex> tx_lock(txLock);
+    sendShm(&header, sizeof(header));
+    sendShm(packet->data, packet->length);
+}
+
+void
+ShmIface::sendCmd(const Header &header)
+{
+    DPRINTF(DistEthernetCmd, "ShmIface::sendCmd() type: %d\n",
+            static_cast<int>(header.msgType));
+    // Global commands (i.e. sync request) are always sent by the primary
+    // DistIface, point-to-point on every interface of this process.
+    for (auto iface : ifaceRegistry) {
+        std::lock_guard<std::mutex> tx_lock(iface->txLock);
+        iface->sendShm(&header, sizeof(header));
+    }
+}
+
+bool
+ShmIface::recvHeader(Header &header)
+{
+    bool ret = recvShm(&header, sizeof(header));
+    DPRINTF(DistEthernetCmd, "ShmIface::recvHeader() type: %d ret: %d\n",
+            static_cast<int>(header.msgType), ret);
+    return ret;
+}
+
+void
+ShmIface::recvPacket(const Header &header, EthPacketPtr &packet)
+{
+    packet = std::make_shared<EthPacketData>(header.dataPacketLength);
+    bool ret = recvShm(packet->data, header.dataPacketLength);
+    panic_if(!ret, "Error while reading shared memory ring");
+    packet->simLength = header.simLength;
+    packet->length = header.dataPacketLength;
+}
+
+void
+ShmIface::initTransport()
+{
+    // As with TCPIface, the number of dist interfaces per process is only
+    // known at init time.
+    unsigned channel;
+    if (isSwitch) {
+        fatal_if(distIfaceNum != size, "The dist switch needs one link per "
+                 "node for the shm transport (%d links, %d nodes)",
+                 distIfaceNum, size);
+        channel = distIfaceId;
+    } else {
+        fatal_if(distIfaceNum != 1, "The shm dist transport supports one "
+                 "DistEtherLink per compute node");
+        if (!segment)
+            openSegment();
+        fatal_if(rank >= segment->numChannels, "Rank %d is out of range for "
+                 "a %d node dist switch", rank, segment->numChannels);
+        channel = rank;
+    }
+
+    Ring *to_switch = ring(segment, 2 * channel);
+    Ring *from_switch = ring(segment, 2 * channel + 1);
+    txRing = isSwitch ? from_switch : to_switch;
+    rxRing = isSwitch ? to_switch : from_switch;
+
+    DPRINTF(DistEthernet, "ShmIface: iface %d uses channel %d of %s\n",
+            distIfaceId, channel, segmentName);
+    inform("Link okay  (iface:%d -> shm channel:%d)", distIfaceId, channel);
+}
+
+ShmIface::~ShmIface()
+{
+    // Let the peer and our own receiver thread know that we are gone.
+    if (txRing)
+        closeRing(txRing);
+    if (rxRing)
+        closeRing(rxRing);
+
+    ifaceRegistry.erase(std::find(ifaceRegistry.begin(),
+                                  ifaceRegistry.end(), this));
+    // The receiver threads are joined by the DistIface dtor and may still
+    // touch the rings, so the segment stays mapped until the process exits.
+    if (ifaceRegistry.empty() && isSwitch && segment) {
+        closeSegment(segment);
+        shm_unlink(segmentName.c_str());
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,160 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class for dist-gem5 runs.
+ *
+ * For a high level description about dist-gem5 see comments in
+ * header file dist_iface.hh.
+ *
+ * When all gem5 processes of a dist run live on the same host, the
+ * messages do not need to go through the TCP stack. The switch process
+ * creates a POSIX shared memory segment that holds a pair of single
+ * producer, single consumer byte rings for each compute node (one ring in
+ * each direction). Messages use the same framing as TCPIface (a dist
+ * header optionally followed by the Ethernet frame). A receiver thread
+ * that finds its ring empty spins for a short while and then sleeps on a
+ * futex, so a sync barrier costs a couple of cache line transfers instead
+ * of a round trip through the kernel network stack.
+ *
+ * The switch simulates one DistEtherLink per compute node, and its link
+ * with ID i is connected to the node with rank i. Each compute node must
+ * have exactly one DistEtherLink.
+ */
+#ifndef __DEV_NET_SHM_IFACE_HH__
+#define __DEV_NET_SHM_IFACE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dev/net/dist_iface.hh"
+
+namespace gem5
+{
+
+class EventManager;
+
+class ShmIface : public DistIface
+{
+  private:
+    /** Header at the start of the shared memory segment. */
+    struct SegmentHeader;
+    /** Control block of one ring, followed by the ring buffer itself. */
+    struct Ring;
+
+    /**
+     * The segment is shared by every ShmIface of this process.
+     */
+    static SegmentHeader *segment;
+    static size_t segmentSize;
+    static uint64_t ringSize;
+    static std::string segmentName;
+    /**
+     * All interfaces of this process, the primary sends global commands
+     * to each of them.
+     */
+    static std::vector<ShmIface *> ifaceRegistry;
+
+    bool isSwitch;
+
+    /**
+     * The ring this interface produces into and the ring it consumes from.
+     */
+    Ring *txRing;
+    Ring *rxRing;
+    /**
+     * The peer process is the only other party of each ring, but in this
+     * process both the simulation thread and the receiver threads (global
+     * commands on the switch) may send on the same interface.
+     */
+    std::mutex txLock;
+
+  private:
+    /** Create the segment (switch) or wait until the switch created it. */
+    void createSegment(unsigned num_channels);
+    void openSegment();
+    static Ring *ring(SegmentHeader *hdr, unsigned idx);
+    static uint8_t *ringData(Ring *ring);
+
+    /**
+     * Block until the ring has free space (producer) or data (consumer),
+     * or until it is closed.
+     */
+    void waitRing(Ring *ring, bool producer);
+    static void wakeRing(Ring *ring);
+    static void closeRing(Ring *ring);
+    /** Close every ring, so that all attached processes stop. */
+    static void closeSegment(SegmentHeader *hdr);
+
+    /**
+     * Copy a message into the tx ring. Large messages are streamed
+     * through the ring as the consumer frees up space.
+     */
+    void sendShm(const void *buf, size_t length);
+    /**
+     * Copy the next length bytes out of the rx ring.
+     *
+     * @return False if the peer closed the ring.
+     */
+    bool recvShm(void *buf, size_t length);
+
+  protected:
+
+    void sendPacket(const Header &header,
+                    const EthPacketPtr &packet) override;
+
+    void sendCmd(const Header &header) override;
+
+    bool recvHeader(Header &header) override;
+
+    void recvPacket(const Header &header, EthPacketPtr &packet) override;
+
+    void initTransport() override;
+
+  public:
+    /**
+     * The switch creates the shared memory segment in the ctor, the
+     * compute nodes attach to it in initTransport().
+     * @param shm_name The name of the POSIX shared memory segment.
+     * @param ring_size The size of each ring buffer in bytes.
+     * @param sync_start The tick for the first dist synchronisation.
+     * @param sync_repeat The frequency of dist synchronisation.
+     * @param em The EventManager object associated with the simulated
+     * Ethernet link.
+     */
+    ShmIface(std::string shm_name, uint64_t ring_size,
+             unsigned dist_rank, unsigned dist_size,
+             Tick sync_start, Tick sync_repeat, EventManager *em,
+             bool use_pseudo_op, bool is_switch, int num_nodes);
+
+    ~ShmIface() override;
+};
+
+} // namespace gem5
+
+#endif // __DEV_NET_SHM_IFACE_HH__
@@ -83,12 +83,12 @@ private:
     void _do_cycle ();
 
     // API for UpstreamPort/DownstreamPort
-    bool is_sleeping () const { return _is_sleeping; }
     bool is_update_phase () const { return curCycle() >= _latest_cycle_plus1; }
     bool is_exchange_phase () const { return curCycle() < _latest_cycle_plus1; }
 
 protected:
     void wakeup ();
+    bool is_sleeping () const { return _is_sleeping; }
 
     virtual void update () {};
     virtual void exchange () {};
@@ -0,0 +1,113 @@
+#include "debug/DuetDVFS.hh"
+#include "duet/engine/DuetDVFSGovernor.hh"
+#include "duet/engine/DuetEngine.hh"
+#include "sim/stats.hh"
+#include "base/trace.hh"
+
+namespace gem5 {
+namespace duet {
+
+DuetDVFSGovernor::Stats::Stats ( DuetDVFSGovernor & governor )
+    : statistics::Group ( &governor )
+    , governor          ( governor )
+    , ADD_STAT ( residency, statistics::units::Tick::get (),
+            "Time (ticks) spent at each performance level" )
+    , ADD_STAT ( transitions, statistics::units::Count::get (),
+            "Number of performance level changes" )
+    , ADD_STAT ( energy, statistics::units::Joule::get (),
+            "Estimated dynamic energy of the engine" )
+    , ADD_STAT ( power, statistics::units::Watt::get (),
+            "Average dynamic power of the engine",
+            energy / simSeconds )
+{}
+
+void DuetDVFSGovernor::Stats::regStats () {
+    statistics::Group::regStats ();
+
+    auto levels = governor._domain->numPerfLevels ();
+    residency.init ( levels );
+    for ( SrcClockDomain::PerfLevel i = 0; i < levels; ++i )
+        residency.subname ( i, csprintf ( "level%u", i ) );
+    residency.flags ( statistics::total | statistics::nozero );
+}
+
+DuetDVFSGovernor::DuetDVFSGovernor ( const DuetDVFSGovernorParams & p )
+    : SimObject                 ( p )
+    , _engine                   ( nullptr )
+    , _domain                   ( p.domain )
+    , _sample_period            ( p.sample_period )
+    , _up_backlog               ( p.up_backlog )
+    , _down_backlog             ( p.down_backlog )
+    , _up_utilization           ( p.up_utilization )
+    , _down_utilization         ( p.down_utilization )
+    , _switched_capacitance     ( p.switched_capacitance )
+    , _stats                    ( *this )
+    , _e_sample                 ( [this]{ _sample(); }, name() )
+    , _last_tick                ( 0 )
+    , _last_busy_lane_ticks     ( 0 )
+    , _last_awake_cycles        ( 0 )
+{
+    fatal_if ( 0 == _sample_period, "%s: sample period must be non-zero",
+            name () );
+    fatal_if ( _down_backlog > _up_backlog
+            || _down_utilization > _up_utilization,
+            "%s: down thresholds must not exceed up thresholds", name () );
+}
+
+void DuetDVFSGovernor::startup () {
+    SimObject::startup ();
+
+    panic_if ( nullptr == _engine, "%s: not attached to an engine", name () );
+    warn_if ( _domain->numPerfLevels () < 2,
+            "%s: clock domain %s has only one performance level",
+            name (), _domain->name () );
+
+    _last_tick              = curTick ();
+    _last_busy_lane_ticks   = _engine->get_busy_lane_ticks ();
+    _last_awake_cycles      = _engine->get_awake_cycles ();
+    schedule ( _e_sample, curTick () + _sample_period );
+}
+
+void DuetDVFSGovernor::_sample () {
+    auto level = _domain->perfLevel ();
+
+    // account for the last window, which ran at the current level
+    Tick elapsed        = curTick () - _last_tick;
+    Tick busy           = _engine->get_busy_lane_ticks () - _last_busy_lane_ticks;
+    Counter awake       = _engine->get_awake_cycles () - _last_awake_cycles;
+    double voltage      = _domain->voltage ();
+
+    _stats.residency [level] += elapsed;
+    _stats.energy += _switched_capacitance * voltage * voltage * awake;
+
+    // decide the next level. Level 0 is the highest frequency
+    double backlog = double ( _engine->get_num_pending_calls () )
+        / _engine->get_num_callers ();
+    double utilization = 0 == _engine->get_num_lanes () ? 0.
+        : double ( busy ) / ( double ( elapsed ) * _engine->get_num_lanes () );
+
+    auto next = level;
+    if ( ( backlog > _up_backlog || utilization > _up_utilization )
+            && level > 0 )
+        next = level - 1;
+    else if ( backlog <= _down_backlog
+            && utilization < _down_utilization
+            && level + 1 < _domain->numPerfLevels () )
+        next = level + 1;
+
+    DPRINTF ( DuetDVFS, "backlog %.2f, utilization %.2f, level %u -> %u\n",
+            backlog, utilization, level, next );
+
+    if ( next != level ) {
+        _domain->perfLevel ( next );
+        ++_stats.transitions;
+    }
+
+    _last_tick              = curTick ();
+    _last_busy_lane_ticks   = _engine->get_busy_lane_ticks ();
+    _last_awake_cycles      = _engine->get_awake_cycles ();
+    schedule ( _e_sample, curTick () + _sample_period );
+}
+
+}   // namespace duet
+}   // namespace gem5
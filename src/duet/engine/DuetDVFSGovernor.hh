@@ -0,0 +1,92 @@
+#ifndef __DUET_DVFS_GOVERNOR_HH
+#define __DUET_DVFS_GOVERNOR_HH
+
+#include "params/DuetDVFSGovernor.hh"
+#include "sim/sim_object.hh"
+#include "sim/clock_domain.hh"
+#include "base/statistics.hh"
+
+namespace gem5 {
+namespace duet {
+
+class DuetEngine;
+
+/*
+ * DuetDVFSGovernor:
+ *
+ *  Periodically raises or lowers the performance level of the engine's clock
+ *  domain based on the number of pending calls per caller and the utilization
+ *  of the lanes. Objects in the same clock domain (e.g. the engine side of the
+ *  DuetAsyncFIFOs) follow the new frequency automatically.
+ */
+class DuetDVFSGovernor : public SimObject {
+// ===========================================================================
+// == Type Definitions =======================================================
+// ===========================================================================
+private:
+
+    /* Statistics */
+    struct Stats : public statistics::Group {
+
+        const DuetDVFSGovernor & governor;
+
+        // time (ticks) spent at each performance level
+        statistics::Vector          residency;
+
+        // number of performance level changes
+        statistics::Scalar          transitions;
+
+        // estimated dynamic energy (J) of the engine
+        statistics::Scalar          energy;
+
+        // average dynamic power (W)
+        statistics::Formula         power;
+
+        // -- Methods --------------------------------------------------------
+        Stats ( DuetDVFSGovernor & governor );
+
+        void regStats () override;
+    };
+
+// ===========================================================================
+// == Parameterized Member Variables =========================================
+// ===========================================================================
+private:
+    DuetEngine                * _engine;
+    SrcClockDomain            * _domain;
+    Tick                        _sample_period;
+    double                      _up_backlog;
+    double                      _down_backlog;
+    double                      _up_utilization;
+    double                      _down_utilization;
+    double                      _switched_capacitance;
+    Stats                       _stats;
+
+// ===========================================================================
+// == Non-Parameterized Member Variables =====================================
+// ===========================================================================
+private:
+    EventFunctionWrapper        _e_sample;
+
+    // engine counters at the last sample
+    Tick                        _last_tick;
+    Tick                        _last_busy_lane_ticks;
+    Counter                     _last_awake_cycles;
+
+private:
+    void _sample ();
+
+// ===========================================================================
+// == General API ============================================================
+// ===========================================================================
+public:
+    DuetDVFSGovernor ( const DuetDVFSGovernorParams & p );
+
+    void set_engine ( DuetEngine * e ) { _engine = e; }
+    void startup () override;
+};
+
+}   // namespace duet
+}   // namespace gem5
+
+#endif /* #ifndef __DUET_DVFS_GOVERNOR_HH */
@@ -0,0 +1,21 @@
+from m5.params import *
+from m5.proxy import *
+from m5.objects import *
+from m5.objects.SimObject import SimObject
+
+class DuetDVFSGovernor (SimObject):
+    type                    = "DuetDVFSGovernor"
+    cxx_class               = "gem5::duet::DuetDVFSGovernor"
+    cxx_header              = "duet/engine/DuetDVFSGovernor.hh"
+
+    domain                  = Param.SrcClockDomain ( Parent.clk_domain,
+                                "Clock domain of the engine (needs multiple performance levels)" )
+    sample_period           = Param.Latency ( "10us", "Time between two governor decisions" )
+    up_backlog              = Param.Float ( 4.0, "Raise the frequency if the average number "
+                                "of pending calls per caller exceeds this" )
+    down_backlog            = Param.Float ( 1.0, "Lower the frequency only if the average number "
+                                "of pending calls per caller is at most this" )
+    up_utilization          = Param.Float ( 0.8, "Raise the frequency if lane utilization exceeds this" )
+    down_utilization        = Param.Float ( 0.3, "Lower the frequency only if lane utilization is below this" )
+    switched_capacitance    = Param.Float ( 1e-9, "Effective switched capacitance (F) per cycle, "
+                                "for energy estimation" )
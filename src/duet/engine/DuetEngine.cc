@@ -1,9 +1,16 @@
+#include <algorithm>
+#include <cstring>
+
 #include "debug/DuetEngine.hh"
 #include "debug/DuetEngineDetailed.hh"
 #include "duet/engine/DuetEngine.hh"
+#include "duet/engine/DuetDVFSGovernor.hh"
+#include "duet/engine/DuetEngineTrace.hh"
 #include "duet/engine/DuetLane.hh"
 #include "sim/system.hh"
 #include "sim/process.hh"
+#include "sim/sim_exit.hh"
+#include "base/output.hh"
 #include "base/trace.hh"
 #include "mem/packet_access.hh"
 
@@ -30,6 +37,27 @@ DuetEngine::Stats::Stats ( DuetEngine & engine )
             "Execution waiting time (#cycles)" )
     , ADD_STAT ( exectime,  statistics::units::Cycle::get (),
             "Execution time (#cycles)" )
+    , ADD_STAT ( combinedstores, statistics::units::Count::get (),
+            "Number of stores merged into the write-combining buffers" )
+    , ADD_STAT ( combinedwrites, statistics::units::Count::get (),
+            "Number of writes sent from the write-combining buffers" )
+    , ADD_STAT ( combinedbytes, statistics::units::Byte::get (),
+            "Number of bytes written from the write-combining buffers" )
+    , ADD_STAT ( combineratio, statistics::units::Ratio::get (),
+            "Average number of stores per write-combined write",
+            combinedstores / combinedwrites )
+    , ADD_STAT ( grants, statistics::units::Count::get (),
+            "Number of calls started per caller" )
+    , ADD_STAT ( deadlinemisses, statistics::units::Count::get (),
+            "Number of calls that waited longer than the caller's deadline" )
+    , ADD_STAT ( slotswitches, statistics::units::Count::get (),
+            "Number of times a caller is bound to a slot" )
+    , ADD_STAT ( waitp50, statistics::units::Cycle::get (),
+            "Median waiting time (#cycles) per caller" )
+    , ADD_STAT ( waitp90, statistics::units::Cycle::get (),
+            "90th percentile waiting time (#cycles) per caller" )
+    , ADD_STAT ( waitp99, statistics::units::Cycle::get (),
+            "99th percentile waiting time (#cycles) per caller" )
 {}
 
 void DuetEngine::Stats::regStats () {
@@ -58,6 +86,45 @@ void DuetEngine::Stats::regStats () {
     exectime
         .init  ( 0, max_exectime, exectime_bucketsize )
         .flags ( statistics::nozero | statistics::nonan | statistics::dist );
+
+    auto num_callers = engine._num_callers;
+    for ( auto stat : { &grants, &deadlinemisses, &waitp50, &waitp90, &waitp99 } ) {
+        stat->init ( num_callers );
+        for ( DuetFunctor::caller_id_t i = 0; i < num_callers; ++i )
+            stat->subname ( i, csprintf ( "caller%u", i ) );
+        stat->flags ( statistics::nozero );
+    }
+    grants.flags ( statistics::total );
+    deadlinemisses.flags ( statistics::total );
+
+    waitsamples.resize ( num_callers );
+}
+
+void DuetEngine::Stats::resetStats () {
+    statistics::Group::resetStats ();
+
+    for ( auto & samples : waitsamples )
+        samples.clear ();
+}
+
+void DuetEngine::Stats::preDumpStats () {
+    statistics::Group::preDumpStats ();
+
+    for ( size_t i = 0; i < waitsamples.size (); ++i ) {
+        auto samples = waitsamples [i];
+        if ( samples.empty () )
+            continue;
+
+        auto percentile = [&samples] ( double p ) {
+            auto nth = samples.begin () + size_t ( p * ( samples.size () - 1 ) );
+            std::nth_element ( samples.begin (), nth, samples.end () );
+            return uint64_t ( *nth );
+        };
+
+        waitp50 [i] = percentile ( 0.50 );
+        waitp90 [i] = percentile ( 0.90 );
+        waitp99 [i] = percentile ( 0.99 );
+    }
 }
 
 DuetEngine::DuetEngine ( const DuetEngineParams & p )
@@ -70,7 +137,27 @@ DuetEngine::DuetEngine ( const DuetEngineParams & p )
     , _lanes                    ( p.lanes )
     , _sri_port                 ( p.name + ".sri_port", this )
     , _writeclean               ( p.writeclean )
+    , _wcb_entries              ( p.wcb_entries )
+    , _wcb_timeout              ( p.wcb_timeout )
+    , _governor                 ( p.governor )
+    , _arbitration              ( p.arbitration )
+    , _caller_weights           ( p.caller_weights )
+    , _caller_deadlines         ( p.caller_deadlines )
+    , _caller_slots             ( p.caller_slots )
+    , _slot_quantum             ( p.slot_quantum )
+    , _slot_switch_latency      ( p.slot_switch_latency )
     , _stats                    ( *this )
+    , _trace                    ()
+    , _is_replaying             ( false )
+    , _awake_cycles             ( 0 )
+    , _busy_lane_ticks          ( 0 )
+    , _num_pending_calls        ( 0 )
+    , _next_caller              ( 0 )
+    , _num_bound                ( 0 )
+    , _wcb_draining             ( false )
+    , _e_wcb_timeout            ( [this]{ _timer_wakeup(); }, name() )
+    , _e_replay                 ( [this]{ _timer_wakeup(); }, name() )
+    , _is_replay_done           ( false )
 {
     _requestorId = p.system->getRequestorId (this);
 
@@ -81,9 +168,56 @@ DuetEngine::DuetEngine ( const DuetEngineParams & p )
 
     for ( auto & lane : _lanes )
         lane->set_engine ( this );
+
+    if ( _governor )
+        _governor->set_engine ( this );
+
+    fatal_if ( !_caller_weights.empty ()
+            && _caller_weights.size () != _num_callers,
+            "%s: %d caller weights given for %d callers", name(),
+            _caller_weights.size (), _num_callers );
+    fatal_if ( !_caller_deadlines.empty ()
+            && _caller_deadlines.size () != _num_callers,
+            "%s: %d caller deadlines given for %d callers", name(),
+            _caller_deadlines.size (), _num_callers );
+    fatal_if ( DuetArbitration::Deadline == _arbitration
+            && _caller_deadlines.empty (),
+            "%s: deadline arbitration requires caller deadlines", name() );
+    fatal_if ( _caller_slots > _num_callers,
+            "%s: more caller slots (%d) than callers (%d)", name(),
+            _caller_slots, _num_callers );
+
+    if ( _caller_weights.empty () )
+        _caller_weights.resize ( _num_callers, 1 );
+
+    if ( 0 == _caller_slots )
+        _caller_slots = _num_callers;
+
+    fatal_if ( !p.trace_record.empty () && !p.trace_replay.empty (),
+            "%s: cannot record and replay a trace at the same time", name() );
+    fatal_if ( nullptr == _process && p.trace_replay.empty (),
+            "%s: a process is required unless replaying a trace", name() );
+
+    if ( !p.trace_record.empty () ) {
+        _trace.reset ( new DuetEngineTrace ( name () ) );
+        _trace->start_recording (
+                simout.resolve ( name () + "." + p.trace_record ),
+                _num_callers, _system->cacheLineSize () );
+        registerExitCallback ( [this]{ _trace->stop_recording (); } );
+    } else if ( !p.trace_replay.empty () ) {
+        _trace.reset ( new DuetEngineTrace ( name () ) );
+        _trace->load_replay ( p.trace_replay,
+                _num_callers, _system->cacheLineSize () );
+        _is_replaying = true;
+    }
 }
 
+// out of line, where DuetEngineTrace is complete
+DuetEngine::~DuetEngine () = default;
+
 void DuetEngine::update () {
+    ++_awake_cycles;
+
     if ( nullptr != _sri_port.req_buf && !_is_blocked ) {
         _is_blocked = true;
         _blocked_from = curCycle ();
@@ -105,12 +239,29 @@ void DuetEngine::update () {
             pkt->makeResponse ();
             _sri_port.req_buf = nullptr;
             _sri_port.resp_buf = pkt;
+
+            if ( _trace )
+                _trace->record_softreg ( curTick (), false, id, value );
         }
     }
 
+    //     when replaying a trace, recorded accesses take the place of the SRI
+    //     port, one access per cycle
+    bool replayed = _is_replaying && _replay_softreg ( false );
+
     //  2. if ROBs contain ack'ed responses, push into return channels
     std::vector <bool> chan_pushed ( get_num_memory_chans(), false );
     for ( auto & rob : _rob ) {
+        // retire flushed writes, which return nothing to the lanes
+        while ( !rob.empty ()
+                && !rob.front ().token
+                && ROBEntry::RESPONDED == rob.front ().status
+                && curTick () >= rob.front ().readyAfter )
+            rob.pop_front ();
+
+        if ( rob.empty () )
+            continue;
+
         auto & entry = rob.front ();
         if ( ROBEntry::RESPONDED == entry.status
                 && curTick () >= entry.readyAfter
@@ -123,7 +274,9 @@ void DuetEngine::update () {
         }
     }
 
-    //  3. send as many memory requests as we can
+    //  3. send as many memory requests as we can, after flushing timed-out
+    //     write-combining buffer entries
+    _flush_wcb_timeout ();
     try_send_mem_req_all ();
 
     //  4. call pull_phase on all lanes
@@ -145,9 +298,15 @@ void DuetEngine::update () {
             pkt->makeResponse ();
             _sri_port.req_buf = nullptr;
             _sri_port.resp_buf = pkt;
+
+            if ( _trace )
+                _trace->record_softreg ( curTick (), true, id, value );
         }
     }
 
+    if ( _is_replaying && !replayed )
+        _replay_softreg ( true );
+
     //  2. if memory response buffer contains a valid response, see if we
     //     can accept it
     for ( int i = 0; i < _mem_ports.size (); ++i ) {
@@ -166,7 +325,11 @@ void DuetEngine::update () {
 
                 if ( pkt->isRead () ) {
                     entry.data.reset ( new uint8_t [ entry.size ] );
-                    if ( pkt->getSize () != entry.size ) {
+                    if ( _is_replaying ) {
+                        // the memory system only provides timing
+                        _trace->read_image ( entry.vaddr, curTick (),
+                                entry.data.get (), entry.size );
+                    } else if ( pkt->getSize () != entry.size ) {
                         auto baseaddr = pkt->getBlockAddr ( _system->cacheLineSize() );
                         std::memcpy (
                                 entry.data.get (),
@@ -180,6 +343,12 @@ void DuetEngine::update () {
                                 entry.size
                                 );
                     }
+
+                    if ( _trace )
+                        _trace->record_mem ( curTick (), entry.chan_id,
+                                DuetFunctor::REQTYPE_LD, entry.vaddr,
+                                entry.req->getPaddr (), entry.size,
+                                curTick () - entry.issued, entry.data.get () );
                 }
 
                 port.resp_buf = nullptr;
@@ -195,10 +364,26 @@ void DuetEngine::update () {
     for ( auto & lane : _lanes )
         lane->push_phase ();
 
+    if ( _governor )
+        for ( auto & lane : _lanes )
+            if ( lane->has_work () )
+                _busy_lane_ticks += clockPeriod ();
+
     if ( nullptr == _sri_port.req_buf && _is_blocked ) {
         _is_blocked = false;
         _stats.blocktime += curCycle () - _blocked_from;
     }
+
+    _schedule_wcb_timeout ();
+
+    if ( _is_replaying ) {
+        if ( _trace->replay_pending () ) {
+            _schedule_replay ();
+        } else if ( !_is_replay_done && _is_drained () ) {
+            _is_replay_done = true;
+            exitSimLoop ( "Duet engine trace replay finished" );
+        }
+    }
 }
 
 void DuetEngine::exchange () {
@@ -215,10 +400,27 @@ bool DuetEngine::has_work () {
     if ( _sri_port.req_buf || _sri_port.resp_buf )
         return true;
 
+    // keep running if a recorded SRI access is due but not yet handled
+    if ( _is_replaying
+            && _trace->replay_pending ()
+            && _trace->replay_front ().tick <= curTick () )
+        return true;
+
     for ( auto & port : _mem_ports )
         if ( port.req_buf || port.resp_buf )
             return true;
 
+    // calls waiting for a slot to be loaded
+    if ( _num_pending_calls > 0 )
+        return true;
+
+    // buffered stores that are due to be flushed. Until then,
+    // `_e_wcb_timeout` wakes the engine up
+    for ( auto & wcb : _wcb )
+        if ( !wcb.empty () && ( _wcb_draining
+                    || curCycle () >= wcb.front ().allocated + _wcb_timeout ) )
+            return true;
+
     for ( auto & lane : _lanes )
         if ( lane->has_work () )
             return true;
@@ -330,6 +532,167 @@ bool DuetEngine::can_pull_from_chan (
     return false;
 }
 
+bool DuetEngine::_is_caller_eligible (
+        DuetFunctor::caller_id_t    caller_id
+        , bool                      can_bind
+        ) const
+{
+    if ( _arrivals [caller_id].empty () )
+        return false;
+    else if ( _is_bound [caller_id] )
+        return _bound_ready [caller_id] <= curCycle ();
+    else
+        return can_bind;
+}
+
+bool DuetEngine::_can_bind () const {
+    if ( _num_bound < _caller_slots )
+        return true;
+
+    // idle callers stay in their slots until someone else needs them
+    for ( DuetFunctor::caller_id_t i = 0; i < _num_callers; ++i )
+        if ( _is_bound [i] && _arrivals [i].empty () )
+            return true;
+
+    return false;
+}
+
+bool DuetEngine::_has_unbound_waiting () const {
+    for ( DuetFunctor::caller_id_t i = 0; i < _num_callers; ++i )
+        if ( !_is_bound [i] && !_arrivals [i].empty () )
+            return true;
+
+    return false;
+}
+
+void DuetEngine::_bind_caller (
+        DuetFunctor::caller_id_t    caller_id
+        )
+{
+    // evict an idle caller if there is no free slot
+    if ( _num_bound == _caller_slots ) {
+        for ( DuetFunctor::caller_id_t i = 0; i < _num_callers; ++i ) {
+            if ( _is_bound [i] && _arrivals [i].empty () ) {
+                _unbind_caller ( i );
+                break;
+            }
+        }
+    }
+
+    assert ( _num_bound < _caller_slots );
+
+    _is_bound [caller_id]       = true;
+    _bound_ready [caller_id]    = curCycle () + _slot_switch_latency;
+    _bound_grants [caller_id]   = 0;
+    ++_num_bound;
+    ++_stats.slotswitches;
+}
+
+void DuetEngine::_unbind_caller (
+        DuetFunctor::caller_id_t    caller_id
+        )
+{
+    _is_bound [caller_id] = false;
+    --_num_bound;
+}
+
+bool DuetEngine::schedule_caller (
+        DuetFunctor::caller_id_t  & caller_id
+        )
+{
+    if ( 0 == _num_pending_calls )
+        return false;
+
+    // scan callers in round-robin order so that ties are broken fairly
+    bool can_bind = _can_bind ();
+    bool found = false;
+    DuetFunctor::caller_id_t best = 0;
+
+    for ( DuetFunctor::caller_id_t i = 0; i < _num_callers; ++i ) {
+        auto c = ( _next_caller + i ) % _num_callers;
+
+        if ( !_is_caller_eligible ( c, can_bind ) )
+            continue;
+
+        if ( found ) {
+            switch ( _arbitration ) {
+            case DuetArbitration::Weighted:
+                if ( _wrr_credits [c] + _caller_weights [c]
+                        <= _wrr_credits [best] + _caller_weights [best] )
+                    continue;
+                break;
+
+            case DuetArbitration::OldestFirst:
+                if ( _arrivals [c].front () >= _arrivals [best].front () )
+                    continue;
+                break;
+
+            case DuetArbitration::Deadline:
+                if ( _arrivals [c].front () + _caller_deadlines [c]
+                        >= _arrivals [best].front () + _caller_deadlines [best] )
+                    continue;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        found = true;
+        best = c;
+
+        if ( DuetArbitration::RoundRobin == _arbitration )
+            break;
+    }
+
+    if ( !found )
+        return false;
+
+    _next_caller = ( best + 1 ) % _num_callers;
+
+    // load the caller into a free slot first
+    if ( !_is_bound [best] ) {
+        _bind_caller ( best );
+        if ( !_is_caller_eligible ( best, false ) )
+            return false;
+    }
+
+    // smooth weighted round-robin: every eligible caller earns its weight,
+    // and the chosen one pays the total
+    if ( DuetArbitration::Weighted == _arbitration ) {
+        int64_t total = 0;
+        for ( DuetFunctor::caller_id_t c = 0; c < _num_callers; ++c ) {
+            if ( _is_caller_eligible ( c, can_bind ) ) {
+                _wrr_credits [c] += _caller_weights [c];
+                total += _caller_weights [c];
+            }
+        }
+        _wrr_credits [best] -= total;
+    }
+
+    // start the call
+    Cycles wait = curCycle () - _arrivals [best].front ();
+    _arrivals [best].pop_front ();
+    --_num_pending_calls;
+
+    ++_stats.grants [best];
+    _stats.waitsamples [best].push_back ( wait );
+    if ( !_caller_deadlines.empty () && wait > _caller_deadlines [best] )
+        ++_stats.deadlinemisses [best];
+
+    // release the slot if the caller has used up its quantum while others
+    // are waiting for a slot
+    ++_bound_grants [best];
+    if ( _slot_quantum > 0
+            && _bound_grants [best] >= _slot_quantum
+            && !_arrivals [best].empty ()
+            && _has_unbound_waiting () )
+        _unbind_caller ( best );
+
+    caller_id = best;
+    return true;
+}
+
 void DuetEngine::stats_call_recvd (
         DuetFunctor::caller_id_t    caller_id
         )
@@ -410,8 +773,11 @@ bool DuetEngine::try_send_mem_req_one (
 
     // translate address
     Addr paddr;
-    panic_if ( !_process->pTable->translate ( req.addr, paddr ),
-            "Memory translation failed" );
+    if ( _is_replaying )
+        paddr = _trace->translate ( req.addr );
+    else
+        panic_if ( !_process->pTable->translate ( req.addr, paddr ),
+                "Memory translation failed" );
 
     // get the data channel in case we need it 
     auto & chan_data    = _chan_wdata_by_id [chan_id];
@@ -421,8 +787,13 @@ bool DuetEngine::try_send_mem_req_one (
     PacketPtr pkt = nullptr;
     switch ( req.type ) {
     case DuetFunctor::REQTYPE_LD:
+        // write buffered stores to the same lines first, from any channel
+        if ( 0 != _wcb_entries
+                && !_flush_wcb_range ( req.addr, req.size, *port, *rob ) )
+            return false;
+
         if ( _writeclean ) {
-            gem5req = std::make_shared <Request> (
+            gem5req = makeRequest (
                     paddr & ~(Addr(_system->cacheLineSize()-1)),
                     _system->cacheLineSize (),
                     Request::ARCH_BITS & (Request::FlagsType) chan_id,
@@ -430,7 +801,7 @@ bool DuetEngine::try_send_mem_req_one (
                     );
             pkt = new Packet ( gem5req, MemCmd::ReadExReq );
         } else {
-            gem5req = std::make_shared <Request> (
+            gem5req = makeRequest (
                     paddr,
                     req.size,
                     Request::ARCH_BITS & (Request::FlagsType) chan_id,
@@ -445,7 +816,51 @@ bool DuetEngine::try_send_mem_req_one (
         if ( chan_data->empty () )  // data not ready
             return false;
 
-        gem5req = std::make_shared <Request> (
+        if ( 0 != _wcb_entries
+                && ( _wcb_draining
+                    || ( req.addr & (_system->cacheLineSize()-1) ) + req.size
+                        > _system->cacheLineSize () ) )
+        {
+            // stores bypass the buffer while draining, and if they cross a
+            // line boundary. They must not overtake older buffered stores to
+            // the same bytes, so those are written first
+            if ( !_flush_wcb_range ( req.addr, req.size, *port, *rob ) )
+                return false;
+        } else if ( 0 != _wcb_entries ) {
+            // make room if the store needs a new entry
+            auto & wcb = _wcb [chan_id];
+            if ( wcb.end () == _find_wcb ( chan_id, req.addr )
+                    && wcb.size () >= _wcb_entries )
+            {
+                _flush_wcb_run ( chan_id, wcb.begin (), *port, *rob );
+                return false;
+            }
+
+            _combine_store ( chan_id, req.addr,
+                    paddr & ~(Addr(_system->cacheLineSize()-1)), req.size,
+                    chan_data->front().get() );
+
+            if ( _is_replaying )
+                _trace->write_image ( req.addr, curTick (),
+                        chan_data->front().get(), req.size );
+            else if ( _trace )
+                _trace->record_mem ( curTick (), chan_id, req.type,
+                        req.addr, paddr, req.size, 0,
+                        chan_data->front().get() );
+
+            DPRINTF ( DuetEngine, "Combine ST %#x (%u bytes) @CHAN %u\n",
+                    req.addr, req.size, chan_id );
+
+            // the store is acknowledged once buffered
+            rob->emplace_back ( chan_id, nullptr, req.size, req.addr,
+                    curTick (), ROBEntry::RESPONDED );
+            chan_data->pop_front ();
+            chan_req->pop_front ();
+            ++_reservations_by_id[chan_id];
+            return true;
+        }
+
+        gem5req = makeRequest (
                 paddr,
                 req.size,
                 Request::ARCH_BITS & (Request::FlagsType) chan_id,
@@ -457,6 +872,14 @@ bool DuetEngine::try_send_mem_req_one (
             pkt = new Packet ( gem5req, Packet::makeWriteCmd ( gem5req ) );
         pkt->allocate ();
         pkt->setData ( chan_data->front().get() );
+
+        if ( _is_replaying )
+            _trace->write_image ( req.addr, curTick (),
+                    chan_data->front().get(), req.size );
+        else if ( _trace )
+            _trace->record_mem ( curTick (), chan_id, req.type, req.addr,
+                    paddr, req.size, 0, chan_data->front().get() );
+
         chan_data->pop_front ();
         break;
 
@@ -479,6 +902,28 @@ bool DuetEngine::try_send_mem_req_one (
 
 #undef _TMP_UNSUPPORTED_REQ_TYPE
 
+    case DuetFunctor::REQTYPE_FENCE:
+        // drain the write-combining buffer first
+        if ( !_wcb [chan_id].empty () ) {
+            _flush_wcb_run ( chan_id, _wcb [chan_id].begin (), *port, *rob );
+            return false;
+        }
+
+        // the fence is acknowledged after all preceding requests of the
+        // channel have completed, including those sent to other memory ports
+        for ( auto & r : _rob )
+            for ( auto & entry : r )
+                if ( chan_id == entry.chan_id
+                        && ( entry.token || ROBEntry::SENT == entry.status ) )
+                    return false;
+
+        DPRINTF ( DuetEngine, "FENCE @CHAN %u\n", chan_id );
+        rob->emplace_back ( chan_id, nullptr, 0, req.addr,
+                curTick (), ROBEntry::RESPONDED );
+        chan_req->pop_front ();
+        ++_reservations_by_id[chan_id];
+        return true;
+
     default :
         panic ( "Invalid request type" );
     }
@@ -489,7 +934,7 @@ bool DuetEngine::try_send_mem_req_one (
             pkt->print (), chan_id );
 
     // register in reorder buffer
-    rob->emplace_back ( chan_id, pkt, req.size,
+    rob->emplace_back ( chan_id, pkt->req, req.size, req.addr, curTick (),
             pkt->cmd.needsResponse () ? ROBEntry::SENT
             : ROBEntry::RESPONDED );
 
@@ -512,6 +957,14 @@ bool DuetEngine::handle_argchan_push (
         DuetFunctor::raw_data_t raw ( new uint8_t[8] );
         memcpy ( raw.get(), &value, 8 );
         chan->push_back ( raw );
+
+        // the first argument of a call marks its arrival
+        if ( 0 == _arg_words [caller_id]++ ) {
+            _arrivals [caller_id].push_back ( curCycle () );
+            ++_num_pending_calls;
+        }
+        _arg_words [caller_id] %= get_num_args_per_call ();
+
         return true;
     } else {
         return false;
@@ -586,6 +1039,7 @@ void DuetEngine::init () {
         _chan_int_by_id.emplace_back   ( new DuetFunctor::chan_data_t () );
 
     _rob.resize ( _mem_ports.size() );
+    _wcb.resize ( get_num_memory_chans () );
 
     _is_blocked     = false;
     _blocked_from   = Cycles (0);
@@ -593,6 +1047,290 @@ void DuetEngine::init () {
     _busy_from      = Cycles (0);
     _received.resize ( get_num_callers () );
     _started.resize ( get_num_callers () );
+
+    _arrivals.resize ( get_num_callers () );
+    _arg_words.resize ( get_num_callers (), 0 );
+    _wrr_credits.resize ( get_num_callers (), 0 );
+    _is_bound.resize ( get_num_callers (), false );
+    _bound_ready.resize ( get_num_callers (), Cycles (0) );
+    _bound_grants.resize ( get_num_callers (), 0 );
+}
+
+std::list <DuetEngine::WCBEntry>::iterator DuetEngine::_find_wcb (
+        uint16_t                    chan_id
+        , Addr                      vaddr
+        )
+{
+    auto line = vaddr & ~(Addr(_system->cacheLineSize()-1));
+    auto & wcb = _wcb [chan_id];
+
+    for ( auto it = wcb.begin (); wcb.end () != it; ++it )
+        if ( it->vaddr == line )
+            return it;
+
+    return wcb.end ();
+}
+
+void DuetEngine::_combine_store (
+        uint16_t                    chan_id
+        , Addr                      vaddr
+        , Addr                      paddr
+        , unsigned                  size
+        , const uint8_t           * data
+        )
+{
+    unsigned line_size = _system->cacheLineSize ();
+    auto line = vaddr & ~(Addr(line_size-1));
+    unsigned offset = vaddr - line;
+    assert ( offset + size <= line_size );
+
+    auto & wcb = _wcb [chan_id];
+    auto it = _find_wcb ( chan_id, vaddr );
+    if ( wcb.end () == it ) {
+        assert ( wcb.size () < _wcb_entries );
+        it = wcb.emplace ( wcb.end (), line, paddr, line_size, curCycle () );
+    }
+
+    std::memcpy ( it->data.data () + offset, data, size );
+    std::fill ( it->mask.begin () + offset,
+            it->mask.begin () + offset + size, true );
+
+    ++_stats.combinedstores;
+}
+
+void DuetEngine::_flush_wcb_run (
+        uint16_t                    chan_id
+        , std::list <WCBEntry>::iterator    entry
+        , MemoryPort              & port
+        , std::list <ROBEntry>    & rob
+        )
+{
+    assert ( nullptr == port.req_buf );
+
+    unsigned line_size = _system->cacheLineSize ();
+    unsigned begin = 0;
+    while ( begin < line_size && !entry->mask [begin] )
+        ++begin;
+    assert ( begin < line_size );
+
+    unsigned end = begin;
+    while ( end < line_size && entry->mask [end] )
+        ++end;
+
+    auto gem5req = makeRequest (
+            entry->paddr + begin,
+            end - begin,
+            Request::ARCH_BITS & (Request::FlagsType) chan_id,
+            _requestorId
+            );
+
+    PacketPtr pkt = nullptr;
+    if ( _writeclean )
+        pkt = new Packet ( gem5req, MemCmd::WriteClean );
+    else
+        pkt = new Packet ( gem5req, Packet::makeWriteCmd ( gem5req ) );
+    pkt->allocate ();
+    pkt->setData ( entry->data.data () + begin );
+
+    port.req_buf = pkt;
+    DPRINTF ( DuetEngine, "Flush WCB %s @CHAN %u\n", pkt->print (), chan_id );
+
+    rob.emplace_back ( chan_id, gem5req, end - begin, entry->vaddr + begin,
+            curTick (),
+            pkt->cmd.needsResponse () ? ROBEntry::SENT : ROBEntry::RESPONDED,
+            false );
+
+    ++_stats.combinedwrites;
+    _stats.combinedbytes += end - begin;
+
+    std::fill ( entry->mask.begin () + begin, entry->mask.begin () + end,
+            false );
+    if ( std::find ( entry->mask.begin (), entry->mask.end (), true )
+            == entry->mask.end () )
+        _wcb [chan_id].erase ( entry );
+}
+
+void DuetEngine::_flush_wcb_timeout () {
+    auto port = _mem_ports.begin ();
+    auto rob = _rob.begin ();
+
+    for ( uint16_t chan_id = 0; chan_id < _wcb.size (); ++chan_id ) {
+        auto & wcb = _wcb [chan_id];
+
+        // entries are allocated in order, so only the oldest may time out
+        while ( !wcb.empty ()
+                && ( _wcb_draining
+                    || curCycle () >= wcb.front ().allocated + _wcb_timeout ) )
+        {
+            for ( ; _mem_ports.end () != port; ++port, ++rob )
+                if ( nullptr == port->req_buf )
+                    break;
+            if ( _mem_ports.end () == port )
+                return;
+
+            _flush_wcb_run ( chan_id, wcb.begin (), *port, *rob );
+        }
+    }
+}
+
+void DuetEngine::_schedule_wcb_timeout () {
+    // entries are allocated in order, so the oldest one of a buffer times
+    // out first
+    bool buffered = false;
+    Cycles due;
+    for ( auto & wcb : _wcb ) {
+        if ( wcb.empty () )
+            continue;
+
+        Cycles timeout = wcb.front ().allocated + _wcb_timeout;
+        if ( !buffered || timeout < due )
+            due = timeout;
+        buffered = true;
+    }
+
+    // if an entry is already due, `has_work` keeps the engine running
+    if ( !buffered || due <= curCycle () )
+        return;
+
+    Tick when = clockEdge ( Cycles ( due - curCycle () ) );
+    if ( !_e_wcb_timeout.scheduled () || _e_wcb_timeout.when () != when )
+        reschedule ( _e_wcb_timeout, when, true );
+}
+
+bool DuetEngine::_flush_wcb_range (
+        Addr                        vaddr
+        , unsigned                  size
+        , MemoryPort              & port
+        , std::list <ROBEntry>    & rob
+        )
+{
+    auto mask = ~(Addr(_system->cacheLineSize()-1));
+    Addr first = vaddr & mask;
+    Addr last = ( vaddr + std::max ( size, 1u ) - 1 ) & mask;
+
+    for ( uint16_t chan_id = 0; chan_id < _wcb.size (); ++chan_id ) {
+        for ( Addr line = first; line <= last;
+                line += _system->cacheLineSize () )
+        {
+            auto it = _find_wcb ( chan_id, line );
+            if ( _wcb [chan_id].end () != it ) {
+                _flush_wcb_run ( chan_id, it, port, rob );
+                return false;
+            }
+        }
+    }
+
+    // flushed writes may still be in flight on any memory port
+    for ( auto & r : _rob )
+        for ( auto & entry : r )
+            if ( !entry.token
+                    && ROBEntry::SENT == entry.status
+                    && ( entry.vaddr & mask ) >= first
+                    && ( entry.vaddr & mask ) <= last )
+                return false;
+
+    return true;
+}
+
+bool DuetEngine::drain_wcb () {
+    if ( 0 == _wcb_entries )
+        return true;
+
+    _wcb_draining = true;
+
+    for ( auto & wcb : _wcb )
+        if ( !wcb.empty () )
+            return false;
+
+    for ( auto & rob : _rob )
+        for ( auto & entry : rob )
+            if ( !entry.token && ROBEntry::SENT == entry.status )
+                return false;
+
+    _wcb_draining = false;
+    return true;
+}
+
+void DuetEngine::startup () {
+    ClockedObject::startup ();
+
+    if ( _is_replaying ) {
+        _trace->start_replay ( curTick () );
+        _schedule_replay ();
+    }
+}
+
+bool DuetEngine::_replay_softreg ( bool is_write ) {
+    if ( !_trace->replay_pending () )
+        return false;
+
+    auto access = _trace->replay_front ();
+    if ( access.is_write != is_write || access.tick > curTick () )
+        return false;
+
+    bool handled;
+    if ( is_write ) {
+        handled = handle_softreg_write ( access.softreg_id, access.value );
+    } else if ( DuetFunctor::RETCODE_RUNNING == access.value ) {
+        // the host polled and found nothing, which has no effect
+        handled = true;
+    } else {
+        uint64_t value;
+        handled = handle_softreg_read ( access.softreg_id, value );
+
+        if ( handled && DuetFunctor::RETCODE_RUNNING == value ) {
+            // the recorded value is not ready yet, poll again next cycle
+            handled = false;
+        } else if ( handled && value != access.value ) {
+            warn ( "%s: replayed read of softreg %u returned %#x, but %#x "
+                    "was recorded; the replay is out of sync\n", name (),
+                    access.softreg_id, value, access.value );
+        }
+    }
+
+    if ( handled ) {
+        DPRINTF ( DuetEngine, "Replay %s softreg %u\n",
+                is_write ? "write" : "read", access.softreg_id );
+        _trace->replay_pop ();
+    }
+
+    return handled;
+}
+
+void DuetEngine::_schedule_replay () {
+    if ( !_trace->replay_pending () || _e_replay.scheduled () )
+        return;
+
+    // if the access is already due, `has_work` keeps the engine running
+    Tick when = _trace->replay_front ().tick;
+    if ( when > curTick () )
+        schedule ( _e_replay, when );
+    else if ( is_sleeping () )
+        wakeup ();
+}
+
+void DuetEngine::_timer_wakeup () {
+    if ( is_sleeping () )
+        wakeup ();
+}
+
+bool DuetEngine::_is_drained () {
+    if ( has_work () )
+        return false;
+
+    for ( auto & wcb : _wcb )
+        if ( !wcb.empty () )
+            return false;
+
+    for ( auto & rob : _rob )
+        if ( !rob.empty () )
+            return false;
+
+    for ( auto & chan : _chan_arg_by_id )
+        if ( !chan->empty () )
+            return false;
+
+    return true;
 }
 
 unsigned int DuetEngine::cacheLineSize () const {
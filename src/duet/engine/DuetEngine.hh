@@ -6,8 +6,10 @@
 #include <utility>
 #include <map>
 #include <list>
+#include <deque>
 
 #include "params/DuetEngine.hh"
+#include "enums/DuetArbitration.hh"
 #include "duet/DuetClockedObject.hh"
 #include "duet/engine/DuetFunctor.hh"
 #include "mem/request.hh"
@@ -23,6 +25,8 @@ class Process;
 namespace duet {
 
 class DuetLane;
+class DuetEngineTrace;
+class DuetDVFSGovernor;
 class DuetEngine : public DuetClockedObject {
 // ===========================================================================
 // == Type Definitions =======================================================
@@ -72,19 +76,51 @@ private:
         uint8_t                             size;
         Tick                                readyAfter;
         DuetFunctor::raw_data_t             data;
+        Addr                                vaddr;
+        Tick                                issued;
+        bool                                token;  // false if nothing is
+                                                    // returned to the lanes
 
         ROBEntry (
                 DuetFunctor::caller_id_t    chan_id
-                , PacketPtr                 pkt
+                , RequestPtr                req
                 , uint8_t                   size
+                , Addr                      vaddr
+                , Tick                      issued
                 , decltype ( status )       status = UNSENT
+                , bool                      token = true
                 )
             : chan_id       ( chan_id )
             , status        ( status )
-            , req           ( pkt->req ) 
+            , req           ( req ) 
             , size          ( size )
             , readyAfter    ( 0 )
             , data          ( nullptr )
+            , vaddr         ( vaddr )
+            , issued        ( issued )
+            , token         ( token )
+        {}
+    };
+
+    /* Write-Combining Buffer Entry: stores to one cache line */
+    struct WCBEntry {
+        Addr                                vaddr;  // line-aligned
+        Addr                                paddr;  // line-aligned
+        std::vector <uint8_t>               data;
+        std::vector <bool>                  mask;   // valid bytes
+        Cycles                              allocated;
+
+        WCBEntry (
+                Addr                        vaddr
+                , Addr                      paddr
+                , unsigned                  line_size
+                , Cycles                    allocated
+                )
+            : vaddr         ( vaddr )
+            , paddr         ( paddr )
+            , data          ( line_size, 0 )
+            , mask          ( line_size, false )
+            , allocated     ( allocated )
         {}
     };
 
@@ -105,10 +141,29 @@ private:
         // execution time (#cycles)
         statistics::Distribution    exectime;
 
+        // write-combining buffer
+        statistics::Scalar          combinedstores;
+        statistics::Scalar          combinedwrites;
+        statistics::Scalar          combinedbytes;
+        statistics::Formula         combineratio;
+
+        // caller scheduling
+        statistics::Vector          grants;
+        statistics::Vector          deadlinemisses;
+        statistics::Scalar          slotswitches;
+        statistics::Vector          waitp50;
+        statistics::Vector          waitp90;
+        statistics::Vector          waitp99;
+
+        //  waiting time (#cycles) of each started call, per caller
+        std::vector <std::vector <Cycles>>  waitsamples;
+
         // -- Methods --------------------------------------------------------
         Stats ( DuetEngine & engine );
 
         void regStats () override;
+        void resetStats () override;
+        void preDumpStats () override;
     };
 
 public:
@@ -126,9 +181,22 @@ private:
     std::vector <DuetLane*>                     _lanes;
     SRIPort                                     _sri_port;
     bool                                        _writeclean;
+    unsigned                                    _wcb_entries;
+    Cycles                                      _wcb_timeout;
+    DuetDVFSGovernor                          * _governor;
+    DuetArbitration                             _arbitration;
+    std::vector <unsigned>                      _caller_weights;
+    std::vector <Cycles>                        _caller_deadlines;
+    DuetFunctor::caller_id_t                    _caller_slots;
+    unsigned                                    _slot_quantum;
+    Cycles                                      _slot_switch_latency;
     Stats                                       _stats;
     std::vector <MemoryPort>                    _mem_ports;
 
+    //  record/replay SRI and memory accesses (nullptr if neither)
+    std::unique_ptr <DuetEngineTrace>           _trace;
+    bool                                        _is_replaying;
+
 // ===========================================================================
 // == Non-Parameterized Member Variables =====================================
 // ===========================================================================
@@ -150,6 +218,27 @@ private:
     // -- Reorder Buffer for Memory Responses --------------------------------
     std::vector <std::list <ROBEntry>>  _rob;   // one ROB per memory port
 
+    // -- Write-Combining Buffers --------------------------------------------
+    std::vector <std::list <WCBEntry>>  _wcb;   // one WCB per memory channel
+
+    //  set when a call waits for the buffered stores to reach memory. No new
+    //  entries are allocated until all buffers are empty
+    bool                                _wcb_draining;
+
+    // -- Caller Scheduling --------------------------------------------------
+    //  arrival time of each call that has not been started yet
+    std::vector <std::deque <Cycles>>   _arrivals;
+    std::vector <unsigned>              _arg_words;     // of the last call
+    unsigned                            _num_pending_calls;
+    DuetFunctor::caller_id_t            _next_caller;   // round-robin pointer
+    std::vector <int64_t>               _wrr_credits;
+
+    //  callers are virtual contexts bound to physical slots on demand
+    std::vector <bool>                  _is_bound;
+    std::vector <Cycles>                _bound_ready;   // context loaded
+    std::vector <unsigned>              _bound_grants;  // calls since bound
+    DuetFunctor::caller_id_t            _num_bound;
+
     // -- Constant registers -------------------------------------------------
     std::map <std::string, uint64_t>    _constants;
     std::vector <std::unique_ptr <std::map <std::string, uint64_t>>>
@@ -166,6 +255,99 @@ private:
     std::vector <std::list <Cycles>>    _received;
     std::vector <std::list <Cycles>>    _started;
 
+    // for the DVFS governor
+    Counter                             _awake_cycles;
+    Tick                                _busy_lane_ticks;
+
+    // wakes the engine up when the oldest buffered store times out
+    EventFunctionWrapper                _e_wcb_timeout;
+
+    // for trace replay
+    EventFunctionWrapper                _e_replay;
+    bool                                _is_replay_done;
+
+// ===========================================================================
+// == Write Combining ========================================================
+// ===========================================================================
+private:
+    /* merge a store, which must fit in one cache line, into the
+     * write-combining buffer of the channel */
+    void _combine_store (
+            uint16_t                    chan_id
+            , Addr                      vaddr
+            , Addr                      paddr
+            , unsigned                  size
+            , const uint8_t           * data
+            );
+
+    /* send the first run of contiguous valid bytes in a WCB entry */
+    void _flush_wcb_run (
+            uint16_t                    chan_id
+            , std::list <WCBEntry>::iterator    entry
+            , MemoryPort              & port
+            , std::list <ROBEntry>    & rob
+            );
+
+    /* flush WCB entries that timed out, or all entries while draining, one
+     * run per free memory port */
+    void _flush_wcb_timeout ();
+
+    /* wake up the engine when the oldest WCB entry times out, so that it
+     * does not run every cycle while stores are buffered */
+    void _schedule_wcb_timeout ();
+
+    /* flush the stores buffered for the lines overlapping the given bytes
+     * in any channel. Return true once none of them is buffered or being
+     * written */
+    bool _flush_wcb_range (
+            Addr                        vaddr
+            , unsigned                  size
+            , MemoryPort              & port
+            , std::list <ROBEntry>    & rob
+            );
+
+    /* find the WCB entry holding the line of the given address */
+    std::list <WCBEntry>::iterator _find_wcb (
+            uint16_t                    chan_id
+            , Addr                      vaddr
+            );
+
+// ===========================================================================
+// == Caller Scheduling ======================================================
+// ===========================================================================
+private:
+    /* check if a call of the caller can be started now. `can_bind` tells
+     * if an unbound caller can get a slot */
+    bool _is_caller_eligible (
+            DuetFunctor::caller_id_t    caller_id
+            , bool                      can_bind
+            ) const;
+
+    /* check if a slot is free or held by an idle caller */
+    bool _can_bind () const;
+
+    /* check if any unbound caller is waiting for a slot */
+    bool _has_unbound_waiting () const;
+
+    void _bind_caller   ( DuetFunctor::caller_id_t caller_id );
+    void _unbind_caller ( DuetFunctor::caller_id_t caller_id );
+
+// ===========================================================================
+// == Trace Replay ===========================================================
+// ===========================================================================
+private:
+    /* replay the next recorded SRI access if it is due. A recorded read
+     * waits until the engine returns a value, and warns if the value is not
+     * the recorded one. Return true if the access is handled */
+    bool _replay_softreg ( bool is_write );
+
+    /* wake up the engine when the next recorded SRI access is due */
+    void _schedule_replay ();
+    void _timer_wakeup ();
+
+    /* check if all work, including buffered calls, has been finished */
+    bool _is_drained ();
+
 // ===========================================================================
 // == Implementing Virtual Methods ===========================================
 // ===========================================================================
@@ -196,6 +378,32 @@ public:
 
     DuetFunctor::caller_id_t get_num_callers () const { return _num_callers; }
 
+    /* start draining the write-combining buffers. Return true once all
+     * buffered stores have been written to memory, i.e. a call may complete
+     * and its results may be observed by the host. Lanes call this only when
+     * a call completes, since draining stops combining until it finishes */
+    bool drain_wcb ();
+
+    /* choose the caller whose next call starts now, according to the
+     * arbitration policy. Return false if no call can be started */
+    bool schedule_caller ( DuetFunctor::caller_id_t & caller_id );
+
+// ===========================================================================
+// == API for DuetDVFSGovernor ===============================================
+// ===========================================================================
+public:
+    /* number of calls that have arrived but not been started yet */
+    unsigned get_num_pending_calls () const { return _num_pending_calls; }
+
+    size_t  get_num_lanes ()        const { return _lanes.size (); }
+    Counter get_awake_cycles ()     const { return _awake_cycles; }
+    Tick    get_busy_lane_ticks ()  const { return _busy_lane_ticks; }
+
+// ===========================================================================
+// == API for DuetLane (cont.) ===============================================
+// ===========================================================================
+public:
+
     template <typename T>
     T get_constant (
             DuetFunctor::caller_id_t    caller_id
@@ -280,6 +488,7 @@ protected:
     virtual DuetFunctor::caller_id_t get_num_interlane_chans () const { return 0; }
     virtual unsigned                 get_max_stats_waittime ()  const { return 2000; }
     virtual unsigned                 get_max_stats_exectime ()  const { return 1000; }
+    virtual unsigned                 get_num_args_per_call ()   const { return 1; }
 
     virtual bool handle_softreg_write (
             softreg_id_t    softreg_id
@@ -298,9 +507,11 @@ protected:
 // ===========================================================================
 public:
     DuetEngine ( const DuetEngineParams & p );
+    ~DuetEngine ();
     Port & getPort ( const std::string & if_name
             , PortID idx = InvalidPortID ) override;
     virtual void init () override;
+    virtual void startup () override;
     unsigned int cacheLineSize () const;
 };
 
@@ -2,6 +2,10 @@ from m5.params import *
 from m5.proxy import *
 from m5.objects import *
 from m5.objects.DuetClockedObject import DuetClockedObject
+from m5.objects.DuetDVFSGovernor import DuetDVFSGovernor
+
+class DuetArbitration (ScopedEnum):
+    vals = [ 'RoundRobin', 'Weighted', 'OldestFirst', 'Deadline' ]
 
 class DuetEngine (DuetClockedObject):
     type                = "DuetEngine"
@@ -10,7 +14,8 @@ class DuetEngine (DuetClockedObject):
     abstract            = True
 
     system              = Param.System ( Parent.any, "System object" )
-    process             = Param.Process ( "Process running on the host processors" )
+    process             = Param.Process ( NULL, "Process running on the host processors"
+                                        " (not needed when replaying a trace)" )
     fifo_capacity       = Param.Unsigned ( 1024, "FIFO capacity" )
     num_callers         = Param.Unsigned ( 64, "Max. number of callers" )
     baseaddr            = Param.Addr ( "Base address of softreg space" )
@@ -18,3 +23,22 @@ class DuetEngine (DuetClockedObject):
     sri_port            = ResponsePort ( "SRI response port" )
     mem_ports           = VectorRequestPort ( "Memory ports" )
     writeclean          = Param.Bool ( False, "Use WriteClean instead of WriteReq" )
+    wcb_entries         = Param.Unsigned ( 0, "Write-combining buffer entries per memory"
+                                        " channel (0 disables write combining)" )
+    wcb_timeout         = Param.Cycles ( 64, "Flush a write-combining buffer entry this many"
+                                        " cycles after it is allocated" )
+    arbitration         = Param.DuetArbitration ( 'RoundRobin', "Policy for choosing the"
+                                        " caller whose next call starts" )
+    caller_weights      = VectorParam.Unsigned ( [], "Per-caller weights for weighted"
+                                        " arbitration (default 1)" )
+    caller_deadlines    = VectorParam.Cycles ( [], "Per-caller waiting time targets for"
+                                        " deadline arbitration" )
+    caller_slots        = Param.Unsigned ( 0, "Physical slots shared by the callers"
+                                        " (0: one per caller)" )
+    slot_quantum        = Param.Unsigned ( 16, "Release a slot after this many calls if"
+                                        " other callers are waiting (0: never)" )
+    slot_switch_latency = Param.Cycles ( 0, "Latency of loading a caller into a slot" )
+    governor            = Param.DuetDVFSGovernor ( NULL, "DVFS governor for the engine clock domain" )
+    trace_record        = Param.String ( "", "Record SRI and memory accesses into this trace"
+                                        " (prefixed with the engine name, in the output directory)" )
+    trace_replay        = Param.String ( "", "Drive the engine from this trace instead of the SRI port" )
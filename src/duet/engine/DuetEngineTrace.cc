@@ -0,0 +1,291 @@
+#include "duet/engine/DuetEngineTrace.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "config/have_protobuf.hh"
+#include "sim/core.hh"
+
+#if HAVE_PROTOBUF
+#include "duet/engine/DuetTrace.pb.h"
+#include "proto/protoio.hh"
+#endif
+
+namespace gem5 {
+namespace duet {
+
+DuetEngineTrace::DuetEngineTrace ( const std::string & name )
+    : _name             ( name )
+    , _ostream          ( nullptr )
+    , _has_last_read    ( false )
+    , _last_read        ()
+    , _recorded_start   ( 0 )
+    , _replay_start     ( 0 )
+{}
+
+DuetEngineTrace::~DuetEngineTrace () {
+    stop_recording ();
+}
+
+#if HAVE_PROTOBUF
+
+void DuetEngineTrace::start_recording (
+        const std::string &     filename
+        , unsigned              num_callers
+        , unsigned              cache_line_size
+        )
+{
+    panic_if ( is_recording (), "%s: already recording", name () );
+
+    _ostream = new ProtoOutputStream ( filename );
+
+    ProtoMessage::DuetTraceHeader header;
+    header.set_obj_id ( name () );
+    header.set_tick_freq ( sim_clock::Frequency );
+    header.set_num_callers ( num_callers );
+    header.set_cache_line_size ( cache_line_size );
+    _ostream->write ( header );
+}
+
+void DuetEngineTrace::stop_recording () {
+    delete _ostream;
+    _ostream = nullptr;
+}
+
+void DuetEngineTrace::record_softreg (
+        Tick                    tick
+        , bool                  is_write
+        , uint32_t              softreg_id
+        , uint64_t              value
+        )
+{
+    if ( !is_recording () )
+        return;
+
+    if ( !is_write ) {
+        if ( _has_last_read
+                && _last_read.softreg_id == softreg_id
+                && _last_read.value == value )
+            return;
+
+        _has_last_read  = true;
+        _last_read      = { tick, is_write, softreg_id, value };
+    } else {
+        _has_last_read  = false;
+    }
+
+    ProtoMessage::DuetTraceRecord rec;
+    rec.set_type ( is_write ? ProtoMessage::DuetTraceRecord::SOFTREG_WRITE
+            : ProtoMessage::DuetTraceRecord::SOFTREG_READ );
+    rec.set_tick ( tick );
+    rec.set_softreg_id ( softreg_id );
+    rec.set_value ( value );
+    _ostream->write ( rec );
+}
+
+void DuetEngineTrace::record_mem (
+        Tick                    tick
+        , uint16_t              chan_id
+        , uint8_t               req_type
+        , Addr                  vaddr
+        , Addr                  paddr
+        , unsigned              size
+        , Tick                  latency
+        , const uint8_t       * data
+        )
+{
+    if ( !is_recording () )
+        return;
+
+    ProtoMessage::DuetTraceRecord rec;
+    rec.set_type ( ProtoMessage::DuetTraceRecord::MEM_ACCESS );
+    rec.set_tick ( tick );
+    rec.set_chan_id ( chan_id );
+    rec.set_req_type ( req_type );
+    rec.set_vaddr ( vaddr );
+    rec.set_paddr ( paddr );
+    rec.set_size ( size );
+    rec.set_latency ( latency );
+
+    // only record data that we have not seen at this address yet
+    if ( nullptr != data ) {
+        auto & last = _last_data [vaddr];
+        if ( last.size () != size
+                || 0 != std::memcmp ( last.data (), data, size ) )
+        {
+            last.assign ( data, data + size );
+            rec.set_data ( data, size );
+        }
+    }
+
+    _ostream->write ( rec );
+}
+
+void DuetEngineTrace::load_replay (
+        const std::string &     filename
+        , unsigned              num_callers
+        , unsigned              cache_line_size
+        )
+{
+    ProtoInputStream istream ( filename );
+
+    ProtoMessage::DuetTraceHeader header;
+    fatal_if ( !istream.read ( header ),
+            "%s: failed to read header from trace %s", name (), filename );
+    fatal_if ( header.tick_freq () != sim_clock::Frequency,
+            "%s: trace %s was recorded with tick frequency %d, but the "
+            "current tick frequency is %d", name (), filename,
+            header.tick_freq (), sim_clock::Frequency );
+    fatal_if ( header.num_callers () != num_callers,
+            "%s: trace %s was recorded with %d callers, but the engine is "
+            "configured with %d", name (), filename,
+            header.num_callers (), num_callers );
+    fatal_if ( header.cache_line_size () != cache_line_size,
+            "%s: trace %s was recorded with %dB cache lines, but the system "
+            "is configured with %dB", name (), filename,
+            header.cache_line_size (), cache_line_size );
+
+    bool has_start = false;
+    ProtoMessage::DuetTraceRecord rec;
+    while ( istream.read ( rec ) ) {
+        if ( !has_start ) {
+            has_start       = true;
+            _recorded_start = rec.tick ();
+        }
+
+        switch ( rec.type () ) {
+        case ProtoMessage::DuetTraceRecord::SOFTREG_READ:
+        case ProtoMessage::DuetTraceRecord::SOFTREG_WRITE:
+            _softregs.push_back ( {
+                    rec.tick (),
+                    ProtoMessage::DuetTraceRecord::SOFTREG_WRITE == rec.type (),
+                    rec.softreg_id (),
+                    rec.value ()
+                    } );
+            break;
+
+        case ProtoMessage::DuetTraceRecord::MEM_ACCESS:
+            _pages [rec.vaddr () >> page_shift] = rec.paddr () >> page_shift;
+
+            if ( rec.has_data () ) {
+                auto & versions = _image [rec.vaddr ()];
+                auto & data = rec.data ();
+                versions.push_back ( {
+                        rec.tick (),
+                        std::vector <uint8_t> ( data.begin (), data.end () )
+                        } );
+            }
+            break;
+
+        default:
+            panic ( "%s: invalid record type in trace %s", name (), filename );
+        }
+    }
+}
+
+#else
+
+void DuetEngineTrace::start_recording (
+        const std::string &     filename
+        , unsigned              num_callers
+        , unsigned              cache_line_size
+        )
+{
+    fatal ( "%s: Duet engine traces require protobuf support", name () );
+}
+
+void DuetEngineTrace::stop_recording () {}
+
+void DuetEngineTrace::record_softreg (
+        Tick                    tick
+        , bool                  is_write
+        , uint32_t              softreg_id
+        , uint64_t              value
+        )
+{}
+
+void DuetEngineTrace::record_mem (
+        Tick                    tick
+        , uint16_t              chan_id
+        , uint8_t               req_type
+        , Addr                  vaddr
+        , Addr                  paddr
+        , unsigned              size
+        , Tick                  latency
+        , const uint8_t       * data
+        )
+{}
+
+void DuetEngineTrace::load_replay (
+        const std::string &     filename
+        , unsigned              num_callers
+        , unsigned              cache_line_size
+        )
+{
+    fatal ( "%s: Duet engine traces require protobuf support", name () );
+}
+
+#endif  /* #if HAVE_PROTOBUF */
+
+void DuetEngineTrace::start_replay ( Tick tick ) {
+    _replay_start = tick;
+}
+
+DuetEngineTrace::SoftregAccess DuetEngineTrace::replay_front () const {
+    auto access = _softregs.front ();
+    access.tick = access.tick - _recorded_start + _replay_start;
+    return access;
+}
+
+Addr DuetEngineTrace::translate ( Addr vaddr ) const {
+    auto it = _pages.find ( vaddr >> page_shift );
+    panic_if ( _pages.end () == it,
+            "%s: no recorded translation for address %#x", name (), vaddr );
+
+    Addr mask = ( Addr(1) << page_shift ) - 1;
+    return ( it->second << page_shift ) | ( vaddr & mask );
+}
+
+void DuetEngineTrace::read_image (
+        Addr                    vaddr
+        , Tick                  tick
+        , uint8_t             * data
+        , unsigned              size
+        ) const
+{
+    auto it = _image.find ( vaddr );
+    panic_if ( _image.end () == it,
+            "%s: no recorded data for address %#x", name (), vaddr );
+
+    // use the latest version recorded no later than now. If there is none,
+    // the data has not changed since the first time it was recorded
+    auto & versions = it->second;
+    Tick now = to_recorded_tick ( tick );
+    auto jt = std::upper_bound ( versions.begin (), versions.end (), now,
+            [] ( Tick t, const MemVersion & v ) { return t < v.tick; } );
+    if ( versions.begin () != jt )
+        --jt;
+
+    panic_if ( jt->data.size () < size,
+            "%s: recorded data for address %#x is %dB, but %dB are requested",
+            name (), vaddr, jt->data.size (), size );
+    std::memcpy ( data, jt->data.data (), size );
+}
+
+void DuetEngineTrace::write_image (
+        Addr                    vaddr
+        , Tick                  tick
+        , const uint8_t       * data
+        , unsigned              size
+        )
+{
+    auto & versions = _image [vaddr];
+    Tick now = to_recorded_tick ( tick );
+    auto jt = std::upper_bound ( versions.begin (), versions.end (), now,
+            [] ( Tick t, const MemVersion & v ) { return t < v.tick; } );
+    versions.insert ( jt, { now, std::vector <uint8_t> ( data, data + size ) } );
+}
+
+}   // namespace duet
+}   // namespace gem5
@@ -0,0 +1,148 @@
+#ifndef __DUET_ENGINE_TRACE_HH
+#define __DUET_ENGINE_TRACE_HH
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+
+class ProtoOutputStream;
+
+namespace gem5 {
+namespace duet {
+
+/*
+ * DuetEngineTrace:
+ *
+ *  Records the software register accesses and the memory accesses of a
+ *  DuetEngine into a protobuf trace (see DuetTrace.proto), and plays them
+ *  back so that the engine can be driven from the trace without simulating
+ *  the host processors.
+ *
+ *  During replay, the recorded software register accesses are re-issued at
+ *  their recorded ticks, virtual addresses are translated with the page
+ *  mappings observed during recording, and loaded data comes from the
+ *  recorded memory image. The memory system only provides timing.
+ */
+class DuetEngineTrace {
+public:
+    struct SoftregAccess {
+        Tick                        tick;
+        bool                        is_write;
+        uint32_t                    softreg_id;
+        uint64_t                    value;
+    };
+
+private:
+    // pages are assumed to be at least 4kB
+    static const constexpr unsigned page_shift = 12;
+
+    // one version of the data at a virtual address
+    struct MemVersion {
+        Tick                        tick;
+        std::vector <uint8_t>       data;
+    };
+
+    const std::string               _name;
+
+    // -- Recording ----------------------------------------------------------
+    ProtoOutputStream             * _ostream;
+
+    //  the host processors poll the return registers, so only the first read
+    //  of a run of identical reads is recorded
+    bool                            _has_last_read;
+    SoftregAccess                   _last_read;
+
+    //  data last recorded at each virtual address
+    std::unordered_map <Addr, std::vector <uint8_t>>    _last_data;
+
+    // -- Replay -------------------------------------------------------------
+    std::deque <SoftregAccess>      _softregs;
+    std::unordered_map <Addr, Addr> _pages;
+    std::unordered_map <Addr, std::vector <MemVersion>> _image;
+
+    //  recorded ticks are shifted so that the first recorded access happens
+    //  at the tick when replay starts
+    Tick                            _recorded_start;
+    Tick                            _replay_start;
+
+private:
+    Tick to_recorded_tick ( Tick tick ) const {
+        return tick - _replay_start + _recorded_start;
+    }
+
+public:
+    DuetEngineTrace ( const std::string & name );
+    ~DuetEngineTrace ();
+
+    const std::string & name () const { return _name; }
+
+    // -- Recording ----------------------------------------------------------
+    void start_recording (
+            const std::string &     filename
+            , unsigned              num_callers
+            , unsigned              cache_line_size
+            );
+
+    void stop_recording ();
+
+    bool is_recording () const { return nullptr != _ostream; }
+
+    void record_softreg (
+            Tick                    tick
+            , bool                  is_write
+            , uint32_t              softreg_id
+            , uint64_t              value
+            );
+
+    void record_mem (
+            Tick                    tick
+            , uint16_t              chan_id
+            , uint8_t               req_type
+            , Addr                  vaddr
+            , Addr                  paddr
+            , unsigned              size
+            , Tick                  latency
+            , const uint8_t       * data
+            );
+
+    // -- Replay -------------------------------------------------------------
+    void load_replay (
+            const std::string &     filename
+            , unsigned              num_callers
+            , unsigned              cache_line_size
+            );
+
+    void start_replay ( Tick tick );
+
+    bool replay_pending () const { return !_softregs.empty (); }
+
+    /* The next software register access, with the tick shifted to the
+     * replay timeline */
+    SoftregAccess replay_front () const;
+
+    void replay_pop () { _softregs.pop_front (); }
+
+    Addr translate ( Addr vaddr ) const;
+
+    void read_image (
+            Addr                    vaddr
+            , Tick                  tick
+            , uint8_t             * data
+            , unsigned              size
+            ) const;
+
+    void write_image (
+            Addr                    vaddr
+            , Tick                  tick
+            , const uint8_t       * data
+            , unsigned              size
+            );
+};
+
+}   // namespace duet
+}   // namespace gem5
+
+#endif /* #ifndef __DUET_ENGINE_TRACE_HH */
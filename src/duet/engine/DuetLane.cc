@@ -45,6 +45,31 @@ bool DuetLane::push_default_retcode (
     }
 }
 
+bool DuetLane::try_complete (
+        DuetFunctor               & functor
+        )
+{
+    // the host may read the results once the call completes
+    if ( !engine->drain_wcb () )
+        return false;
+
+    if ( functor.use_default_retcode () )
+        return push_default_retcode ( functor.get_caller_id () );
+    else
+        return true;
+}
+
+bool DuetLane::can_push (
+        DuetFunctor::chan_id_t      chan_id
+        )
+{
+    if ( DuetFunctor::chan_id_t::RET == chan_id.tag
+            && !engine->drain_wcb () )
+        return false;
+
+    return engine->can_push_to_chan ( chan_id );
+}
+
 Cycles DuetLane::get_latency (
         DuetFunctor::stage_t    from
         , DuetFunctor::stage_t  to
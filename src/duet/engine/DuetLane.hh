@@ -31,6 +31,16 @@ public:
 
 protected:
     bool push_default_retcode ( DuetFunctor::caller_id_t caller_id );
+
+    /* complete the call of a finished functor: wait until its buffered
+     * stores reach memory, then push the default return code if the functor
+     * uses it. Return false if the call cannot complete in this cycle */
+    bool try_complete ( DuetFunctor & functor );
+
+    /* check if a functor blocked on pushing to a channel can proceed. A call
+     * returns its results through RET, so pushes to RET also wait until the
+     * buffered stores reach memory */
+    bool can_push ( DuetFunctor::chan_id_t chan_id );
     Cycles get_latency (
             DuetFunctor::stage_t    from
             , DuetFunctor::stage_t  to
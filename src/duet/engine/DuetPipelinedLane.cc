@@ -69,13 +69,15 @@ void DuetPipelinedLane::pull_phase () {
         // 1.4 if the execution has finished ...
         if ( it->functor->is_done () ) {
 
-            if ( !it->functor->use_default_retcode () ) {
+            if ( !it->functor->use_default_retcode ()
+                    && try_complete ( *it->functor ) )
+            {
                 // .. and does not push retcode, finishup and remove this
                 // execution
                 it->functor->finishup ();
                 it = _exec_list.erase ( it );
             } else {
-                // .. otherwise, speculate that retcode can be pushed in the
+                // .. otherwise, speculate that the call can complete in the
                 // push phase in this cycle
                 ++it;
                 status = Execution::SPECULATIVE;
@@ -180,9 +182,7 @@ void DuetPipelinedLane::push_phase () {
         // 1.4 if the execution has finished
         if ( it->functor->is_done () ) {
 
-            if ( !it->functor->use_default_retcode ()
-                    || push_default_retcode ( it->functor->get_caller_id () ) )
-            {
+            if ( try_complete ( *it->functor ) ) {
                 it->functor->finishup ();
                 it = _exec_list.erase ( it );
             } else {
@@ -207,7 +207,7 @@ void DuetPipelinedLane::push_phase () {
         case DuetFunctor::chan_id_t::WDATA:
         case DuetFunctor::chan_id_t::RET:
         case DuetFunctor::chan_id_t::PUSH:
-            if ( engine->can_push_to_chan ( chan_id ) ) {
+            if ( can_push ( chan_id ) ) {
                 auto prev = it->functor->get_stage ();
 
                 if ( it->functor->advance () ) {
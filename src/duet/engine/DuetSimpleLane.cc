@@ -33,7 +33,9 @@ void DuetSimpleLane::pull_phase () {
 
             // if it has finished ...
             if ( _functor->is_done () ) {
-                if ( !_functor->use_default_retcode () ) {
+                if ( !_functor->use_default_retcode ()
+                        && try_complete ( *_functor ) )
+                {
                     // .. and does not push retcode, finishup and reset
                     _functor->finishup ();
                     _functor.reset();
@@ -85,9 +87,7 @@ void DuetSimpleLane::push_phase () {
     // is the current execution done?
     if ( _functor->is_done () ) {
 
-        if ( !_functor->use_default_retcode ()
-                || push_default_retcode ( _functor->get_caller_id () ) )
-        {
+        if ( try_complete ( *_functor ) ) {
             _functor->finishup ();
             _functor.reset ();
         }
@@ -107,7 +107,7 @@ void DuetSimpleLane::push_phase () {
             case DuetFunctor::chan_id_t::WDATA:
             case DuetFunctor::chan_id_t::RET:
             case DuetFunctor::chan_id_t::PUSH:
-                if ( engine->can_push_to_chan ( chan_id ) )
+                if ( can_push ( chan_id ) )
                     _advance ();
                 break;
 
@@ -7,9 +7,6 @@ namespace gem5 {
 namespace duet {
 
 class DuetBarnesQuadMemLane : public DuetSimpleLane {
-private:
-    DuetFunctor::caller_id_t    _next_caller_roundrobin;
-
 protected:
     DuetFunctor * new_functor () override final;
 
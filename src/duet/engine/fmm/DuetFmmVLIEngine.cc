@@ -28,6 +28,10 @@ unsigned DuetFmmVLIEngine::get_max_stats_exectime () const {
     return 3000;
 }
 
+unsigned DuetFmmVLIEngine::get_num_args_per_call () const {
+    return 2;
+}
+
 bool DuetFmmVLIEngine::handle_softreg_write (
         DuetEngine::softreg_id_t    softreg_id
         , uint64_t                  value
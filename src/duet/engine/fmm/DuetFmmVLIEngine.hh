@@ -49,6 +49,7 @@ protected:
     DuetFunctor::caller_id_t get_num_interlane_chans () const override final;
     unsigned                 get_max_stats_waittime ()  const override final;
     unsigned                 get_max_stats_exectime ()  const override final;
+    unsigned                 get_num_args_per_call ()   const override final;
 
     bool handle_softreg_write (
             softreg_id_t                softreg_id
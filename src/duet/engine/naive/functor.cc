@@ -36,6 +36,9 @@ void NaiveFunctor::run () {
     // send store request
     enqueue_data ( *chan_wdata, data );
     enqueue_req ( *chan_req, REQTYPE_ST, sizeof (uint64_t), addr );
+
+    // wait for the store to be acknowledged
+    dequeue_token ( *chan_rdata );
 }
 
 }   // namespace duet
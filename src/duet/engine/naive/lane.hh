@@ -8,9 +8,6 @@ namespace duet {
 
 class NaiveFunctor;
 class NaiveLane : public DuetSimpleLane {
-private:
-    DuetFunctor::caller_id_t    _next_caller_roundrobin;
-
 protected:
     DuetFunctor * new_functor () override final;
 
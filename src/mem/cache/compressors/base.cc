@@ -33,6 +33,7 @@
 #include "mem/cache/compressors/base.hh"
 
 #include <algorithm>
+#include <cassert>
 #include <climits>
 #include <cmath>
 #include <cstdint>
@@ -42,6 +43,7 @@
 #include "base/trace.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/base.hh"
+#include "mem/cache/compressors/chunk_kernels.hh"
 #include "mem/cache/tags/super_blk.hh"
 #include "params/BaseCacheCompressor.hh"
 
@@ -114,37 +116,20 @@ Base::setCache(BaseCache *_cache)
 std::vector<Base::Chunk>
 Base::toChunks(const uint64_t* data) const
 {
-    // Number of chunks in a 64-bit value
-    const unsigned num_chunks_per_64 =
-        (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
-
     // Turn a 64-bit array into a chunkSizeBits-array
-    std::vector<Chunk> chunks((blkSize * CHAR_BIT) / chunkSizeBits, 0);
-    for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
-        const unsigned start = i % num_chunks_per_64;
-        chunks[i] = bits(data[index_64],
-            (start + 1) * chunkSizeBits - 1, start * chunkSizeBits);
-    }
-
+    std::vector<Chunk> chunks((blkSize * CHAR_BIT) / chunkSizeBits);
+    splitChunks(data, blkSize / sizeof(uint64_t), chunkSizeBits,
+                chunks.data());
     return chunks;
 }
 
 void
 Base::fromChunks(const std::vector<Chunk>& chunks, uint64_t* data) const
 {
-    // Number of chunks in a 64-bit value
-    const unsigned num_chunks_per_64 =
-        (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
-
     // Turn a chunkSizeBits-array into a 64-bit array
-    std::memset(data, 0, blkSize);
-    for (int i = 0; i < chunks.size(); i++) {
-        const int index_64 = std::floor(i / (double)num_chunks_per_64);
-        const unsigned start = i % num_chunks_per_64;
-        replaceBits(data[index_64], (start + 1) * chunkSizeBits - 1,
-            start * chunkSizeBits, chunks[i]);
-    }
+    assert(chunks.size() == (blkSize * CHAR_BIT) / chunkSizeBits);
+    joinChunks(chunks.data(), blkSize / sizeof(uint64_t), chunkSizeBits,
+               data);
 }
 
 std::unique_ptr<Base::CompressionData>
@@ -0,0 +1,231 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/compressors/chunk_kernels.hh"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace gem5
+{
+
+namespace compression
+{
+
+void
+splitChunksScalar(const uint64_t *data, std::size_t num_words,
+                  unsigned chunk_size_bits, uint64_t *chunks)
+{
+    const unsigned chunks_per_word = 64 / chunk_size_bits;
+    const uint64_t chunk_mask = (chunk_size_bits == 64) ? ~uint64_t(0) :
+        ((uint64_t(1) << chunk_size_bits) - 1);
+
+    for (std::size_t w = 0; w < num_words; w++) {
+        const uint64_t word = data[w];
+        for (unsigned j = 0; j < chunks_per_word; j++) {
+            chunks[w * chunks_per_word + j] =
+                (word >> (j * chunk_size_bits)) & chunk_mask;
+        }
+    }
+}
+
+void
+joinChunksScalar(const uint64_t *chunks, std::size_t num_words,
+                 unsigned chunk_size_bits, uint64_t *data)
+{
+    const unsigned chunks_per_word = 64 / chunk_size_bits;
+    const uint64_t chunk_mask = (chunk_size_bits == 64) ? ~uint64_t(0) :
+        ((uint64_t(1) << chunk_size_bits) - 1);
+
+    for (std::size_t w = 0; w < num_words; w++) {
+        uint64_t word = 0;
+        for (unsigned j = 0; j < chunks_per_word; j++) {
+            word |= (chunks[w * chunks_per_word + j] & chunk_mask) <<
+                (j * chunk_size_bits);
+        }
+        data[w] = word;
+    }
+}
+
+#if defined(__SSE2__)
+
+// x86 is little endian, so the n-th chunk of a line is the n-th
+// chunk_size_bits element in memory, and splitting a line is just zero
+// extending its elements to 64 bits.
+
+namespace
+{
+
+#if defined(__AVX2__)
+
+/** Split two words (16 bytes) of data. */
+inline void
+split128(__m128i v, unsigned chunk_size_bits, uint64_t *chunks)
+{
+    auto out = reinterpret_cast<__m256i *>(chunks);
+    switch (chunk_size_bits) {
+      case 32:
+        _mm256_storeu_si256(out, _mm256_cvtepu32_epi64(v));
+        break;
+      case 16:
+        _mm256_storeu_si256(out, _mm256_cvtepu16_epi64(v));
+        _mm256_storeu_si256(out + 1,
+                            _mm256_cvtepu16_epi64(_mm_srli_si128(v, 8)));
+        break;
+      case 8:
+        for (int i = 0; i < 4; i++) {
+            _mm256_storeu_si256(out + i, _mm256_cvtepu8_epi64(v));
+            v = _mm_srli_si128(v, 4);
+        }
+        break;
+    }
+}
+
+#else
+
+inline void
+widen32(__m128i v, uint64_t *chunks)
+{
+    const __m128i zero = _mm_setzero_si128();
+    auto out = reinterpret_cast<__m128i *>(chunks);
+    _mm_storeu_si128(out, _mm_unpacklo_epi32(v, zero));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi32(v, zero));
+}
+
+inline void
+widen16(__m128i v, uint64_t *chunks)
+{
+    const __m128i zero = _mm_setzero_si128();
+    widen32(_mm_unpacklo_epi16(v, zero), chunks);
+    widen32(_mm_unpackhi_epi16(v, zero), chunks + 4);
+}
+
+inline void
+widen8(__m128i v, uint64_t *chunks)
+{
+    const __m128i zero = _mm_setzero_si128();
+    widen16(_mm_unpacklo_epi8(v, zero), chunks);
+    widen16(_mm_unpackhi_epi8(v, zero), chunks + 8);
+}
+
+/** Split two words (16 bytes) of data. */
+inline void
+split128(__m128i v, unsigned chunk_size_bits, uint64_t *chunks)
+{
+    switch (chunk_size_bits) {
+      case 32:
+        widen32(v, chunks);
+        break;
+      case 16:
+        widen16(v, chunks);
+        break;
+      case 8:
+        widen8(v, chunks);
+        break;
+    }
+}
+
+#endif
+
+} // anonymous namespace
+
+void
+splitChunks(const uint64_t *data, std::size_t num_words,
+            unsigned chunk_size_bits, uint64_t *chunks)
+{
+    if (chunk_size_bits != 8 && chunk_size_bits != 16 &&
+        chunk_size_bits != 32) {
+        splitChunksScalar(data, num_words, chunk_size_bits, chunks);
+        return;
+    }
+
+    const unsigned chunks_per_word = 64 / chunk_size_bits;
+    std::size_t w = 0;
+    for (; w + 2 <= num_words; w += 2) {
+        split128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + w)),
+                 chunk_size_bits, chunks + w * chunks_per_word);
+    }
+    splitChunksScalar(data + w, num_words - w, chunk_size_bits,
+                      chunks + w * chunks_per_word);
+}
+
+void
+joinChunks(const uint64_t *chunks, std::size_t num_words,
+           unsigned chunk_size_bits, uint64_t *data)
+{
+    // Lines are only joined when they are decompressed, which is rarer
+    // than compression, so only the common 32-bit chunks are vectorized.
+    if (chunk_size_bits != 32) {
+        joinChunksScalar(chunks, num_words, chunk_size_bits, data);
+        return;
+    }
+
+    std::size_t w = 0;
+#if defined(__AVX2__)
+    // Gather the low half of four chunks into two words
+    const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    for (; w + 2 <= num_words; w += 2) {
+        const __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(chunks + 2 * w));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + w),
+            _mm256_castsi256_si128(
+                _mm256_permutevar8x32_epi32(v, low_halves)));
+    }
+#else
+    for (; w + 2 <= num_words; w += 2) {
+        auto in = reinterpret_cast<const __m128i *>(chunks + 2 * w);
+        const __m128i a = _mm_shuffle_epi32(_mm_loadu_si128(in),
+                                            _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i b = _mm_shuffle_epi32(_mm_loadu_si128(in + 1),
+                                            _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + w),
+                         _mm_unpacklo_epi64(a, b));
+    }
+#endif
+    joinChunksScalar(chunks + 2 * w, num_words - w, chunk_size_bits,
+                     data + w);
+}
+
+#else
+
+void
+splitChunks(const uint64_t *data, std::size_t num_words,
+            unsigned chunk_size_bits, uint64_t *chunks)
+{
+    splitChunksScalar(data, num_words, chunk_size_bits, chunks);
+}
+
+void
+joinChunks(const uint64_t *chunks, std::size_t num_words,
+           unsigned chunk_size_bits, uint64_t *data)
+{
+    joinChunksScalar(chunks, num_words, chunk_size_bits, data);
+}
+
+#endif
+
+} // namespace compression
+} // namespace gem5
@@ -0,0 +1,73 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Kernels that split a cache line into the fixed-size chunks the
+ * compressors work on, and join chunks back into a line.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_CHUNK_KERNELS_HH__
+#define __MEM_CACHE_COMPRESSORS_CHUNK_KERNELS_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gem5
+{
+
+namespace compression
+{
+
+/**
+ * Split a line into chunks. Each 64-bit word is split into
+ * 64 / chunk_size_bits chunks, least significant chunk first, and each
+ * chunk is zero extended to 64 bits. Chunk sizes of 8, 16 and 32 bits use
+ * SSE2/AVX2 when the host compiler targets them.
+ *
+ * @param data The line, as 64-bit words.
+ * @param num_words Number of words in the line.
+ * @param chunk_size_bits Size of a chunk; must divide 64.
+ * @param chunks Output, num_words * 64 / chunk_size_bits chunks.
+ */
+void splitChunks(const uint64_t *data, std::size_t num_words,
+                 unsigned chunk_size_bits, uint64_t *chunks);
+
+/**
+ * Inverse of splitChunks(). Only the chunk_size_bits least significant
+ * bits of each chunk are used.
+ */
+void joinChunks(const uint64_t *chunks, std::size_t num_words,
+                unsigned chunk_size_bits, uint64_t *data);
+
+/** Portable versions of the kernels, used for the remaining sizes. */
+void splitChunksScalar(const uint64_t *data, std::size_t num_words,
+                       unsigned chunk_size_bits, uint64_t *chunks);
+void joinChunksScalar(const uint64_t *chunks, std::size_t num_words,
+                      unsigned chunk_size_bits, uint64_t *data);
+
+} // namespace compression
+} // namespace gem5
+
+#endif //__MEM_CACHE_COMPRESSORS_CHUNK_KERNELS_HH__
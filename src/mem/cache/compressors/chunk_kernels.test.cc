@@ -0,0 +1,123 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mem/cache/compressors/chunk_kernels.hh"
+
+using namespace gem5;
+using namespace gem5::compression;
+
+namespace
+{
+
+/** Lines that exercise every byte lane, plus an odd number of words. */
+std::vector<std::vector<uint64_t>>
+lineCorpus()
+{
+    std::vector<std::vector<uint64_t>> lines;
+    std::mt19937_64 gen(0x5eed);
+    for (std::size_t num_words : {1, 2, 3, 8, 16}) {
+        std::vector<uint64_t> line(num_words);
+        for (auto &word : line) {
+            word = gen();
+        }
+        lines.push_back(line);
+        lines.push_back(std::vector<uint64_t>(num_words, ~uint64_t(0)));
+        lines.push_back(std::vector<uint64_t>(num_words, 0));
+    }
+    return lines;
+}
+
+} // anonymous namespace
+
+class ChunkKernelsTest : public ::testing::TestWithParam<unsigned>
+{
+};
+
+/** The split kernel matches the portable version, chunk by chunk. */
+TEST_P(ChunkKernelsTest, SplitMatchesScalar)
+{
+    const unsigned chunk_size_bits = GetParam();
+    const unsigned chunks_per_word = 64 / chunk_size_bits;
+    for (const auto &line : lineCorpus()) {
+        const std::size_t num_chunks = line.size() * chunks_per_word;
+        std::vector<uint64_t> expected(num_chunks);
+        std::vector<uint64_t> chunks(num_chunks);
+        splitChunksScalar(line.data(), line.size(), chunk_size_bits,
+                          expected.data());
+        splitChunks(line.data(), line.size(), chunk_size_bits,
+                    chunks.data());
+        ASSERT_EQ(expected, chunks);
+
+        // The least significant chunk of a word comes first
+        const uint64_t chunk_mask = (chunk_size_bits == 64) ? ~uint64_t(0) :
+            ((uint64_t(1) << chunk_size_bits) - 1);
+        ASSERT_EQ(chunks[0], line[0] & chunk_mask);
+    }
+}
+
+/** Joining the chunks of a line gives the line back. */
+TEST_P(ChunkKernelsTest, JoinInvertsSplit)
+{
+    const unsigned chunk_size_bits = GetParam();
+    const unsigned chunks_per_word = 64 / chunk_size_bits;
+    for (const auto &line : lineCorpus()) {
+        std::vector<uint64_t> chunks(line.size() * chunks_per_word);
+        std::vector<uint64_t> data(line.size(), 0xdeadbeef);
+        splitChunks(line.data(), line.size(), chunk_size_bits,
+                    chunks.data());
+        joinChunks(chunks.data(), line.size(), chunk_size_bits, data.data());
+        ASSERT_EQ(line, data);
+    }
+}
+
+/** Only the chunk_size_bits least significant bits of a chunk are joined. */
+TEST_P(ChunkKernelsTest, JoinIgnoresUpperBits)
+{
+    const unsigned chunk_size_bits = GetParam();
+    if (chunk_size_bits == 64) {
+        GTEST_SKIP() << "64-bit chunks have no upper bits";
+    }
+    const unsigned chunks_per_word = 64 / chunk_size_bits;
+    const std::size_t num_words = 8;
+    std::vector<uint64_t> chunks(num_words * chunks_per_word,
+                                 ~uint64_t(0) << chunk_size_bits);
+    std::vector<uint64_t> expected(num_words);
+    std::vector<uint64_t> data(num_words);
+    joinChunksScalar(chunks.data(), num_words, chunk_size_bits,
+                     expected.data());
+    joinChunks(chunks.data(), num_words, chunk_size_bits, data.data());
+    ASSERT_EQ(std::vector<uint64_t>(num_words, 0), expected);
+    ASSERT_EQ(expected, data);
+}
+
+INSTANTIATE_TEST_CASE_P(ChunkSizes, ChunkKernelsTest,
+                        ::testing::Values(8, 16, 32, 64));
@@ -168,6 +168,22 @@ class DictionaryCompressor : public BaseDictionaryCompressor
                                                     match_location);
             }
         }
+
+        /**
+         * Size, in bits, of the pattern getPattern() would instantiate.
+         * The pattern is built on the stack, so this does not allocate.
+         */
+        static std::size_t
+        getSizeBits(const DictionaryEntry& bytes,
+            const DictionaryEntry& dict_bytes, const int match_location)
+        {
+            if (Head::isPattern(bytes, dict_bytes, match_location)) {
+                return Head(bytes, match_location).getSizeBits();
+            } else {
+                return Factory<Tail...>::getSizeBits(bytes, dict_bytes,
+                                                     match_location);
+            }
+        }
     };
 
     /**
@@ -189,6 +205,13 @@ class DictionaryCompressor : public BaseDictionaryCompressor
         {
             return std::unique_ptr<Pattern>(new Head(bytes, match_location));
         }
+
+        static std::size_t
+        getSizeBits(const DictionaryEntry& bytes,
+            const DictionaryEntry& dict_bytes, const int match_location)
+        {
+            return Head(bytes, match_location).getSizeBits();
+        }
     };
 
     /** The dictionary. */
@@ -203,6 +226,19 @@ class DictionaryCompressor : public BaseDictionaryCompressor
     getPattern(const DictionaryEntry& bytes, const DictionaryEntry& dict_bytes,
         const int match_location) const = 0;
 
+    /**
+     * Get the size of the pattern getPattern() would return. Compressing a
+     * value compares the patterns for every dictionary entry, so the
+     * sub-classes should implement this with their factory's getSizeBits,
+     * which does not need to allocate the patterns.
+     */
+    virtual std::size_t
+    getPatternSizeBits(const DictionaryEntry& bytes,
+        const DictionaryEntry& dict_bytes, const int match_location) const
+    {
+        return getPattern(bytes, dict_bytes, match_location)->getSizeBits();
+    }
+
     /**
      * Compress data.
      *
@@ -187,6 +187,22 @@ class TaggedPrefetcher(QueuedPrefetcher):
 
     degree = Param.Int(2, "Number of prefetches to generate")
 
+class ContentDirectedPrefetcher(QueuedPrefetcher):
+    type = 'ContentDirectedPrefetcher'
+    cxx_class = 'gem5::prefetch::ContentDirected'
+    cxx_header = "mem/cache/prefetch/content_directed.hh"
+
+    process = Param.Process(NULL, "Process whose page table is used to "
+        "recognize and translate pointers (if not set, pointers are "
+        "physical addresses)")
+    pointer_size = Param.Unsigned(8, "Size of a pointer in bytes")
+    pointer_align = Param.Unsigned(8, "Alignment of a pointer in bytes")
+    max_depth = Param.Unsigned(2, "Maximum length of a chain of prefetches")
+    max_pointers_per_line = Param.Unsigned(4,
+        "Maximum number of prefetches generated from one line")
+    depth_table_entries = Param.Unsigned(256,
+        "Maximum number of in-flight prefetches whose depth is tracked")
+
 class IndirectMemoryPrefetcher(QueuedPrefetcher):
     type = 'IndirectMemoryPrefetcher'
     cxx_class = 'gem5::prefetch::IndirectMemory'
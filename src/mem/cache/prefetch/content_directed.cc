@@ -0,0 +1,192 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a content-directed prefetcher for pointer-chasing accesses.
+ */
+
+#include "mem/cache/prefetch/content_directed.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/base.hh"
+#include "mem/page_table.hh"
+#include "params/ContentDirectedPrefetcher.hh"
+#include "sim/byteswap.hh"
+#include "sim/process.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+ContentDirected::ContentDirected(const ContentDirectedPrefetcherParams &p)
+  : Queued(p), process(p.process), pointerSize(p.pointer_size),
+    pointerAlign(p.pointer_align), maxDepth(p.max_depth),
+    maxPointersPerLine(p.max_pointers_per_line),
+    depthTableEntries(p.depth_table_entries),
+    byteOrder(p.sys->getGuestByteOrder()),
+    statsContentDirected(this)
+{
+    fatal_if(pointerSize != 4 && pointerSize != 8,
+             "%s: pointer size must be 4 or 8 bytes", name());
+    fatal_if(pointerAlign == 0 || !isPowerOf2(pointerAlign),
+             "%s: pointer alignment must be a power of 2", name());
+    fatal_if(useVirtualAddresses,
+             "%s: the cache must be accessed with physical addresses",
+             name());
+}
+
+ContentDirected::ContentDirectedStats::ContentDirectedStats(
+    statistics::Group *parent)
+    : statistics::Group(parent),
+    ADD_STAT(pointersFound, statistics::units::Count::get(),
+             "number of pointers found in filled lines"),
+    ADD_STAT(pointersUnmapped, statistics::units::Count::get(),
+             "number of aligned values that do not point to mapped memory"),
+    ADD_STAT(pfChained, statistics::units::Count::get(),
+             "number of prefetch candidates found in prefetched lines")
+{
+}
+
+Addr
+ContentDirected::readPointer(const uint8_t *data) const
+{
+    if (pointerSize == 8) {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return gtoh(value, byteOrder);
+    } else {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return gtoh(value, byteOrder);
+    }
+}
+
+bool
+ContentDirected::translatePointer(Addr value, Addr &paddr)
+{
+    if (value == 0 || value % pointerAlign != 0) {
+        return false;
+    }
+
+    bool mapped;
+    if (process) {
+        mapped = process->pTable->translate(value, paddr);
+    } else {
+        paddr = value;
+        mapped = cache->system->isMemAddr(value);
+    }
+
+    if (!mapped) {
+        statsContentDirected.pointersUnmapped++;
+    }
+    return mapped;
+}
+
+void
+ContentDirected::recordDepth(Addr blk_addr, unsigned depth)
+{
+    auto ret = depthTable.emplace(blk_addr, depth);
+    if (!ret.second) {
+        ret.first->second = std::min(ret.first->second, depth);
+        return;
+    }
+
+    depthTableOrder.push_back(blk_addr);
+    if (depthTableOrder.size() > depthTableEntries) {
+        depthTable.erase(depthTableOrder.front());
+        depthTableOrder.pop_front();
+    }
+}
+
+void
+ContentDirected::notifyFill(const PacketPtr &pkt)
+{
+    if (!pkt->hasData() || pkt->isSecure()) {
+        return;
+    }
+
+    Addr blk_addr = blockAddress(pkt->getAddr());
+
+    // Lines filled by demand misses start a chain. Lines filled by our own
+    // prefetches continue the chain they belong to
+    unsigned depth = 0;
+    if (pkt->cmd.isHWPrefetch()) {
+        auto it = depthTable.find(blk_addr);
+        if (it == depthTable.end()) {
+            return;
+        }
+        depth = it->second;
+    }
+
+    if (depth >= maxDepth) {
+        return;
+    }
+
+    PrefetchInfo pfi(pkt, blk_addr, true);
+    const uint8_t *data = pkt->getConstPtr<uint8_t>();
+    unsigned found = 0;
+
+    for (unsigned offset = 0;
+         offset + pointerSize <= pkt->getSize() && found < maxPointersPerLine;
+         offset += pointerSize) {
+        Addr paddr;
+        if (!translatePointer(readPointer(data + offset), paddr)) {
+            continue;
+        }
+
+        Addr pf_addr = blockAddress(paddr);
+        if (pf_addr == blk_addr) {
+            continue;
+        }
+
+        statsContentDirected.pointersFound++;
+        statsQueued.pfIdentified++;
+        if (depth > 0) {
+            statsContentDirected.pfChained++;
+        }
+
+        DPRINTF(HWPrefetch, "Found pointer to %#x at offset %u of %#x, "
+                "depth %u\n", paddr, offset, blk_addr, depth);
+
+        // Closer lines are needed sooner
+        PrefetchInfo new_pfi(pfi, pf_addr);
+        recordDepth(pf_addr, depth + 1);
+        insertTranslated(new_pfi, pf_addr, maxDepth - depth);
+        found++;
+    }
+}
+
+} // namespace prefetch
+} // namespace gem5
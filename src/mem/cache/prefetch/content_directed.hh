@@ -0,0 +1,141 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a content-directed prefetcher for pointer-chasing accesses.
+ *
+ * When a line is filled into the cache, its content is scanned for values
+ * that look like pointers, i.e., aligned values that map to valid memory,
+ * and the lines they point to are prefetched. Lines brought in by these
+ * prefetches are scanned in turn, up to a maximum chain depth.
+ *
+ * Reference:
+ *     Cooksey, R., Jourdan, S., & Grunwald, D. (2002). A stateless,
+ *     content-directed data prefetching mechanism. ASPLOS X.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_CONTENT_DIRECTED_HH__
+#define __MEM_CACHE_PREFETCH_CONTENT_DIRECTED_HH__
+
+#include <deque>
+#include <unordered_map>
+
+#include "base/statistics.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+class Process;
+struct ContentDirectedPrefetcherParams;
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+class ContentDirected : public Queued
+{
+  protected:
+    /**
+     * Process whose page table is used to recognize and translate
+     * pointers. If not set, pointers are physical addresses.
+     */
+    Process *process;
+
+    /** Size of a pointer in bytes */
+    const unsigned pointerSize;
+
+    /** Alignment of a pointer value in bytes */
+    const unsigned pointerAlign;
+
+    /** Maximum length of a chain of prefetches */
+    const unsigned maxDepth;
+
+    /** Maximum number of prefetches generated from one line */
+    const unsigned maxPointersPerLine;
+
+    /** Maximum number of in-flight prefetches whose depth is tracked */
+    const unsigned depthTableEntries;
+
+    /** Byte order of the pointers in memory */
+    const ByteOrder byteOrder;
+
+    /** Chain depth of the lines being prefetched, in insertion order */
+    std::unordered_map<Addr, unsigned> depthTable;
+    std::deque<Addr> depthTableOrder;
+
+    struct ContentDirectedStats : public statistics::Group
+    {
+        ContentDirectedStats(statistics::Group *parent);
+
+        /** Number of pointers found in filled lines */
+        statistics::Scalar pointersFound;
+        /** Number of aligned values rejected for not mapping to memory */
+        statistics::Scalar pointersUnmapped;
+        /** Number of prefetches generated from prefetched lines */
+        statistics::Scalar pfChained;
+    } statsContentDirected;
+
+    /**
+     * Reads the pointer at the given location of a line
+     * @param data pointer to the data of the line
+     * @return the value read
+     */
+    Addr readPointer(const uint8_t *data) const;
+
+    /**
+     * Checks if a value is a plausible pointer and obtains the physical
+     * address it points to.
+     * @param value the value read from the line
+     * @param paddr the physical address pointed to
+     * @return true if the value is a plausible pointer
+     */
+    bool translatePointer(Addr value, Addr &paddr);
+
+    /**
+     * Records the chain depth of a line being prefetched
+     * @param blk_addr the block address of the line
+     * @param depth the chain depth
+     */
+    void recordDepth(Addr blk_addr, unsigned depth);
+
+  public:
+    ContentDirected(const ContentDirectedPrefetcherParams &p);
+    ~ContentDirected() = default;
+
+    void notifyFill(const PacketPtr &pkt) override;
+
+    /** Demand accesses do not train this prefetcher */
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses) override
+    {}
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_CONTENT_DIRECTED_HH__
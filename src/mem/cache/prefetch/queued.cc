@@ -61,8 +61,7 @@ Queued::DeferredPacket::createPkt(Addr paddr, unsigned blk_size,
                                             bool tag_prefetch,
                                             Tick t) {
     /* Create a prefetch memory request */
-    RequestPtr req = std::make_shared<Request>(paddr, blk_size,
-                                                0, requestor_id);
+    RequestPtr req = makeRequest(paddr, blk_size, 0, requestor_id);
 
     if (pfInfo.isSecure()) {
         req->setFlags(Request::SECURE);
@@ -374,7 +373,7 @@ RequestPtr
 Queued::createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt)
 {
-    RequestPtr translation_req = std::make_shared<Request>(
+    RequestPtr translation_req = makeRequest(
             addr, blkSize, pkt->req->getFlags(), requestorId, pfi.getPC(),
             pkt->req->contextId());
     translation_req->setFlags(Request::PREFETCH);
@@ -451,7 +450,40 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
             return;
         }
     }
-    if (has_target_pa && cacheSnoop &&
+    if (has_target_pa) {
+        queueTranslated(new_pfi, target_paddr, priority);
+    } else {
+        // Add the translation request and try to resolve it later
+        DeferredPacket dpp(this, new_pfi, 0, priority);
+        dpp.setTranslationRequest(translation_req);
+        dpp.tc = cache->system->threads[translation_req->contextId()];
+        DPRINTF(HWPrefetch, "Prefetch queued with no translation. "
+                "addr:%#x priority: %3d\n", new_pfi.getAddr(), priority);
+        addToQueue(pfqMissingTranslation, dpp);
+    }
+}
+
+void
+Queued::insertTranslated(PrefetchInfo &new_pfi, Addr target_paddr,
+                         int32_t priority)
+{
+    if (queueFilter) {
+        if (alreadyInQueue(pfq, new_pfi, priority)) {
+            return;
+        }
+        if (alreadyInQueue(pfqMissingTranslation, new_pfi, priority)) {
+            return;
+        }
+    }
+
+    queueTranslated(new_pfi, target_paddr, priority);
+}
+
+void
+Queued::queueTranslated(PrefetchInfo &new_pfi, Addr target_paddr,
+                        int32_t priority)
+{
+    if (cacheSnoop &&
             (inCache(target_paddr, new_pfi.isSecure()) ||
             inMissQueue(target_paddr, new_pfi.isSecure()))) {
         statsQueued.pfInCache++;
@@ -462,22 +494,13 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
 
     /* Create the packet and find the spot to insert it */
     DeferredPacket dpp(this, new_pfi, 0, priority);
-    if (has_target_pa) {
-        Tick pf_time = curTick() + clockPeriod() * latency;
-        dpp.createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
-                      pf_time);
-        DPRINTF(HWPrefetch, "Prefetch queued. "
-                "addr:%#x priority: %3d tick:%lld.\n",
-                new_pfi.getAddr(), priority, pf_time);
-        addToQueue(pfq, dpp);
-    } else {
-        // Add the translation request and try to resolve it later
-        dpp.setTranslationRequest(translation_req);
-        dpp.tc = cache->system->threads[translation_req->contextId()];
-        DPRINTF(HWPrefetch, "Prefetch queued with no translation. "
-                "addr:%#x priority: %3d\n", new_pfi.getAddr(), priority);
-        addToQueue(pfqMissingTranslation, dpp);
-    }
+    Tick pf_time = curTick() + clockPeriod() * latency;
+    dpp.createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
+                  pf_time);
+    DPRINTF(HWPrefetch, "Prefetch queued. "
+            "addr:%#x priority: %3d tick:%lld.\n",
+            new_pfi.getAddr(), priority, pf_time);
+    addToQueue(pfq, dpp);
 }
 
 void
@@ -197,6 +197,16 @@ class Queued : public Base
 
     void insert(const PacketPtr &pkt, PrefetchInfo &new_pfi, int32_t priority);
 
+    /**
+     * Queues a prefetch whose physical address is already known, e.g.,
+     * because the prefetcher translated the target address on its own.
+     * @param new_pfi information of the prefetch request to be added
+     * @param target_paddr physical address of the prefetch
+     * @param priority priority of the prefetch request to be added
+     */
+    void insertTranslated(PrefetchInfo &new_pfi, Addr target_paddr,
+                          int32_t priority);
+
     virtual void calculatePrefetch(const PrefetchInfo &pfi,
                                    std::vector<AddrPriority> &addresses) = 0;
     PacketPtr getPacket() override;
@@ -258,6 +268,17 @@ class Queued : public Base
 
     RequestPtr createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt);
+
+    /**
+     * Drops the prefetch if the target is already cached or being fetched,
+     * otherwise creates its packet and adds it to the queue of ready
+     * prefetches.
+     * @param new_pfi information of the prefetch request to be added
+     * @param target_paddr physical address of the prefetch
+     * @param priority priority of the prefetch request to be added
+     */
+    void queueTranslated(PrefetchInfo &new_pfi, Addr target_paddr,
+                         int32_t priority);
 };
 
 } // namespace prefetch
@@ -49,6 +49,7 @@
 #include <string>
 #include <type_traits>
 
+#include "base/flat_hash_map.hh"
 #include "base/logging.hh"
 #include "base/named.hh"
 #include "base/trace.hh"
@@ -101,6 +102,61 @@ class Queue : public Drainable, public Named
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Index of allocatedList by block address. Maps an address to the
+     * oldest allocated entry for it; younger entries with the same
+     * address are chained through QueueEntry::nextSameAddr. Matching
+     * is on every cache access, and scanning the whole allocated list
+     * gets expensive with many entries.
+     */
+    FlatHashMap<Addr, Entry*> addrIndex;
+
+    typename Entry::Iterator addToAllocatedList(Entry* entry)
+    {
+        assert(!entry->nextSameAddr);
+        auto [it, inserted] = addrIndex.try_emplace(entry->blkAddr, entry);
+        if (!inserted) {
+            QueueEntry *last = it->second;
+            while (last->nextSameAddr) {
+                last = last->nextSameAddr;
+            }
+            last->nextSameAddr = entry;
+        }
+        return allocatedList.insert(allocatedList.end(), entry);
+    }
+
+    void removeFromAllocatedList(Entry* entry)
+    {
+        auto it = addrIndex.find(entry->blkAddr);
+        assert(it != addrIndex.end());
+        if (it->second == entry) {
+            if (entry->nextSameAddr) {
+                it->second = static_cast<Entry*>(entry->nextSameAddr);
+            } else {
+                addrIndex.erase(it);
+            }
+        } else {
+            QueueEntry *prev = it->second;
+            while (prev->nextSameAddr != entry) {
+                prev = prev->nextSameAddr;
+                assert(prev);
+            }
+            prev->nextSameAddr = entry->nextSameAddr;
+        }
+        entry->nextSameAddr = nullptr;
+        allocatedList.erase(entry->allocIter);
+    }
+
+    Entry* findPendingInReadyList(const QueueEntry* entry) const
+    {
+        for (const auto& ready_entry : readyList) {
+            if (ready_entry->conflictAddr(entry)) {
+                return ready_entry;
+            }
+        }
+        return nullptr;
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -140,6 +196,9 @@ class Queue : public Drainable, public Named
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
         }
+        // leave room for erased slots, as the addresses in the queue
+        // change all the time
+        addrIndex.reserve(4 * numEntries);
     }
 
     bool isEmpty() const
@@ -168,16 +227,23 @@ class Queue : public Drainable, public Named
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
+        auto it = addrIndex.find(blk_addr);
+        if (it == addrIndex.end()) {
+            return nullptr;
+        }
+
+        // entries are chained in allocation order, so this finds the
+        // same entry as a search of allocatedList
+        for (QueueEntry *e = it->second; e; e = e->nextSameAddr) {
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
             // uncacheable entries, and we do not want normal
             // cacheable accesses being added to an WriteQueueEntry
             // serving an uncacheable access
-            if (!(ignore_uncacheable && entry->isUncacheable()) &&
-                entry->matchBlockAddr(blk_addr, is_secure)) {
-                return entry;
+            if (!(ignore_uncacheable && e->isUncacheable()) &&
+                e->matchBlockAddr(blk_addr, is_secure)) {
+                return static_cast<Entry*>(e);
             }
         }
         return nullptr;
@@ -206,12 +272,24 @@ class Queue : public Drainable, public Named
      */
     Entry* findPending(const QueueEntry* entry) const
     {
-        for (const auto& ready_entry : readyList) {
-            if (ready_entry->conflictAddr(entry)) {
-                return ready_entry;
+        auto it = addrIndex.find(entry->blkAddr);
+        if (it == addrIndex.end()) {
+            return nullptr;
+        }
+
+        // entries that are not in service are the ones in readyList
+        Entry *pending = nullptr;
+        for (QueueEntry *e = it->second; e; e = e->nextSameAddr) {
+            if (!e->inService && e->conflictAddr(entry)) {
+                if (pending) {
+                    // more than one candidate, the earliest one in
+                    // readyList order wins
+                    return findPendingInReadyList(entry);
+                }
+                pending = static_cast<Entry*>(e);
             }
         }
-        return nullptr;
+        return pending;
     }
 
     /**
@@ -240,7 +318,7 @@ class Queue : public Drainable, public Named
     virtual void
     deallocate(Entry *entry)
     {
-        allocatedList.erase(entry->allocIter);
+        removeFromAllocatedList(entry);
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
@@ -76,6 +76,12 @@ class QueueEntry : public Packet::SenderState, public Named
     /** True if the entry is uncacheable */
     bool _isUncacheable;
 
+    /**
+     * Next allocated entry of the same queue with the same block
+     * address, in allocation order. Used by the queue's address index.
+     */
+    QueueEntry *nextSameAddr;
+
   public:
     /**
      * A queue entry is holding packets that will be serviced as soon as
@@ -123,7 +129,7 @@ class QueueEntry : public Packet::SenderState, public Named
 
     QueueEntry(const std::string &name)
         : Named(name),
-          readyTime(0), _isUncacheable(false),
+          readyTime(0), _isUncacheable(false), nextSameAddr(nullptr),
           inService(false), order(0), blkAddr(0), blkSize(0), isSecure(false)
     {}
 
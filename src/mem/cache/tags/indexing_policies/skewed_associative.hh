@@ -138,6 +138,13 @@ class SkewedAssociative : public BaseIndexingPolicy
      */
     uint32_t extractSet(const Addr addr, const uint32_t way) const;
 
+    /**
+     * The entries of the last call to getPossibleEntries(). As each way of
+     * an address maps to a different set, they must be gathered, and are
+     * kept here so that no vector is allocated on every lookup.
+     */
+    mutable std::vector<ReplaceableEntry*> possibleEntries;
+
   public:
     /** Convenience typedef. */
      typedef SkewedAssociativeParams Params;
@@ -160,8 +167,8 @@ class SkewedAssociative : public BaseIndexingPolicy
      * @param addr The addr to a find possible entries for.
      * @return The possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
-                                                                   override;
+    const std::vector<ReplaceableEntry*>&
+    getPossibleEntries(const Addr addr) const override;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
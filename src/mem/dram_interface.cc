@@ -59,116 +59,112 @@ namespace memory
 std::pair<MemPacketQueue::iterator, Tick>
 DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
 {
-    std::vector<uint32_t> earliest_banks(ranksPerChannel, 0);
+    // The choice is made as if the queue was searched in order for
+    // seamless row hits first; if none is found, for packets that can
+    // issue without incurring additional bus delay due to bank timing,
+    // which selects closed rows first to enable more open row
+    // possibilities in future selections; and then for other row hits
+    // and the earliest possible packets. Instead of visiting every
+    // packet, each bank contributes its oldest row hit and its oldest
+    // row miss, and the queue positions of these decide which one comes
+    // first. All the packets of a queue go in the same direction, so the
+    // row hits of a bank are either all seamless or none of them is.
+
+    // oldest row hit that can issue seamlessly, without additional
+    // delay, such as same rank accesses and/or different bank-group
+    // accesses
+    MemPacket *seamless_pkt = nullptr;
+
+    // oldest row hit, not seamless, but bank prepped and ready
+    MemPacket *prepped_pkt = nullptr;
+
+    // is there a packet to a closed row in an available rank?
+    bool found_row_miss = false;
 
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
+    for (int i = 0; i < ranksPerChannel; i++) {
+        // check if rank is not doing a refresh and thus is available,
+        // if not, skip its banks
+        if (!ranks[i]->inRefIdleState()) {
+            DPRINTF(DRAM, "%s Rank %d not available\n", __func__, i);
+            continue;
+        }
 
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
-
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
-
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
-
-    Tick selected_col_at = MaxTick;
-    auto selected_pkt_it = queue.end();
-
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        MemPacket* pkt = *i;
-
-        // select optimal DRAM packet in Q
-        if (pkt->isDram() && (pkt->pseudoChannel == pseudoChannel)) {
-            const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
-            const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
-                                                        bank.wrAllowedAt;
-
-            DPRINTF(DRAM, "%s checking DRAM packet in bank %d, row %d\n",
-                    __func__, pkt->bank, pkt->row);
-
-            // check if rank is not doing a refresh and thus is available,
-            // if not, jump to the next packet
-            if (burstReady(pkt)) {
-
-                DPRINTF(DRAM,
-                        "%s bank %d - Rank %d available\n", __func__,
-                        pkt->bank, pkt->rank);
-
-                // check if it is a row hit
-                if (bank.openRow == pkt->row) {
-                    // no additional rank-to-rank or same bank-group
-                    // delays, or we switched read/write and might as well
-                    // go for the row hit
-                    if (col_allowed_at <= min_col_at) {
-                        // FCFS within the hits, giving priority to
-                        // commands that can issue seamlessly, without
-                        // additional delay, such as same rank accesses
-                        // and/or different bank-group accesses
-                        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        // no need to look through the remaining queue entries
-                        break;
-                    } else if (!found_hidden_bank && !found_prepped_pkt) {
-                        // if we did not find a packet to a closed row that can
-                        // issue the bank commands without incurring delay, and
-                        // did not yet find a packet to a prepped row, remember
-                        // the current one
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        found_prepped_pkt = true;
-                        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                    }
-                } else if (!found_earliest_pkt) {
-                    // if we have not initialised the bank status, do it
-                    // now, and only once per scheduling decisions
-                    if (!filled_earliest_banks) {
-                        // determine entries with earliest bank delay
-                        std::tie(earliest_banks, hidden_bank_prep) =
-                            minBankPrep(queue, min_col_at);
-                        filled_earliest_banks = true;
-                    }
+        for (int j = 0; j < banksPerRank; j++) {
+            const MemPacketQueue::BankQueue *bank_queue =
+                queue.bankQueue(pseudoChannel, i * banksPerRank + j);
+            if (!bank_queue || bank_queue->empty())
+                continue;
+
+            const Bank& bank = ranks[i]->banks[j];
+            MemPacket *hit = bank_queue->oldestTo(bank.openRow);
+            if (hit) {
+                const Tick col_allowed_at = hit->isRead() ?
+                    bank.rdAllowedAt : bank.wrAllowedAt;
+                MemPacket *&selected = col_allowed_at <= min_col_at ?
+                    seamless_pkt : prepped_pkt;
+                if (!selected || hit->queueSeq < selected->queueSeq)
+                    selected = hit;
+            }
 
-                    // bank is amongst first available banks
-                    // minBankPrep will give priority to packets that can
-                    // issue seamlessly
-                    if (bits(earliest_banks[pkt->rank],
-                             pkt->bank, pkt->bank)) {
-                        found_earliest_pkt = true;
-                        found_hidden_bank = hidden_bank_prep;
-
-                        // give priority to packets that can issue
-                        // bank commands 'behind the scenes'
-                        // any additional delay if any will be due to
-                        // col-to-col command requirements
-                        if (hidden_bank_prep || !found_prepped_pkt) {
-                            selected_pkt_it = i;
-                            selected_col_at = col_allowed_at;
-                        }
-                    }
+            found_row_miss = found_row_miss ||
+                bank_queue->oldestNotTo(bank.openRow);
+        }
+    }
+
+    MemPacket *selected_pkt = seamless_pkt;
+    if (seamless_pkt) {
+        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
+    } else if (found_row_miss) {
+        // determine entries with earliest bank delay, minBankPrep will
+        // give priority to packets that can issue seamlessly
+        std::vector<uint32_t> earliest_banks;
+        // can the PRE/ACT sequence be done without impacting utlization?
+        bool hidden_bank_prep;
+        std::tie(earliest_banks, hidden_bank_prep) =
+            minBankPrep(queue, min_col_at);
+
+        // oldest packet to a closed row amongst the first available
+        // banks
+        MemPacket *earliest_pkt = nullptr;
+        for (int i = 0; i < ranksPerChannel; i++) {
+            for (int j = 0; j < banksPerRank; j++) {
+                if (!bits(earliest_banks[i], j, j))
+                    continue;
+
+                MemPacket *miss = queue.bankQueue(
+                    pseudoChannel, i * banksPerRank + j)->oldestNotTo(
+                        ranks[i]->banks[j].openRow);
+                if (miss && (!earliest_pkt ||
+                             miss->queueSeq < earliest_pkt->queueSeq)) {
+                    earliest_pkt = miss;
                 }
-            } else {
-                DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                        pkt->bank, pkt->rank);
             }
         }
+
+        // give priority to packets that can issue bank commands 'behind
+        // the scenes', any additional delay if any will be due to
+        // col-to-col command requirements, then to prepped row hits
+        if (earliest_pkt && (hidden_bank_prep || !prepped_pkt)) {
+            selected_pkt = earliest_pkt;
+        } else {
+            selected_pkt = prepped_pkt;
+        }
+    } else {
+        selected_pkt = prepped_pkt;
     }
 
-    if (selected_pkt_it == queue.end()) {
+    if (!selected_pkt) {
         DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+        return std::make_pair(queue.end(), MaxTick);
     }
 
-    return std::make_pair(selected_pkt_it, selected_col_at);
+    DPRINTF(DRAM, "%s selected DRAM packet in bank %d, row %d\n",
+            __func__, selected_pkt->bank, selected_pkt->row);
+
+    const Bank& bank = ranks[selected_pkt->rank]->banks[selected_pkt->bank];
+    const Tick selected_col_at = selected_pkt->isRead() ?
+        bank.rdAllowedAt : bank.wrAllowedAt;
+    return std::make_pair(queue.find(selected_pkt), selected_col_at);
 }
 
 void
@@ -1038,27 +1034,21 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // delay on the data bus
     bool hidden_bank_prep = false;
 
-    // determine if we have queued transactions targetting the
-    // bank in question
-    std::vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->pseudoChannel != pseudoChannel)
-            continue;
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
-            got_waiting[p->bankId] = true;
-    }
-
     // Find command with optimal bank timing
     // Will prioritize commands that can issue seamlessly.
     for (int i = 0; i < ranksPerChannel; i++) {
+        // skip ranks that are refreshing
+        if (!ranks[i]->inRefIdleState())
+            continue;
+
         for (int j = 0; j < banksPerRank; j++) {
             uint16_t bank_id = i * banksPerRank + j;
+            const MemPacketQueue::BankQueue *bank_queue =
+                queue.bankQueue(pseudoChannel, bank_id);
 
             // if we have waiting requests for the bank, and it is
             // amongst the first available, update the mask
-            if (got_waiting[bank_id]) {
-                // make sure this rank is not currently refreshing.
-                assert(ranks[i]->inRefIdleState());
+            if (bank_queue && !bank_queue->empty()) {
                 // simplistic approximation of when the bank can issue
                 // an activate, ignoring any rank-to-rank switching
                 // cost in this calculation
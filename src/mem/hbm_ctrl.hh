@@ -171,7 +171,7 @@ class HBMCtrl : public MemCtrl
      * Response queue for pkts sent to second pseudo channel
      * The first pseudo channel uses MemCtrl::respQueue
      */
-    std::deque<MemPacket*> respQueuePC1;
+    MemPacketQueue respQueuePC1;
 
     /**
      * Holds count of row commands issued in burst window starting at
@@ -40,6 +40,8 @@
 
 #include "mem/mem_ctrl.hh"
 
+#include <algorithm>
+
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/Drain.hh"
@@ -57,6 +59,118 @@ namespace gem5
 namespace memory
 {
 
+MemPacketQueue::RowQueue *
+MemPacketQueue::BankQueue::findRow(uint32_t row)
+{
+    for (size_t i = 0; i < numRows; ++i) {
+        if (rows[i].row == row)
+            return &rows[i];
+    }
+    return nullptr;
+}
+
+void
+MemPacketQueue::BankQueue::add(MemPacket* pkt)
+{
+    RowQueue *row_queue = findRow(pkt->row);
+    if (!row_queue) {
+        if (numRows == rows.size())
+            rows.emplace_back();
+        row_queue = &rows[numRows++];
+        row_queue->row = pkt->row;
+    }
+    row_queue->packets.push_back(pkt);
+}
+
+void
+MemPacketQueue::BankQueue::remove(MemPacket* pkt)
+{
+    RowQueue *row_queue = findRow(pkt->row);
+    assert(row_queue);
+    auto &packets = row_queue->packets;
+    auto it = std::find(packets.begin(), packets.end(), pkt);
+    assert(it != packets.end());
+    packets.erase(it);
+
+    if (packets.empty()) {
+        // keep the row queues in use at the front
+        std::swap(*row_queue, rows[--numRows]);
+    }
+}
+
+MemPacket *
+MemPacketQueue::BankQueue::oldestTo(uint32_t row) const
+{
+    for (size_t i = 0; i < numRows; ++i) {
+        if (rows[i].row == row)
+            return rows[i].packets.front();
+    }
+    return nullptr;
+}
+
+MemPacket *
+MemPacketQueue::BankQueue::oldestNotTo(uint32_t row) const
+{
+    MemPacket *oldest = nullptr;
+    for (size_t i = 0; i < numRows; ++i) {
+        MemPacket *pkt = rows[i].packets.front();
+        if (rows[i].row != row &&
+            (!oldest || pkt->queueSeq < oldest->queueSeq)) {
+            oldest = pkt;
+        }
+    }
+    return oldest;
+}
+
+void
+MemPacketQueue::push_back(MemPacket* pkt)
+{
+    pkt->queueSeq = nextSeq++;
+    packets.push_back(pkt);
+
+    if (pkt->isDram()) {
+        if (pkt->pseudoChannel >= banks.size())
+            banks.resize(pkt->pseudoChannel + 1);
+        auto &channel = banks[pkt->pseudoChannel];
+        if (pkt->bankId >= channel.size())
+            channel.resize(pkt->bankId + 1);
+        channel[pkt->bankId].add(pkt);
+    }
+}
+
+void
+MemPacketQueue::removeFromBank(MemPacket* pkt)
+{
+    if (pkt->isDram())
+        banks[pkt->pseudoChannel][pkt->bankId].remove(pkt);
+}
+
+void
+MemPacketQueue::pop_front()
+{
+    removeFromBank(packets.front());
+    packets.pop_front();
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::erase(iterator it)
+{
+    removeFromBank(*it);
+    return packets.erase(it);
+}
+
+MemPacketQueue::iterator
+MemPacketQueue::find(const MemPacket* pkt)
+{
+    // the packets are sorted by position
+    auto it = std::lower_bound(packets.begin(), packets.end(), pkt,
+        [](const MemPacket* a, const MemPacket* b) {
+            return a->queueSeq < b->queueSeq;
+        });
+    assert(it != packets.end() && *it == pkt);
+    return it;
+}
+
 MemCtrl::MemCtrl(const MemCtrlParams &p) :
     qos::MemCtrl(p),
     port(name() + ".port", *this), isTimingMode(false),
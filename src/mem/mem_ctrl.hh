@@ -156,6 +156,12 @@ class MemPacket
      */
     uint8_t _qosValue;
 
+    /**
+     * Position in the MemPacketQueue holding the packet. Positions
+     * increase from the front to the back of a queue.
+     */
+    uint64_t queueSeq;
+
     /**
      * Set the packet QoS value
      * (interface compatibility with Packet)
@@ -210,14 +216,105 @@ class MemPacket
           _requestorId(pkt->requestorId()),
           read(is_read), dram(is_dram), pseudoChannel(_channel), rank(_rank),
           bank(_bank), row(_row), bankId(bank_id), addr(_addr), size(_size),
-          burstHelper(NULL), _qosValue(_pkt->qosValue())
+          burstHelper(NULL), _qosValue(_pkt->qosValue()), queueSeq(0)
     { }
 
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
+/**
+ * The memory packets are store in a multiple dequeue structure,
+ * based on their QoS priority. On top of the packets in arrival
+ * order, a queue indexes its DRAM packets by pseudo channel, bank and
+ * row, so that the FR-FCFS scheduler can look for row hits and
+ * available banks one bank at a time instead of one packet at a time.
+ */
+class MemPacketQueue
+{
+  public:
+    typedef std::deque<MemPacket*> Container;
+    typedef Container::iterator iterator;
+    typedef Container::const_iterator const_iterator;
+    typedef Container::size_type size_type;
+
+    /** The queued packets to one row of a bank, in queue order */
+    struct RowQueue
+    {
+        uint32_t row;
+        std::vector<MemPacket*> packets;
+    };
+
+    /**
+     * The queued packets to one bank. Only the first numRows row
+     * queues are in use, the others are kept to reuse their storage.
+     */
+    class BankQueue
+    {
+      private:
+        friend class MemPacketQueue;
+
+        std::vector<RowQueue> rows;
+        size_t numRows = 0;
+
+        RowQueue *findRow(uint32_t row);
+        void add(MemPacket* pkt);
+        void remove(MemPacket* pkt);
+
+      public:
+        bool empty() const { return numRows == 0; }
+
+        /** Oldest packet to the given row, if any */
+        MemPacket *oldestTo(uint32_t row) const;
+
+        /** Oldest packet to any row but the given one, if any */
+        MemPacket *oldestNotTo(uint32_t row) const;
+    };
+
+  private:
+    Container packets;
+
+    /** Bank queues of the DRAM packets, by pseudo channel and bank id */
+    std::vector<std::vector<BankQueue>> banks;
+
+    /** Position of the next packet added to the back */
+    uint64_t nextSeq;
+
+    void removeFromBank(MemPacket* pkt);
+
+  public:
+    MemPacketQueue() : nextSeq(0) {}
+
+    iterator begin() { return packets.begin(); }
+    iterator end() { return packets.end(); }
+    const_iterator begin() const { return packets.begin(); }
+    const_iterator end() const { return packets.end(); }
+
+    bool empty() const { return packets.empty(); }
+    size_type size() const { return packets.size(); }
+
+    MemPacket* front() const { return packets.front(); }
+    MemPacket* back() const { return packets.back(); }
+
+    void push_back(MemPacket* pkt);
+    void pop_front();
+    iterator erase(iterator it);
+
+    /** Find a packet of this queue */
+    iterator find(const MemPacket* pkt);
+
+    /**
+     * The queued DRAM packets to a bank, null if there never were
+     * any.
+     */
+    const BankQueue *
+    bankQueue(uint8_t pseudo_channel, uint16_t bank_id) const
+    {
+        if (pseudo_channel >= banks.size() ||
+            bank_id >= banks[pseudo_channel].size()) {
+            return nullptr;
+        }
+        return &banks[pseudo_channel][bank_id];
+    }
+};
 
 
 /**
@@ -486,7 +583,7 @@ class MemCtrl : public qos::MemCtrl
      * as sizing the read queue, this and the main read queue need to
      * be added together.
      */
-    std::deque<MemPacket*> respQueue;
+    MemPacketQueue respQueue;
 
     /**
      * Holds count of commands issued in burst window starting at
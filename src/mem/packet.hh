@@ -57,8 +57,10 @@
 #include "base/compiler.hh"
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/pool_allocator.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
+#include "config/use_packet_pools.hh"
 #include "mem/htm.hh"
 #include "mem/request.hh"
 #include "sim/byteswap.hh"
@@ -350,6 +352,9 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The dynamic data was taken from the payload pool rather than
+        /// allocated with new [] (see USE_PACKET_POOLS)
+        POOLED_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -1036,6 +1041,30 @@ class Packet : public Printable
         deleteData();
     }
 
+#if USE_PACKET_POOLS
+    /**
+     * Payloads up to this size come from a pool when packet pools are
+     * enabled. This covers the data of a cache line.
+     */
+    static const unsigned maxPooledDataSize = 64;
+
+    typedef FixedSizePool<maxPooledDataSize> DataPool;
+
+    /** Packets are taken from a per-thread free list. */
+    static void *
+    operator new(std::size_t size)
+    {
+        assert(size == sizeof(Packet));
+        return FixedSizePool<sizeof(Packet), alignof(Packet)>::allocate();
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        FixedSizePool<sizeof(Packet), alignof(Packet)>::deallocate(p);
+    }
+#endif
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1327,10 +1356,16 @@ class Packet : public Printable
     void
     deleteData()
     {
+#if USE_PACKET_POOLS
+        if (flags.isSet(POOLED_DATA)) {
+            DataPool::deallocate(data);
+            flags.clear(DYNAMIC_DATA);
+        }
+#endif
         if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|POOLED_DATA);
         data = NULL;
     }
 
@@ -1343,6 +1378,13 @@ class Packet : public Printable
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
+#if USE_PACKET_POOLS
+            if (getSize() <= maxPooledDataSize) {
+                flags.set(POOLED_DATA);
+                data = static_cast<PacketDataPtr>(DataPool::allocate());
+                return;
+            }
+#endif
             data = new uint8_t[getSize()];
         }
     }
@@ -47,6 +47,48 @@
 namespace gem5
 {
 
+void
+PacketQueue::DeferredPacketRing::grow()
+{
+    // keep the capacity a power of two so that slot() can mask
+    std::vector<DeferredPacket> new_slots(slots.empty() ? 8 :
+                                          2 * slots.size());
+    for (size_t i = 0; i < count; ++i)
+        new_slots[i] = (*this)[i];
+    slots.swap(new_slots);
+    head = 0;
+}
+
+void
+PacketQueue::DeferredPacketRing::push_front(const DeferredPacket &dp)
+{
+    if (count == slots.size())
+        grow();
+    head = (head - 1) & (slots.size() - 1);
+    ++count;
+    (*this)[0] = dp;
+}
+
+void
+PacketQueue::DeferredPacketRing::pop_front()
+{
+    assert(count > 0);
+    head = (head + 1) & (slots.size() - 1);
+    --count;
+}
+
+void
+PacketQueue::DeferredPacketRing::insert(size_t i, const DeferredPacket &dp)
+{
+    assert(i <= count);
+    if (count == slots.size())
+        grow();
+    for (size_t j = count; j > i; --j)
+        (*this)[j] = (*this)[j - 1];
+    ++count;
+    (*this)[i] = dp;
+}
+
 PacketQueue::PacketQueue(EventManager& _em, const std::string& _label,
                          const std::string& _sendEventName,
                          bool force_order,
@@ -76,8 +118,8 @@ PacketQueue::checkConflict(const PacketPtr pkt, const int blk_size) const
 {
     // caller is responsible for ensuring that all packets have the
     // same alignment
-    for (const auto& p : transmitList) {
-        if (p.pkt->matchBlockAddr(pkt, blk_size))
+    for (size_t i = 0; i < transmitList.size(); ++i) {
+        if (transmitList[i].pkt->matchBlockAddr(pkt, blk_size))
             return true;
     }
     return false;
@@ -88,14 +130,12 @@ PacketQueue::trySatisfyFunctional(PacketPtr pkt)
 {
     pkt->pushLabel(label);
 
-    auto i = transmitList.begin();
     bool found = false;
 
-    while (!found && i != transmitList.end()) {
+    for (size_t i = 0; !found && i < transmitList.size(); ++i) {
         // If the buffered packet contains data, and it overlaps the
         // current packet, then update data
-        found = pkt->trySatisfyFunctional(i->pkt);
-        ++i;
+        found = pkt->trySatisfyFunctional(transmitList[i].pkt);
     }
 
     pkt->popLabel();
@@ -135,19 +175,16 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when)
     // order by tick; however, if forceOrder is set, also make sure
     // not to re-order in front of some existing packet with the same
     // address
-    auto it = transmitList.end();
-    while (it != transmitList.begin()) {
-        --it;
-        if ((forceOrder && it->pkt->matchAddr(pkt)) || it->tick <= when) {
-            // emplace inserts the element before the position pointed to by
-            // the iterator, so advance it one step
-            transmitList.emplace(++it, when, pkt);
+    for (size_t i = transmitList.size(); i > 0; --i) {
+        const DeferredPacket &dp = transmitList[i - 1];
+        if ((forceOrder && dp.pkt->matchAddr(pkt)) || dp.tick <= when) {
+            transmitList.insert(i, DeferredPacket(when, pkt));
             return;
         }
     }
     // either the packet list is empty or this has to be inserted
     // before every other packet
-    transmitList.emplace_front(when, pkt);
+    transmitList.push_front(DeferredPacket(when, pkt));
     schedSendEvent(when);
 }
 
@@ -213,7 +250,7 @@ PacketQueue::sendDeferredPacket()
         schedSendEvent(deferredPacketReadyTime());
     } else {
         // put the packet back at the front of the list
-        transmitList.emplace_front(dp);
+        transmitList.push_front(dp);
     }
 }
 
@@ -49,7 +49,7 @@
  * for the flow control of the port.
  */
 
-#include <list>
+#include <vector>
 
 #include "mem/port.hh"
 #include "sim/drain.hh"
@@ -71,15 +71,55 @@ class PacketQueue : public Drainable
       public:
         Tick tick;      ///< The tick when the packet is ready to transmit
         PacketPtr pkt;  ///< Pointer to the packet to transmit
+        DeferredPacket() : tick(0), pkt(nullptr) {}
         DeferredPacket(Tick t, PacketPtr p)
             : tick(t), pkt(p)
         {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
+    /**
+     * The deferred packets in transmission order, held in a ring
+     * buffer that doubles in size when full. Packets are mostly added
+     * at the back and taken from the front; inserting one in the middle
+     * moves the packets behind it, which is cheap as the sanity check
+     * keeps queues short. Unlike a list, the ring does not allocate
+     * for every packet, and searches walk contiguous memory.
+     */
+    class DeferredPacketRing
+    {
+      private:
+        std::vector<DeferredPacket> slots;
+        size_t head;
+        size_t count;
+
+        size_t slot(size_t i) const { return (head + i) & (slots.size() - 1); }
+
+        void grow();
+
+      public:
+        DeferredPacketRing() : head(0), count(0) {}
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+        DeferredPacket &operator[](size_t i) { return slots[slot(i)]; }
+        const DeferredPacket &
+        operator[](size_t i) const
+        {
+            return slots[slot(i)];
+        }
+
+        const DeferredPacket &front() const { return (*this)[0]; }
+
+        void push_front(const DeferredPacket &dp);
+        void pop_front();
+
+        /** Insert a packet before the i-th one, or at the back. */
+        void insert(size_t i, const DeferredPacket &dp);
+    };
 
     /** A list of outgoing packets. */
-    DeferredPacketList transmitList;
+    DeferredPacketRing transmitList;
 
     /** The manager which is used for the event queue */
     EventManager& em;
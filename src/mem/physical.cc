@@ -80,11 +80,16 @@ PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
                                const std::string& shared_backstore,
-                               bool auto_unlink_shared_backstore) :
+                               bool auto_unlink_shared_backstore,
+                               const StoreCheckpointConfig& cpt_config) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
     sharedBackstore(shared_backstore), sharedBackstoreSize(0),
-    pageSize(sysconf(_SC_PAGE_SIZE))
+    pageSize(sysconf(_SC_PAGE_SIZE)), cptConfig(cpt_config)
 {
+    fatal_if(cptConfig.chunkSize % pageSize,
+             "The memory checkpoint chunk size (%d) must be a multiple of "
+             "the page size (%d)\n", cptConfig.chunkSize, pageSize);
+
     // Register cleanup callback if requested.
     if (auto_unlink_shared_backstore && !sharedBackstore.empty()) {
         registerExitCallback([=]() { shm_unlink(shared_backstore.c_str()); });
@@ -376,6 +381,14 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
 
+    if (cptConfig.chunkSize) {
+        std::string index_file = filename + ".idx";
+        SERIALIZE_SCALAR(index_file);
+        serializeStoreChunks(cptConfig, CheckpointIn::dir(), filename, pmem,
+                             range.size(), pageSize);
+        return;
+    }
+
     // write memory file
     std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
@@ -443,6 +456,22 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     std::string filepath = cp.getCptDir() + "/" + filename;
 
+    // Checkpoints without an index hold a single gzip stream
+    std::string index_file;
+    if (optParamIn(cp, "index_file", index_file, false)) {
+        const BackingStoreEntry &store = backingStore[store_id];
+        long range_size;
+        UNSERIALIZE_SCALAR(range_size);
+        fatal_if(range_size != store.range.size(),
+                 "Memory range size has changed! Saw %lld, expected %lld\n",
+                 range_size, store.range.size());
+
+        unserializeStoreChunks(cptConfig, cp.getCptDir() + "/" + index_file,
+                               store.pmem, store.range.size(), pageSize,
+                               store.shmFd >= 0);
+        return;
+    }
+
     // mmap memoryfile
     gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
     if (compressed_mem == NULL)
@@ -45,6 +45,7 @@
 #include "base/addr_range.hh"
 #include "base/addr_range_map.hh"
 #include "mem/packet.hh"
+#include "mem/store_checkpoint.hh"
 #include "sim/serialize.hh"
 
 namespace gem5
@@ -158,6 +159,8 @@ class PhysicalMemory : public Serializable
 
     long pageSize;
 
+    const StoreCheckpointConfig cptConfig;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -191,7 +194,8 @@ class PhysicalMemory : public Serializable
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
                    const std::string& shared_backstore,
-                   bool auto_unlink_shared_backstore);
+                   bool auto_unlink_shared_backstore,
+                   const StoreCheckpointConfig& cpt_config = {});
 
     /**
      * Unmap all the backing store we have used.
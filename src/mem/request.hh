@@ -54,12 +54,15 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
+#include "base/pool_allocator.hh"
 #include "base/types.hh"
+#include "config/use_packet_pools.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
 #include "sim/cur_tick.hh"
@@ -1102,6 +1105,24 @@ class Request
     /** @} */
 };
 
+/**
+ * Create a new request. This is equivalent to std::make_shared<Request>,
+ * but when packet pools are enabled (USE_PACKET_POOLS) the request and
+ * its shared_ptr control block are taken from a per-thread free list.
+ * Prefer it on paths that create a request per memory access.
+ */
+template <typename... Args>
+RequestPtr
+makeRequest(Args&&... args)
+{
+#if USE_PACKET_POOLS
+    return std::allocate_shared<Request>(PoolAllocator<Request>(),
+                                         std::forward<Args>(args)...);
+#else
+    return std::make_shared<Request>(std::forward<Args>(args)...);
+#endif
+}
+
 } // namespace gem5
 
 #endif // __MEM_REQUEST_HH__
@@ -52,17 +52,26 @@ Consumer::Consumer(ClockedObject *_em, Event::Priority ev_prio)
       em(_em)
 { }
 
+void
+Consumer::insertWakeupTick(Tick when)
+{
+    auto it = std::lower_bound(m_wakeup_ticks.begin(), m_wakeup_ticks.end(),
+                               when, std::greater<Tick>());
+    if (it == m_wakeup_ticks.end() || *it != when)
+        m_wakeup_ticks.insert(it, when);
+}
+
 void
 Consumer::scheduleEvent(Cycles timeDelta)
 {
-    m_wakeup_ticks.insert(em->clockEdge(timeDelta));
+    insertWakeupTick(em->clockEdge(timeDelta));
     scheduleNextWakeup();
 }
 
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
-    m_wakeup_ticks.insert(
+    insertWakeupTick(
         divCeil(evt_time, em->clockPeriod()) * em->clockPeriod());
     scheduleNextWakeup();
 }
@@ -70,9 +79,11 @@ Consumer::scheduleEventAbsolute(Tick evt_time)
 void
 Consumer::scheduleNextWakeup()
 {
-    // look for the next tick in the future to schedule
-    auto it = m_wakeup_ticks.lower_bound(em->clockEdge());
-    if (it != m_wakeup_ticks.end()) {
+    // look for the next tick in the future to schedule, walking the ticks
+    // from the earliest one
+    auto it = std::lower_bound(m_wakeup_ticks.rbegin(),
+                               m_wakeup_ticks.rend(), em->clockEdge());
+    if (it != m_wakeup_ticks.rend()) {
         Tick when = *it;
         assert(when >= em->clockEdge());
         if (m_wakeup_event.scheduled() && (when < m_wakeup_event.when()))
@@ -85,12 +96,11 @@ Consumer::scheduleNextWakeup()
 void
 Consumer::processCurrentEvent()
 {
-    auto curr = m_wakeup_ticks.begin();
-    assert(em->clockEdge() == *curr);
+    assert(em->clockEdge() == m_wakeup_ticks.back());
 
     // remove the current tick from the wakeup list, wake up, and then schedule
     // the next wakeup
-    m_wakeup_ticks.erase(curr);
+    m_wakeup_ticks.pop_back();
     wakeup();
     scheduleNextWakeup();
 }
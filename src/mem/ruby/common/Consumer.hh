@@ -47,8 +47,10 @@
 #ifndef __MEM_RUBY_COMMON_CONSUMER_HH__
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
-#include <set>
+#include <vector>
 
 #include "sim/clocked_object.hh"
 
@@ -75,7 +77,9 @@ class Consumer
     bool
     alreadyScheduled(Tick time)
     {
-        return m_wakeup_ticks.find(time) != m_wakeup_ticks.end();
+        return std::binary_search(m_wakeup_ticks.begin(),
+                                  m_wakeup_ticks.end(), time,
+                                  std::greater<Tick>());
     }
 
     ClockedObject *
@@ -88,10 +92,18 @@ class Consumer
     void scheduleEvent(Cycles timeDelta);
 
   private:
-    std::set<Tick> m_wakeup_ticks;
+    /**
+     * Pending wakeup ticks without duplicates, latest first. A consumer
+     * rarely has more than a few pending wakeups, and they are mostly
+     * added for the near future and removed from the earliest one, so a
+     * small vector with the earliest tick at the back is cheaper than a
+     * tree.
+     */
+    std::vector<Tick> m_wakeup_ticks;
     EventFunctionWrapper m_wakeup_event;
     ClockedObject *em;
 
+    void insertWakeupTick(Tick when);
     void scheduleNextWakeup();
     void processCurrentEvent();
 };
@@ -137,7 +137,7 @@ MessageBuffer::getSize(Tick curTime)
 {
     if (m_time_last_time_size_checked != curTime) {
         m_time_last_time_size_checked = curTime;
-        m_size_last_time_size_checked = m_prio_heap.size();
+        m_size_last_time_size_checked = numMessages();
     }
 
     return m_size_last_time_size_checked;
@@ -161,7 +161,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
 
     if (m_time_last_time_pop < current_time) {
         // no pops this cycle - heap and stall queue size is correct
-        current_size = m_prio_heap.size();
+        current_size = numMessages();
         current_stall_size = m_stall_map_size;
     } else {
         if (m_time_last_time_enqueue < current_time) {
@@ -184,7 +184,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
         DPRINTF(RubyQueue, "n: %d, current_size: %d, heap size: %d, "
                 "m_max_size: %d\n",
                 n, current_size + current_stall_size,
-                m_prio_heap.size(), m_max_size);
+                numMessages(), m_max_size);
         m_not_avail_count++;
         return false;
     }
@@ -194,7 +194,7 @@ const Message*
 MessageBuffer::peek() const
 {
     DPRINTF(RubyQueue, "Peeking at head of queue.\n");
-    const Message* msg_ptr = m_prio_heap.front().get();
+    const Message* msg_ptr = head().get();
     assert(msg_ptr);
 
     DPRINTF(RubyQueue, "Message: %s\n", (*msg_ptr));
@@ -277,14 +277,12 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     msg_ptr->setLastEnqueueTime(arrival_time);
     msg_ptr->setMsgCounter(m_msg_counter);
 
-    // Insert the message into the priority heap
-    m_prio_heap.push_back(message);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
+    insertMessage(message);
     // Increment the number of messages statistic
     m_buf_msgs++;
 
     assert((m_max_size == 0) ||
-           ((m_prio_heap.size() + m_stall_map_size) <= m_max_size));
+           ((numMessages() + m_stall_map_size) <= m_max_size));
 
     DPRINTF(RubyQueue, "Enqueue arrival_time: %lld, Message: %s\n",
             arrival_time, *(message.get()));
@@ -295,6 +293,36 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     m_consumer->storeEventInfo(m_vnet_id);
 }
 
+void
+MessageBuffer::insertMessage(const MsgPtr &message)
+{
+    // Append the message if it is the latest, which keeps m_in_order
+    // sorted without any search
+    if (m_in_order.empty() || message > m_in_order.back()) {
+        m_in_order.push_back(message);
+    } else {
+        m_prio_heap.push_back(message);
+        std::push_heap(m_prio_heap.begin(), m_prio_heap.end(),
+                       std::greater<MsgPtr>());
+    }
+}
+
+MsgPtr
+MessageBuffer::popHead()
+{
+    MsgPtr message;
+    if (headIsInOrder()) {
+        message = std::move(m_in_order.front());
+        m_in_order.pop_front();
+    } else {
+        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
+                      std::greater<MsgPtr>());
+        message = std::move(m_prio_heap.back());
+        m_prio_heap.pop_back();
+    }
+    return message;
+}
+
 Tick
 MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 {
@@ -302,7 +330,7 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     assert(isReady(current_time));
 
     // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = head();
 
     // get the delay cycles
     message->updateDelayedTicks(current_time);
@@ -311,15 +339,14 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     // record previous size and time so the current buffer size isn't
     // adjusted until schd cycle
     if (m_time_last_time_pop < current_time) {
-        m_size_at_cycle_start = m_prio_heap.size();
+        m_size_at_cycle_start = numMessages();
         m_stalled_at_cycle_start = m_stall_map_size;
         m_time_last_time_pop = current_time;
         m_dequeues_this_cy = 0;
     }
     ++m_dequeues_this_cy;
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
-    m_prio_heap.pop_back();
+    popHead();
     if (decrement_messages) {
         // Record how much time is passed since the message was enqueued
         m_stall_time += curTick() - message->getLastEnqueueTime();
@@ -353,6 +380,7 @@ MessageBuffer::unregisterDequeueCallback()
 void
 MessageBuffer::clear()
 {
+    m_in_order.clear();
     m_prio_heap.clear();
 
     m_msg_counter = 0;
@@ -368,35 +396,29 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 {
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady(current_time));
-    MsgPtr node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
+    MsgPtr node = popHead();
 
     Tick future_time = current_time + recycle_latency;
     node->setLastEnqueueTime(future_time);
 
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
+    insertMessage(node);
     m_consumer->scheduleEventAbsolute(future_time);
 }
 
 void
-MessageBuffer::reanalyzeList(std::list<MsgPtr> &lt, Tick schdTick)
+MessageBuffer::reanalyzeList(std::vector<MsgPtr> &lt, Tick schdTick)
 {
-    while (!lt.empty()) {
-        MsgPtr m = lt.front();
+    for (const MsgPtr &m : lt) {
         assert(m->getLastEnqueueTime() <= schdTick);
 
-        m_prio_heap.push_back(m);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  std::greater<MsgPtr>());
+        insertMessage(m);
 
         m_consumer->scheduleEventAbsolute(schdTick);
 
         DPRINTF(RubyQueue, "Requeue arrival_time: %lld, Message: %s\n",
             schdTick, *(m.get()));
-
-        lt.pop_front();
     }
+    lt.clear();
 }
 
 void
@@ -443,7 +465,7 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     DPRINTF(RubyQueue, "Stalling due to %#x\n", addr);
     assert(isReady(current_time));
     assert(getOffset(addr) == 0);
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = head();
 
     // Since the message will just be moved to stall map, indicate that the
     // buffer should not decrement the m_buf_msgs statistic
@@ -503,8 +525,10 @@ MessageBuffer::print(std::ostream& out) const
         ccprintf(out, " consumer-yes ");
     }
 
-    std::vector<MsgPtr> copy(m_prio_heap);
-    std::sort_heap(copy.begin(), copy.end(), std::greater<MsgPtr>());
+    std::vector<MsgPtr> copy(m_in_order.begin(), m_in_order.end());
+    copy.insert(copy.end(), m_prio_heap.begin(), m_prio_heap.end());
+    // Latest first, as sort_heap over the whole heap used to list them
+    std::sort(copy.begin(), copy.end(), std::greater<MsgPtr>());
     ccprintf(out, "%s] %s", copy, name());
 }
 
@@ -515,8 +539,8 @@ MessageBuffer::isReady(Tick current_time) const
     bool can_dequeue = (m_max_dequeue_rate == 0) ||
                        (m_time_last_time_pop < current_time) ||
                        (m_dequeues_this_cy < m_max_dequeue_rate);
-    bool is_ready = (m_prio_heap.size() > 0) &&
-                   (m_prio_heap.front()->getLastEnqueueTime() <= current_time);
+    bool is_ready = (numMessages() > 0) &&
+                   (head()->getLastEnqueueTime() <= current_time);
     if (!can_dequeue && is_ready) {
         // Make sure the Consumer executes next cycle to dequeue the ready msg
         m_consumer->scheduleEvent(Cycles(1));
@@ -527,10 +551,10 @@ MessageBuffer::isReady(Tick current_time) const
 Tick
 MessageBuffer::readyTime() const
 {
-    if (m_prio_heap.empty())
+    if (isEmpty())
         return MaxTick;
     else
-        return m_prio_heap.front()->getLastEnqueueTime();
+        return head()->getLastEnqueueTime();
 }
 
 uint32_t
@@ -541,10 +565,11 @@ MessageBuffer::functionalAccess(Packet *pkt, bool is_read, WriteMask *mask)
 
     uint32_t num_functional_accesses = 0;
 
-    // Check the priority heap and write any messages that may
+    // Check the buffered messages and write any messages that may
     // correspond to the address in the packet.
-    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
-        Message *msg = m_prio_heap[i].get();
+    for (unsigned int i = 0; i < numMessages(); ++i) {
+        Message *msg = (i < m_in_order.size()) ? m_in_order[i].get() :
+            m_prio_heap[i - m_in_order.size()].get();
         if (is_read && !mask && msg->functionalRead(pkt))
             return 1;
         else if (is_read && mask && msg->functionalRead(pkt, *mask))
@@ -559,7 +584,7 @@ MessageBuffer::functionalAccess(Packet *pkt, bool is_read, WriteMask *mask)
          map_iter != m_stall_msg_map.end();
          ++map_iter) {
 
-        for (std::list<MsgPtr>::iterator it = (map_iter->second).begin();
+        for (std::vector<MsgPtr>::iterator it = (map_iter->second).begin();
             it != (map_iter->second).end(); ++it) {
 
             Message *msg = (*it).get();
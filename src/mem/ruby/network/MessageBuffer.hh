@@ -48,6 +48,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <string>
@@ -92,10 +93,7 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        MsgPtr m = popHead();
         enqueue(m, current_time, delta);
     }
 
@@ -121,7 +119,7 @@ class MessageBuffer : public SimObject
     //! message queue.  The function assumes that the queue is nonempty.
     const Message* peek() const;
 
-    const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
+    const MsgPtr &peekMsgPtr() const { return head(); }
 
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
@@ -145,7 +143,7 @@ class MessageBuffer : public SimObject
     void unregisterDequeueCallback();
 
     void recycle(Tick current_time, Tick recycle_latency);
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool isEmpty() const { return numMessages() == 0; }
     bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
@@ -193,7 +191,32 @@ class MessageBuffer : public SimObject
     int routingPriority() const { return m_routing_priority; }
 
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    void reanalyzeList(std::vector<MsgPtr> &, Tick);
+
+    /** Number of messages in m_in_order and m_prio_heap. */
+    std::size_t
+    numMessages() const
+    {
+        return m_in_order.size() + m_prio_heap.size();
+    }
+
+    /** Check if the head of the buffer is the front of m_in_order. */
+    bool
+    headIsInOrder() const
+    {
+        return m_prio_heap.empty() ||
+            (!m_in_order.empty() && m_prio_heap.front() > m_in_order.front());
+    }
+
+    /** The message with the earliest arrival time. */
+    const MsgPtr &
+    head() const
+    {
+        return headIsInOrder() ? m_in_order.front() : m_prio_heap.front();
+    }
+
+    void insertMessage(const MsgPtr &message);
+    MsgPtr popHead();
 
     uint32_t functionalAccess(Packet *pkt, bool is_read, WriteMask *mask);
 
@@ -201,25 +224,36 @@ class MessageBuffer : public SimObject
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+
+    /**
+     * The messages in the buffer, ordered by arrival time and then by
+     * enqueue order (see operator> on MsgPtr). Messages mostly arrive no
+     * earlier than the ones already buffered, so they are appended to
+     * m_in_order, which stays sorted. The others, e.g. messages with a
+     * random latency or messages put back from the stall map, go to the
+     * m_prio_heap min-heap. The head of the buffer is the earlier of the
+     * two fronts.
+     */
+    std::deque<MsgPtr> m_in_order;
     std::vector<MsgPtr> m_prio_heap;
 
     std::function<void()> m_dequeue_callback;
 
     // use a std::map for the stalled messages as this container is
     // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    typedef std::map<Addr, std::vector<MsgPtr> > StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
      * If this buffer allows the receiver to stall messages, on a stall
-     * request, the stalled message is removed from the m_prio_heap and placed
+     * request, the stalled message is removed from the buffer and placed
      * in the m_stall_msg_map. Messages are held there until the receiver
      * requests they be reanalyzed, at which point they are moved back to
-     * m_prio_heap.
+     * the buffer.
      *
      * NOTE: The stall map holds messages in the order in which they were
      * initially received, and when a line is unblocked, the messages are
-     * moved back to the m_prio_heap in the same order. This prevents starving
+     * moved back to the buffer in the same order. This prevents starving
      * older requests with younger ones.
      */
     StallMsgMapType m_stall_msg_map;
@@ -236,7 +270,7 @@ class MessageBuffer : public SimObject
      * Current size of the stall map.
      * Track the number of messages held in stall map lists. This is used to
      * ensure that if the buffer is finite-sized, it blocks further requests
-     * when the m_prio_heap and m_stall_msg_map contain m_max_size messages.
+     * when the buffer and m_stall_msg_map contain m_max_size messages.
      */
     int m_stall_map_size;
 
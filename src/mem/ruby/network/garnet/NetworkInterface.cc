@@ -618,7 +618,8 @@ NetworkInterface::get_vnet(int vc)
 
 // Wakeup the NI in the next cycle if there are waiting
 // messages in the protocol buffer, or waiting flits in the
-// output VC buffer.
+// output VC buffer that have credits to leave. Flits stalled
+// on credits are sent when the credit arrives and wakes the NI.
 // Also check if we have to reschedule because of a clock period
 // difference.
 void
@@ -635,8 +636,9 @@ NetworkInterface::checkReschedule()
         }
     }
 
-    for (auto& ni_out_vc : niOutVcs) {
-        if (ni_out_vc.isReady(clockEdge(Cycles(1)))) {
+    for (int vc = 0; vc < niOutVcs.size(); vc++) {
+        if (niOutVcs[vc].isReady(clockEdge(Cycles(1))) &&
+            outVcState[vc].has_credit()) {
             scheduleEvent(Cycles(1));
             return;
         }
@@ -141,8 +141,10 @@ OutputUnit::wakeup()
 
         delete t_credit;
 
+        // The router only re-runs switch allocation for flits
+        // stalled on credits when it is woken up
         if (m_credit_link->isReady(curTick())) {
-            scheduleEvent(Cycles(1));
+            m_router->schedule_wakeup(Cycles(1));
         }
     }
 }
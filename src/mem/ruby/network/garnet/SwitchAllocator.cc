@@ -351,8 +351,24 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
     return outvc;
 }
 
+// Check if the flit in an input VC has an output VC and credits to
+// leave the router. Flits without them can only proceed after a credit
+// arrives, which wakes the router up.
+bool
+SwitchAllocator::has_resources(int inport, int invc)
+{
+    auto input_unit = m_router->getInputUnit(inport);
+    auto output_unit = m_router->getOutputUnit(input_unit->get_outport(invc));
+    int outvc = input_unit->get_outvc(invc);
+
+    if (outvc == -1)
+        return output_unit->has_free_vc(get_vnet(invc));
+    return output_unit->has_credit(outvc);
+}
+
 // Wakeup the router next cycle to perform SA again
-// if there are flits ready.
+// if there are flits ready that can be sent. Flits stalled
+// on credits do not keep the router awake.
 void
 SwitchAllocator::check_for_wakeup()
 {
@@ -364,7 +380,8 @@ SwitchAllocator::check_for_wakeup()
 
     for (int i = 0; i < m_num_inports; i++) {
         for (int j = 0; j < m_num_vcs; j++) {
-            if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle)) {
+            if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle) &&
+                has_resources(i, j)) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
             }
@@ -64,6 +64,7 @@ class SwitchAllocator : public Consumer
     void arbitrate_inports();
     void arbitrate_outports();
     bool send_allowed(int inport, int invc, int outport, int outvc);
+    bool has_resources(int inport, int invc);
     int vc_allocate(int outport, int inport, int invc);
 
     inline double
@@ -375,7 +375,7 @@ AbstractController::recvTimingResp(PacketPtr pkt)
     assert(getMemRespQueue());
     assert(pkt->isResponse());
 
-    std::shared_ptr<MemoryMsg> msg = std::make_shared<MemoryMsg>(clockEdge());
+    MsgRef<MemoryMsg> msg = makeMsg<MemoryMsg>(clockEdge());
     (*msg).m_addr = pkt->getAddr();
     (*msg).m_Sender = m_machineID;
 
@@ -41,10 +41,17 @@
 #ifndef __MEM_RUBY_SLICC_INTERFACE_MESSAGE_HH__
 #define __MEM_RUBY_SLICC_INTERFACE_MESSAGE_HH__
 
+#include <cassert>
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <stack>
+#include <utility>
 
+#include "base/pool_allocator.hh"
+#include "base/refcnt.hh"
+#include "config/use_intrusive_msg_refs.hh"
+#include "config/use_ruby_msg_pools.hh"
 #include "mem/packet.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/common/WriteMask.hh"
@@ -57,9 +64,47 @@ namespace ruby
 {
 
 class Message;
-typedef std::shared_ptr<Message> MsgPtr;
+
+/**
+ * Reference to a message. The references are std::shared_ptr unless
+ * USE_INTRUSIVE_MSG_REFS is set, in which case the count is kept in the
+ * message itself and updated without atomic operations. Ruby runs on a
+ * single event queue, so the messages are never shared between threads.
+ * Code that keeps references to messages of a specific type should use
+ * MsgRef rather than std::shared_ptr so that it builds with either.
+ */
+#if USE_INTRUSIVE_MSG_REFS
+template <class T>
+using MsgRef = RefCountingPtr<T>;
+#else
+template <class T>
+using MsgRef = std::shared_ptr<T>;
+#endif
+
+typedef MsgRef<Message> MsgPtr;
+
+/**
+ * Create a new message. With USE_RUBY_MSG_POOLS the message (and the
+ * shared_ptr control block, if any) comes from a per-thread free list.
+ */
+template <class T, typename... Args>
+MsgRef<T>
+makeMsg(Args&&... args)
+{
+#if USE_INTRUSIVE_MSG_REFS
+    return MsgRef<T>(new T(std::forward<Args>(args)...));
+#elif USE_RUBY_MSG_POOLS
+    return std::allocate_shared<T>(PoolAllocator<T>(),
+                                   std::forward<Args>(args)...);
+#else
+    return std::make_shared<T>(std::forward<Args>(args)...);
+#endif
+}
 
 class Message
+#if USE_INTRUSIVE_MSG_REFS
+    : public RefCounted
+#endif
 {
   public:
     Message(Tick curTime)
@@ -68,10 +113,69 @@ class Message
           m_DelayedTicks(0), m_msg_counter(0)
     { }
 
-    Message(const Message &other) = default;
+    // Written out rather than defaulted so that a copy of a message
+    // starts without references
+    Message(const Message &other)
+        : m_time(other.m_time),
+          m_LastEnqueueTime(other.m_LastEnqueueTime),
+          m_DelayedTicks(other.m_DelayedTicks),
+          m_msg_counter(other.m_msg_counter),
+          incoming_link(other.incoming_link), vnet(other.vnet)
+    { }
+
+    Message &
+    operator=(const Message &other)
+    {
+        m_time = other.m_time;
+        m_LastEnqueueTime = other.m_LastEnqueueTime;
+        m_DelayedTicks = other.m_DelayedTicks;
+        m_msg_counter = other.m_msg_counter;
+        incoming_link = other.incoming_link;
+        vnet = other.vnet;
+        return *this;
+    }
 
     virtual ~Message() { }
 
+#if USE_RUBY_MSG_POOLS
+    /**
+     * Messages that are allocated with new, e.g. by clone(), come from
+     * free lists of 64B size classes. The sized delete gets the size of
+     * the most derived message, since the destructor is virtual.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        switch ((size + poolGranularity - 1) / poolGranularity) {
+          case 1: return FixedSizePool<1 * poolGranularity>::allocate();
+          case 2: return FixedSizePool<2 * poolGranularity>::allocate();
+          case 3: return FixedSizePool<3 * poolGranularity>::allocate();
+          case 4: return FixedSizePool<4 * poolGranularity>::allocate();
+          case 5: return FixedSizePool<5 * poolGranularity>::allocate();
+          case 6: return FixedSizePool<6 * poolGranularity>::allocate();
+          case 7: return FixedSizePool<7 * poolGranularity>::allocate();
+          case 8: return FixedSizePool<8 * poolGranularity>::allocate();
+          default: return ::operator new(size);
+        }
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        switch ((size + poolGranularity - 1) / poolGranularity) {
+          case 1: FixedSizePool<1 * poolGranularity>::deallocate(p); break;
+          case 2: FixedSizePool<2 * poolGranularity>::deallocate(p); break;
+          case 3: FixedSizePool<3 * poolGranularity>::deallocate(p); break;
+          case 4: FixedSizePool<4 * poolGranularity>::deallocate(p); break;
+          case 5: FixedSizePool<5 * poolGranularity>::deallocate(p); break;
+          case 6: FixedSizePool<6 * poolGranularity>::deallocate(p); break;
+          case 7: FixedSizePool<7 * poolGranularity>::deallocate(p); break;
+          case 8: FixedSizePool<8 * poolGranularity>::deallocate(p); break;
+          default: ::operator delete(p);
+        }
+    }
+#endif
+
     virtual MsgPtr clone() const = 0;
     virtual void print(std::ostream& out) const = 0;
 
@@ -122,6 +226,11 @@ class Message
     void setVnet(int net) { vnet = net; }
 
   private:
+#if USE_RUBY_MSG_POOLS
+    /** Size classes of the message free lists. */
+    static const std::size_t poolGranularity = 64;
+#endif
+
     Tick m_time;
     Tick m_LastEnqueueTime; // my last enqueue time
     Tick m_DelayedTicks; // my delayed cycles
@@ -144,6 +253,15 @@ operator>(const MsgPtr &lhs, const MsgPtr &rhs)
     return l->getLastEnqueueTime() > r->getLastEnqueueTime();
 }
 
+#if USE_INTRUSIVE_MSG_REFS
+/** Print the address of a message, like std::shared_ptr does. */
+inline std::ostream&
+operator<<(std::ostream& out, const MsgPtr& obj)
+{
+    return out << obj.get();
+}
+#endif
+
 inline std::ostream&
 operator<<(std::ostream& out, const Message& obj)
 {
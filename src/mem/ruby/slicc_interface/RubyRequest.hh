@@ -181,7 +181,7 @@ class RubyRequest : public Message
 
     RubyRequest(Tick curTime) : Message(curTime) {}
     MsgPtr clone() const
-    { return std::shared_ptr<Message>(new RubyRequest(*this)); }
+    { return makeMsg<RubyRequest>(*this); }
 
     Addr getLineAddress() const { return m_LineAddress; }
     Addr getPhysicalAddress() const { return m_PhysicalAddress; }
@@ -881,12 +881,12 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
 
     // check if the packet has data as for example prefetch and flush
     // requests do not
-    std::shared_ptr<RubyRequest> msg;
+    MsgRef<RubyRequest> msg;
     if (pkt->req->isMemMgmt()) {
-        msg = std::make_shared<RubyRequest>(clockEdge(),
-                                            pc, secondary_type,
-                                            RubyAccessMode_Supervisor, pkt,
-                                            proc_id, core_id);
+        msg = makeMsg<RubyRequest>(clockEdge(),
+                                   pc, secondary_type,
+                                   RubyAccessMode_Supervisor, pkt,
+                                   proc_id, core_id);
 
         DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %s\n",
                 curTick(), m_version, "Seq", "Begin", "", "",
@@ -910,10 +910,10 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
                     msg->m_tlbiTransactionUid);
         }
     } else {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                            pkt->getSize(), pc, secondary_type,
-                                            RubyAccessMode_Supervisor, pkt,
-                                            PrefetchBit_No, proc_id, core_id);
+        msg = makeMsg<RubyRequest>(clockEdge(), pkt->getAddr(),
+                                   pkt->getSize(), pc, secondary_type,
+                                   RubyAccessMode_Supervisor, pkt,
+                                   PrefetchBit_No, proc_id, core_id);
 
         DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
                 curTick(), m_version, "Seq", "Begin", "", "",
@@ -56,8 +56,8 @@ class DeferEnqueueingStatementAST(StatementAST):
         self.symtab.newSymbol(v)
 
         # Declare message
-        code("std::shared_ptr<${{msg_type.c_ident}}> out_msg = "\
-             "std::make_shared<${{msg_type.c_ident}}>(clockEdge());")
+        code("MsgRef<${{msg_type.c_ident}}> out_msg = "\
+             "makeMsg<${{msg_type.c_ident}}>(clockEdge());")
 
         # The other statements
         t = self.statements.generate(code, None)
@@ -55,8 +55,8 @@ class EnqueueStatementAST(StatementAST):
         self.symtab.newSymbol(v)
 
         # Declare message
-        code("std::shared_ptr<${{msg_type.c_ident}}> out_msg = "\
-             "std::make_shared<${{msg_type.c_ident}}>(clockEdge());")
+        code("MsgRef<${{msg_type.c_ident}}> out_msg = "\
+             "makeMsg<${{msg_type.c_ident}}>(clockEdge());")
 
         # The other statements
         t = self.statements.generate(code, None)
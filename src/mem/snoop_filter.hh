@@ -44,9 +44,9 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
 #include <utility>
 
+#include "base/flat_hash_map.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
@@ -221,9 +221,10 @@ class SnoopFilter : public SimObject
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * HashMap of SnoopItems indexed by line address. It is searched on
+     * every coherent request, so it is kept in a flat table.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    typedef FlatHashMap<Addr, SnoopItem> SnoopFilterCache;
 
     /**
      * Simple factory methods for standard return values.
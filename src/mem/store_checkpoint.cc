@@ -0,0 +1,471 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/store_checkpoint.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/str.hh"
+#include "base/trace.hh"
+#include "debug/Checkpoint.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+bool
+StoreIndex::read(const std::string &path)
+{
+    std::ifstream is(path, std::ios::binary);
+    char magic[sizeof(Magic)];
+    uint32_t version, num_files;
+    uint64_t num_chunks;
+    if (!is.read(magic, sizeof(magic)) ||
+            memcmp(magic, Magic, sizeof(magic)) ||
+            !is.read((char *)&version, sizeof(version)) ||
+            version != Version ||
+            !is.read((char *)&chunkSize, sizeof(chunkSize)) ||
+            !is.read((char *)&storeSize, sizeof(storeSize)) ||
+            !is.read((char *)&num_files, sizeof(num_files))) {
+        return false;
+    }
+
+    files.resize(num_files);
+    for (auto &file : files) {
+        uint32_t len;
+        if (!is.read((char *)&len, sizeof(len)))
+            return false;
+        file.resize(len);
+        if (!is.read(&file[0], len))
+            return false;
+    }
+
+    if (!is.read((char *)&num_chunks, sizeof(num_chunks)))
+        return false;
+    chunks.resize(num_chunks);
+    return bool(is.read((char *)chunks.data(),
+                        num_chunks * sizeof(Chunk)));
+}
+
+bool
+StoreIndex::write(const std::string &path) const
+{
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    uint32_t num_files = files.size();
+    uint64_t num_chunks = chunks.size();
+    os.write(Magic, sizeof(Magic));
+    os.write((const char *)&Version, sizeof(Version));
+    os.write((const char *)&chunkSize, sizeof(chunkSize));
+    os.write((const char *)&storeSize, sizeof(storeSize));
+    os.write((const char *)&num_files, sizeof(num_files));
+    for (const auto &file : files) {
+        uint32_t len = file.size();
+        os.write((const char *)&len, sizeof(len));
+        os.write(file.data(), len);
+    }
+    os.write((const char *)&num_chunks, sizeof(num_chunks));
+    os.write((const char *)chunks.data(), num_chunks * sizeof(Chunk));
+    return bool(os.flush());
+}
+
+namespace
+{
+
+/**
+ * Hash of the contents of a chunk. Together with the CRC, it identifies
+ * unchanged chunks for incremental checkpoints.
+ */
+uint64_t
+hashChunk(const uint8_t *data, uint64_t len)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ len;
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, data + i, sizeof(w));
+        h = (h ^ (w * 0xff51afd7ed558ccdULL)) * 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 29;
+    }
+    for (; i < len; ++i)
+        h = (h ^ data[i]) * 0x100000001b3ULL;
+    return h;
+}
+
+bool
+isZero(const uint8_t *data, uint64_t len)
+{
+    for (uint64_t i = 0; i < len; i += sizeof(uint64_t)) {
+        uint64_t w = 0;
+        memcpy(&w, data + i, std::min<uint64_t>(sizeof(w), len - i));
+        if (w)
+            return false;
+    }
+    return true;
+}
+
+/** Call f(i) for i in [0, n) on a number of threads. */
+template <typename F>
+void
+parallelFor(size_t n, unsigned threads, F f)
+{
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < n; i = next++)
+            f(i);
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<size_t>(threads, n); ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool)
+        t.join();
+}
+
+bool
+writeAll(int fd, const uint8_t *data, uint64_t len, uint64_t offset)
+{
+    while (len) {
+        ssize_t n = pwrite(fd, data, std::min<uint64_t>(len, INT_MAX),
+                           offset);
+        if (n <= 0)
+            return false;
+        data += n;
+        len -= n;
+        offset += n;
+    }
+    return true;
+}
+
+bool
+readAll(int fd, uint8_t *data, uint64_t len, uint64_t offset)
+{
+    while (len) {
+        ssize_t n = pread(fd, data, std::min<uint64_t>(len, INT_MAX),
+                          offset);
+        if (n <= 0)
+            return false;
+        data += n;
+        len -= n;
+        offset += n;
+    }
+    return true;
+}
+
+std::string
+dirName(const std::string &path)
+{
+    auto pos = path.rfind('/');
+    return pos == std::string::npos ? "." : path.substr(0, pos);
+}
+
+/** Canonical absolute path of an existing file or directory. */
+std::string
+realPath(const std::string &path)
+{
+    char *real = realpath(path.c_str(), nullptr);
+    fatal_if(!real, "Can't find checkpoint file '%s'\n", path);
+    std::string result(real);
+    free(real);
+    return result;
+}
+
+/** Path of the canonical path 'path' relative to the directory 'from'. */
+std::string
+relativePath(const std::string &from, const std::string &path)
+{
+    std::vector<std::string> from_parts, path_parts;
+    tokenize(from_parts, from, '/');
+    tokenize(path_parts, path, '/');
+
+    size_t common = 0;
+    while (common < from_parts.size() && common < path_parts.size() - 1 &&
+           from_parts[common] == path_parts[common]) {
+        ++common;
+    }
+
+    std::string result;
+    for (size_t i = common; i < from_parts.size(); ++i)
+        result += "../";
+    for (size_t i = common; i < path_parts.size(); ++i)
+        result += path_parts[i] + (i + 1 < path_parts.size() ? "/" : "");
+    return result;
+}
+
+} // anonymous namespace
+
+void
+serializeStoreChunks(const StoreCheckpointConfig &config,
+                     const std::string &dir, const std::string &filename,
+                     const uint8_t *pmem, uint64_t store_size,
+                     long page_size)
+{
+    const uint64_t chunk_size = config.chunkSize;
+    const unsigned threads = config.threads ? config.threads :
+        std::max(1U, std::thread::hardware_concurrency());
+
+    StoreIndex index;
+    index.chunkSize = chunk_size;
+    index.storeSize = store_size;
+    index.files.push_back(filename);
+    index.chunks.resize(divCeil(store_size, chunk_size));
+
+    // Chunks that have not changed since the base checkpoint refer to
+    // the data files of the base checkpoint, by a path relative to this
+    // checkpoint, so the two can be moved together
+    StoreIndex base;
+    std::vector<int> base_files;
+    if (!config.base.empty()) {
+        std::string base_index = config.base + "/" + filename + ".idx";
+        if (!base.read(base_index) || base.chunkSize != chunk_size ||
+                base.storeSize != store_size) {
+            warn("Cannot use %s as the base of %s, writing all of it\n",
+                 base_index, filename);
+            base.chunks.clear();
+        }
+        const std::string real_dir = realPath(dir);
+        for (const auto &file : base.files) {
+            std::string path = file;
+            if (file.empty() || file[0] != '/') {
+                path = relativePath(real_dir,
+                                    realPath(config.base + "/" + file));
+            }
+            base_files.push_back(-1);
+            for (size_t f = 0; f < index.files.size(); ++f) {
+                if (index.files[f] == path)
+                    base_files.back() = f;
+            }
+            if (base_files.back() < 0) {
+                base_files.back() = index.files.size();
+                index.files.push_back(path);
+            }
+        }
+    }
+
+    std::string filepath = dir + "/" + filename;
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filename);
+
+    // Compress a batch of chunks in parallel, then append them to the
+    // file in order
+    const size_t batch = 4 * threads;
+    uint64_t offset = 0;
+    uint64_t reused = 0;
+    std::vector<std::vector<uint8_t>> compressed(batch);
+    for (size_t first = 0; first < index.chunks.size(); first += batch) {
+        size_t count = std::min(batch, index.chunks.size() - first);
+        std::vector<char> from_base(count, false);
+
+        parallelFor(count, threads, [&](size_t j) {
+            const size_t i = first + j;
+            const uint8_t *data = pmem + i * chunk_size;
+            const uint64_t len = std::min(chunk_size,
+                                          store_size - i * chunk_size);
+            StoreIndex::Chunk &chunk = index.chunks[i];
+            chunk = StoreIndex::Chunk();
+            compressed[j].clear();
+
+            if (isZero(data, len)) {
+                chunk.flags = StoreIndex::ChunkZero;
+                return;
+            }
+
+            chunk.hash = hashChunk(data, len);
+            chunk.crc = crc32(crc32(0L, Z_NULL, 0), data, len);
+            if (!base.chunks.empty()) {
+                const StoreIndex::Chunk &prev = base.chunks[i];
+                if (!(prev.flags & StoreIndex::ChunkZero) &&
+                        prev.hash == chunk.hash && prev.crc == chunk.crc) {
+                    chunk = prev;
+                    from_base[j] = true;
+                    return;
+                }
+            }
+
+            if (config.compression != 0) {
+                uLongf out_len = compressBound(len);
+                compressed[j].resize(out_len);
+                if (compress2(compressed[j].data(), &out_len, data, len,
+                              config.compression) == Z_OK &&
+                        out_len < len) {
+                    compressed[j].resize(out_len);
+                    return;
+                }
+                compressed[j].clear();
+            }
+            chunk.flags = StoreIndex::ChunkRaw;
+        });
+
+        for (size_t j = 0; j < count; ++j) {
+            const size_t i = first + j;
+            StoreIndex::Chunk &chunk = index.chunks[i];
+            if (from_base[j]) {
+                chunk.file = base_files.at(chunk.file);
+                ++reused;
+                continue;
+            }
+            if (chunk.flags & StoreIndex::ChunkZero)
+                continue;
+
+            const uint8_t *data;
+            uint64_t len;
+            if (chunk.flags & StoreIndex::ChunkRaw) {
+                // Keep raw chunks page aligned so they can be mapped
+                offset = roundUp(offset, page_size);
+                data = pmem + i * chunk_size;
+                len = std::min(chunk_size, store_size - i * chunk_size);
+            } else {
+                data = compressed[j].data();
+                len = compressed[j].size();
+            }
+
+            if (!writeAll(fd, data, len, offset))
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s'\n", filename);
+            chunk.file = 0;
+            chunk.offset = offset;
+            chunk.length = len;
+            offset += len;
+        }
+    }
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filename);
+
+    if (!index.write(filepath + ".idx"))
+        fatal("Write failed on physical memory checkpoint index '%s.idx'\n",
+              filename);
+
+    DPRINTF(Checkpoint, "Wrote %d chunks of %s, %d bytes, %d chunks from "
+            "the base checkpoint\n", index.chunks.size(), filename, offset,
+            reused);
+}
+
+void
+unserializeStoreChunks(const StoreCheckpointConfig &config,
+                       const std::string &index_path, uint8_t *pmem,
+                       uint64_t store_size, long page_size, bool shared)
+{
+    StoreIndex index;
+    fatal_if(!index.read(index_path),
+             "Can't read physical memory checkpoint index '%s'\n",
+             index_path);
+    fatal_if(index.storeSize != store_size,
+             "Checkpoint index '%s' is for a store of %d bytes, "
+             "expected %d\n", index_path, index.storeSize,
+             store_size);
+
+    const std::string dir = dirName(index_path);
+    std::vector<int> fds;
+    for (const auto &file : index.files) {
+        std::string path = file[0] == '/' ? file : dir + "/" + file;
+        fds.push_back(open(path.c_str(), O_RDONLY));
+        fatal_if(fds.back() < 0,
+                 "Can't open physical memory checkpoint file '%s'\n", path);
+    }
+
+    // Mapping the data privately would break the sharing of a shared
+    // backing store
+    bool lazy = config.lazyRestore;
+    if (lazy && shared) {
+        warn_once("Not mapping checkpointed memory lazily into a shared "
+                  "backing store\n");
+        lazy = false;
+    }
+
+    const uint64_t chunk_size = index.chunkSize;
+    const unsigned threads = config.threads ? config.threads :
+        std::max(1U, std::thread::hardware_concurrency());
+    std::atomic<bool> failed(false);
+    std::atomic<uint64_t> mapped(0);
+
+    parallelFor(index.chunks.size(), threads, [&](size_t i) {
+        const StoreIndex::Chunk &chunk = index.chunks[i];
+        uint8_t *data = pmem + i * chunk_size;
+        const uint64_t len = std::min(chunk_size,
+                                      index.storeSize - i * chunk_size);
+        if (chunk.flags & StoreIndex::ChunkZero) {
+            // Reading fresh anonymous memory does not allocate it, so
+            // only clear the chunk if it isn't zero already
+            if (!isZero(data, len))
+                memset(data, 0, len);
+            return;
+        }
+
+        int fd = fds.at(chunk.file);
+        if (chunk.flags & StoreIndex::ChunkRaw) {
+            if (lazy && chunk.offset % page_size == 0 &&
+                    mmap(data, len, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_FIXED, fd, chunk.offset) !=
+                    MAP_FAILED) {
+                mapped += len;
+                return;
+            }
+            if (chunk.length != len ||
+                    !readAll(fd, data, len, chunk.offset)) {
+                failed = true;
+            }
+            return;
+        }
+
+        std::vector<uint8_t> in(chunk.length);
+        uLongf out_len = len;
+        if (!readAll(fd, in.data(), in.size(), chunk.offset) ||
+                uncompress(data, &out_len, in.data(), in.size()) != Z_OK ||
+                out_len != len) {
+            failed = true;
+        }
+    });
+
+    for (int fd : fds)
+        close(fd);
+
+    fatal_if(failed, "Failed to restore physical memory from '%s'\n",
+             index_path);
+
+    DPRINTF(Checkpoint, "Restored %d chunks from %s, %d bytes mapped\n",
+            index.chunks.size(), index_path, mapped.load());
+}
+
+} // namespace memory
+} // namespace gem5
@@ -0,0 +1,154 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_STORE_CHECKPOINT_HH__
+#define __MEM_STORE_CHECKPOINT_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * How the backing store is written to and read from checkpoints.
+ *
+ * By default, each backing store is written as a single gzip stream. With
+ * a chunk size, it is instead split into chunks that are compressed
+ * independently (and in parallel) with zlib. An index file next to the
+ * data records, for each chunk, a hash of its contents and where it is
+ * stored. All-zero chunks are not written at all, and chunks that are
+ * identical to the same chunk of a base checkpoint refer to the data of
+ * the base checkpoint instead of being written again. Chunks that are
+ * not compressed are page aligned in the file and can be mapped on
+ * restore instead of being read.
+ */
+struct StoreCheckpointConfig
+{
+    /** Size of the independently compressed chunks, 0 for a single gzip
+     *  stream. Must be a multiple of the page size. */
+    uint64_t chunkSize = 0;
+
+    /** Number of threads to compress and decompress chunks, 0 for one per
+     *  host thread. */
+    unsigned threads = 0;
+
+    /** zlib compression level of the chunks, 0 to store them raw. */
+    int compression = 1;
+
+    /** Checkpoint directory to take unchanged chunks from, if any. The
+     *  new checkpoint refers to the data files of the base by a path
+     *  relative to itself, so the two must be moved or copied together,
+     *  keeping their relative location. */
+    std::string base;
+
+    /** Map raw chunks on restore, so that they are only paged in when
+     *  touched. */
+    bool lazyRestore = false;
+};
+
+/**
+ * Index of a backing store written in chunks. It is stored in a binary
+ * file next to the data, in host byte order.
+ */
+struct StoreIndex
+{
+    static constexpr char Magic[8] = {'g', 'e', 'm', '5', 'p', 'm', 'i', 0};
+    static constexpr uint32_t Version = 1;
+
+    enum : uint32_t
+    {
+        // The chunk is stored without compression
+        ChunkRaw = 1,
+        // The chunk is all zeros and is not stored
+        ChunkZero = 2
+    };
+
+    struct Chunk
+    {
+        uint64_t hash;
+        uint32_t crc;
+        uint32_t flags;
+        // Location of the data: a file of the index, and the offset and
+        // length in that file
+        uint32_t file;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    uint64_t chunkSize = 0;
+    uint64_t storeSize = 0;
+
+    // Data files, relative to the directory of the index unless they are
+    // absolute
+    std::vector<std::string> files;
+    std::vector<Chunk> chunks;
+
+    bool read(const std::string &path);
+    bool write(const std::string &path) const;
+};
+
+/**
+ * Write a backing store as independently compressed chunks, and the index
+ * of the chunks.
+ *
+ * @param config How to write the chunks
+ * @param dir Checkpoint directory
+ * @param filename Name of the data file in the checkpoint directory
+ * @param pmem The host pointer to the backing store
+ * @param size Size of the backing store
+ * @param page_size Host page size, which raw chunks are aligned to
+ */
+void serializeStoreChunks(const StoreCheckpointConfig &config,
+                          const std::string &dir,
+                          const std::string &filename,
+                          const uint8_t *pmem, uint64_t size,
+                          long page_size);
+
+/**
+ * Restore a backing store from the chunks of an index.
+ *
+ * @param config How to read the chunks
+ * @param index_path Path of the index
+ * @param pmem The host pointer to the backing store
+ * @param size Size of the backing store
+ * @param page_size Host page size
+ * @param shared Whether the backing store is shared, in which case it is
+ *               never mapped from the checkpoint
+ */
+void unserializeStoreChunks(const StoreCheckpointConfig &config,
+                            const std::string &index_path,
+                            uint8_t *pmem, uint64_t size,
+                            long page_size, bool shared);
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_STORE_CHECKPOINT_HH__
@@ -0,0 +1,207 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "mem/store_checkpoint.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+namespace
+{
+
+const uint64_t ChunkSize = 4096;
+const uint64_t StoreSize = 8 * ChunkSize;
+
+/** A temporary directory, removed with its contents on destruction. */
+class TempDir
+{
+  public:
+    TempDir()
+    {
+        char path[] = "/tmp/store_checkpoint.XXXXXX";
+        EXPECT_NE(mkdtemp(path), nullptr);
+        _path = path;
+    }
+
+    ~TempDir()
+    {
+        EXPECT_EQ(system(("rm -rf " + _path).c_str()), 0);
+    }
+
+    const std::string &path() const { return _path; }
+
+  private:
+    std::string _path;
+};
+
+/** A backing store with some data in it, and all-zero chunk 1. */
+std::vector<uint8_t>
+makeStore()
+{
+    std::vector<uint8_t> store(StoreSize);
+    for (uint64_t i = 0; i < StoreSize; ++i)
+        store[i] = i / ChunkSize == 1 ? 0 : (i * 7) ^ (i >> 8);
+    return store;
+}
+
+StoreCheckpointConfig
+makeConfig()
+{
+    StoreCheckpointConfig config;
+    config.chunkSize = ChunkSize;
+    config.threads = 2;
+    return config;
+}
+
+} // anonymous namespace
+
+/* An index reads back as it was written. */
+TEST(StoreCheckpointTest, IndexRoundTrip)
+{
+    TempDir dir;
+    StoreIndex index;
+    index.chunkSize = ChunkSize;
+    index.storeSize = 2 * ChunkSize;
+    index.files = {"store.pmem", "../base/store.pmem"};
+    index.chunks.resize(2);
+    index.chunks[0] = {0x1234, 0x5678, StoreIndex::ChunkRaw, 0, 0, 0,
+                       ChunkSize};
+    index.chunks[1] = {0x4321, 0x8765, 0, 1, 0, 8192, 100};
+    ASSERT_TRUE(index.write(dir.path() + "/store.pmem.idx"));
+
+    StoreIndex read;
+    ASSERT_TRUE(read.read(dir.path() + "/store.pmem.idx"));
+    EXPECT_EQ(read.chunkSize, index.chunkSize);
+    EXPECT_EQ(read.storeSize, index.storeSize);
+    EXPECT_EQ(read.files, index.files);
+    ASSERT_EQ(read.chunks.size(), index.chunks.size());
+    for (size_t i = 0; i < index.chunks.size(); ++i) {
+        EXPECT_EQ(read.chunks[i].hash, index.chunks[i].hash);
+        EXPECT_EQ(read.chunks[i].crc, index.chunks[i].crc);
+        EXPECT_EQ(read.chunks[i].flags, index.chunks[i].flags);
+        EXPECT_EQ(read.chunks[i].file, index.chunks[i].file);
+        EXPECT_EQ(read.chunks[i].offset, index.chunks[i].offset);
+        EXPECT_EQ(read.chunks[i].length, index.chunks[i].length);
+    }
+}
+
+/* A file that is not an index fails to read. */
+TEST(StoreCheckpointTest, IndexBadMagic)
+{
+    TempDir dir;
+    std::string path = dir.path() + "/store.pmem.idx";
+    FILE *file = fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    fputs("not an index, but long enough to be one", file);
+    fclose(file);
+
+    StoreIndex index;
+    EXPECT_FALSE(index.read(path));
+    EXPECT_FALSE(index.read(dir.path() + "/missing.idx"));
+}
+
+/* A store restores from its chunks, compressed or raw. */
+TEST(StoreCheckpointTest, RoundTrip)
+{
+    for (int compression : {0, 1}) {
+        TempDir dir;
+        StoreCheckpointConfig config = makeConfig();
+        config.compression = compression;
+        std::vector<uint8_t> store = makeStore();
+        serializeStoreChunks(config, dir.path(), "store.pmem", store.data(),
+                             StoreSize, ChunkSize);
+
+        StoreIndex index;
+        ASSERT_TRUE(index.read(dir.path() + "/store.pmem.idx"));
+        ASSERT_EQ(index.chunks.size(), StoreSize / ChunkSize);
+        EXPECT_EQ(index.chunks[1].flags, StoreIndex::ChunkZero);
+
+        std::vector<uint8_t> restored(StoreSize, 0xff);
+        unserializeStoreChunks(config, dir.path() + "/store.pmem.idx",
+                               restored.data(), StoreSize, ChunkSize, false);
+        EXPECT_EQ(restored, store);
+    }
+}
+
+/*
+ * Unchanged chunks of an incremental checkpoint refer to the base
+ * checkpoint by a relative path, so both can be moved together.
+ */
+TEST(StoreCheckpointTest, ReuseBaseChunks)
+{
+    TempDir root;
+    const std::string base_dir = root.path() + "/base";
+    const std::string incr_dir = root.path() + "/incr";
+    ASSERT_EQ(mkdir(base_dir.c_str(), 0777), 0);
+    ASSERT_EQ(mkdir(incr_dir.c_str(), 0777), 0);
+
+    StoreCheckpointConfig config = makeConfig();
+    std::vector<uint8_t> store = makeStore();
+    serializeStoreChunks(config, base_dir, "store.pmem", store.data(),
+                         StoreSize, ChunkSize);
+
+    // Change chunk 3 only
+    store[3 * ChunkSize + 10] ^= 0x55;
+    config.base = base_dir;
+    serializeStoreChunks(config, incr_dir, "store.pmem", store.data(),
+                         StoreSize, ChunkSize);
+
+    StoreIndex index;
+    ASSERT_TRUE(index.read(incr_dir + "/store.pmem.idx"));
+    ASSERT_EQ(index.files.size(), 2);
+    EXPECT_EQ(index.files[0], "store.pmem");
+    EXPECT_EQ(index.files[1], "../base/store.pmem");
+    for (size_t i = 0; i < index.chunks.size(); ++i) {
+        if (i == 1)
+            EXPECT_EQ(index.chunks[i].flags, StoreIndex::ChunkZero);
+        else
+            EXPECT_EQ(index.chunks[i].file, i == 3 ? 0 : 1) << i;
+    }
+
+    // Only the changed chunk is in the data file of the new checkpoint
+    EXPECT_EQ(index.chunks[3].offset, 0);
+    EXPECT_EQ(truncate((incr_dir + "/store.pmem").c_str(),
+                       index.chunks[3].length), 0);
+
+    const std::string moved = root.path() + "/moved";
+    ASSERT_EQ(mkdir(moved.c_str(), 0777), 0);
+    ASSERT_EQ(rename(base_dir.c_str(), (moved + "/base").c_str()), 0);
+    ASSERT_EQ(rename(incr_dir.c_str(), (moved + "/incr").c_str()), 0);
+
+    config.base.clear();
+    std::vector<uint8_t> restored(StoreSize, 0xff);
+    unserializeStoreChunks(config, moved + "/incr/store.pmem.idx",
+                           restored.data(), StoreSize, ChunkSize, false);
+    EXPECT_EQ(restored, store);
+}
@@ -37,6 +37,13 @@
 
 #include "proto/protoio.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
 #include <string>
 
 #include "base/logging.hh"
@@ -204,3 +211,96 @@ ProtoInputStream::read(Message& msg)
 
     return false;
 }
+
+ProtoMappedInputStream::ProtoMappedInputStream(const std::string& filename) :
+    fileName(filename), data(NULL), length(0), offset(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        panic("Could not open %s for reading\n", filename);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        panic("Could not stat %s: %s\n", filename, strerror(errno));
+    }
+    length = st.st_size;
+
+    if (length > 0) {
+        void* addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            panic("Could not map %s: %s\n", filename, strerror(errno));
+        }
+        data = static_cast<const uint8_t*>(addr);
+
+        // The messages are parsed front to back, tell the kernel to
+        // read ahead aggressively
+        madvise(addr, length, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    if (length >= 2 && data[0] == 0x1f && data[1] == 0x8b)
+        panic("Input file %s is compressed and cannot be mapped.\n",
+              fileName);
+
+    reset();
+}
+
+ProtoMappedInputStream::~ProtoMappedInputStream()
+{
+    if (data != NULL)
+        munmap(const_cast<uint8_t*>(data), length);
+}
+
+void
+ProtoMappedInputStream::reset()
+{
+    // The magic number is written with WriteLittleEndian32
+    if (length < sizeof(magicNumber) ||
+        (data[0] | data[1] << 8 | data[2] << 16 |
+         (uint32_t)data[3] << 24) != magicNumber)
+        panic("Input file %s is not a valid gem5 proto format.\n",
+              fileName);
+
+    offset = sizeof(magicNumber);
+}
+
+bool
+ProtoMappedInputStream::read(Message& msg)
+{
+    // Decode the varint size of the message
+    uint32_t size = 0;
+    for (unsigned shift = 0; ; shift += 7) {
+        if (offset >= length) {
+            if (shift != 0)
+                panic("Truncated message size in %s\n", fileName);
+            return false;
+        }
+        if (shift >= 32)
+            panic("Malformed message size in %s\n", fileName);
+
+        const uint8_t byte = data[offset++];
+        size |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    if (size > length - offset)
+        panic("Truncated message in %s\n", fileName);
+
+    if (!msg.ParseFromArray(data + offset, size))
+        panic("Unable to read message from %s\n", fileName);
+
+    offset += size;
+    return true;
+}
+
+bool
+ProtoMappedInputStream::isMappable(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    unsigned char bytes[2];
+    file.read((char*) bytes, 2);
+    return file.good() && !(bytes[0] == 0x1f && bytes[1] == 0x8b);
+}
@@ -54,4 +54,4 @@ if in_gem5:
     from .event import *
     from .main import main
     from .simulate import *
-
+    from . import sampling
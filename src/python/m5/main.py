@@ -144,6 +144,10 @@ def parse_options():
     option("--debug-file", metavar="FILE", default="cout",
         help="Sets the output file for debug. Append '.gz' to the name for it"
               " to be compressed automatically [Default: %default]")
+    option("--debug-binary", action='store_true', default=False,
+        help="Write debug output in a compact binary format, without "
+             "formatting the messages, to the file named by --debug-file. "
+             "Decode it with tracedecode")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
     option("--remote-gdb-port", type='int', default=7000,
@@ -396,7 +400,12 @@ def main():
         e = event.create(trace.disable, event.Event.Debug_Enable_Pri)
         event.mainq.schedule(e, options.debug_end)
 
-    trace.output(options.debug_file)
+    if options.debug_binary:
+        if options.debug_file in ("cout", "cerr"):
+            fatal("--debug-binary needs a file, set one with --debug-file")
+        trace.binaryOutput(options.debug_file)
+    else:
+        trace.output(options.debug_file)
 
     for ignore in options.debug_ignore:
         _check_tracing()
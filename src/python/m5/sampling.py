@@ -0,0 +1,344 @@
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""SMARTS-style sampled simulation.
+
+A sampled run keeps the simulated system on fast CPUs, typically
+AtomicSimpleCPUs with the caches attached so that they stay warm
+(functional warming), and periodically switches to detailed CPUs. Each
+detailed period first runs a warmup that fills the pipeline and other
+microarchitectural state that functional warming does not maintain,
+then a measured window. The stats are reset before each window and
+dumped after it, so every window is one stat dump.
+
+Metrics computed from the windows are reported as a mean with a
+confidence interval. With enough windows, the error of the estimate
+is bounded by the interval, and the run only spends a small fraction
+of the instructions in detailed mode.
+
+Example:
+    sampler = m5.sampling.Sampler(
+        system, system.cpu, system.detailed_cpu,
+        period=1000000, warmup=2000, window=1000,
+        metrics={
+            "cpi": lambda s: s("system.detailed_cpu.numCycles") /
+                             s("system.detailed_cpu.committedInsts"),
+        })
+    m5.instantiate()
+    exit_event = sampler.run()
+    for name, result in sampler.results().items():
+        print(name, result)
+
+All phases are measured in instructions committed by the first thread
+of the first CPU in the lists.
+"""
+
+import json
+import os
+import sys
+
+from statistics import NormalDist
+
+import _m5.core
+
+from m5 import options
+from m5.util import fatal
+from . import stats
+from . import objects
+from .simulate import simulate, switchCpus, fork
+
+# Cause of the simulation exits that end sampling phases
+_phase_cause = "sampling phase complete"
+
+def _lookup_stat(path):
+    """Value of a stat given its full name.
+
+    Vector stats evaluate to their total, unless an element is
+    selected with "::subname" or "::index"."""
+
+    name, _, sub = path.partition("::")
+    parts = name.split(".")
+
+    group = objects.Root.getInstance()
+    for part in parts[:-1]:
+        groups = group.getStatGroups()
+        if part not in groups:
+            raise KeyError("No stat group %s in %s" % (part, path))
+        group = groups[part]
+
+    for stat in group.getStats():
+        if stat.name != parts[-1]:
+            continue
+
+        if isinstance(stat, _m5.stats.ScalarInfo):
+            return stat.value
+        if isinstance(stat, _m5.stats.VectorInfo):
+            if not sub:
+                return stat.total
+            if sub in stat.subnames:
+                return stat.value[stat.subnames.index(sub)]
+            return stat.value[int(sub)]
+        raise TypeError("Stat %s is neither a scalar nor a vector" % path)
+
+    raise KeyError("No stat %s" % path)
+
+class SampleResult(object):
+    """Estimate of a metric over the measured windows."""
+
+    def __init__(self, values, confidence):
+        self.values = values
+        self.confidence = confidence
+
+        n = len(values)
+        self.mean = sum(values) / n if n else float("nan")
+        if n > 1:
+            var = sum((v - self.mean) ** 2 for v in values) / (n - 1)
+            self.stddev = var ** 0.5
+        else:
+            self.stddev = float("nan")
+
+        z = NormalDist().inv_cdf(0.5 + confidence / 2)
+        self.half_width = z * self.stddev / n ** 0.5 if n else float("nan")
+
+    def relative_error(self):
+        """Half width of the confidence interval relative to the mean"""
+        return abs(self.half_width / self.mean) if self.mean else float("inf")
+
+    def windows_needed(self, error):
+        """Number of windows required to bring the relative error under
+        the given bound, estimated from the observed variation."""
+
+        if not self.mean or self.stddev != self.stddev:
+            return None
+        z = NormalDist().inv_cdf(0.5 + self.confidence / 2)
+        cv = self.stddev / abs(self.mean)
+        return int((z * cv / error) ** 2) + 1
+
+    def to_dict(self):
+        return {
+            "mean" : self.mean,
+            "stddev" : self.stddev,
+            "half_width" : self.half_width,
+            "confidence" : self.confidence,
+            "windows" : len(self.values),
+        }
+
+    def __str__(self):
+        return "%g +/- %g (%g%% confidence, %d windows)" % (
+            self.mean, self.half_width, self.confidence * 100,
+            len(self.values))
+
+class Sampler(object):
+    """Drives a sampled simulation.
+
+    Arguments:
+      system -- Simulated system.
+      fast_cpus -- CPUs used for functional warming. They must be the
+                   active CPUs when the simulation starts.
+      detailed_cpus -- Switched out CPUs used for the detailed phases.
+      period -- Instructions from the start of one window to the start
+                of the next one.
+      warmup -- Detailed instructions before each window.
+      window -- Instructions in each measured window.
+
+    Keyword Arguments:
+      metrics -- Dictionary of the metrics to estimate. A value is
+                 either the full name of a stat or a function that
+                 takes a stat lookup function and returns a number.
+      confidence -- Confidence level of the reported intervals.
+      offset -- Instructions of functional warming before the first
+                period.
+      max_windows -- Stop after this many windows, if set.
+      parallel -- If non-zero, fork a child for every detailed period
+                  and run up to this many children at a time. The
+                  parent keeps warming from the state the child started
+                  from, so detailed simulation never perturbs the
+                  functional trajectory.
+    """
+
+    def __init__(self, system, fast_cpus, detailed_cpus,
+                 period, warmup, window, metrics=None, confidence=0.95,
+                 offset=0, max_windows=None, parallel=0):
+        fast_cpus = list(fast_cpus)
+        detailed_cpus = list(detailed_cpus)
+        if len(fast_cpus) != len(detailed_cpus):
+            fatal("Sampling needs as many fast CPUs as detailed CPUs.")
+        if warmup + window > period:
+            fatal("Sampling period (%d) shorter than the warmup (%d) and "
+                  "window (%d)." % (period, warmup, window))
+        if window <= 0:
+            fatal("Sampling window must be at least one instruction.")
+
+        self.system = system
+        self.fast_cpus = fast_cpus
+        self.detailed_cpus = detailed_cpus
+        self.period = period
+        self.warmup = warmup
+        self.window = window
+        self.metrics = dict(metrics or {})
+        self.confidence = confidence
+        self.offset = offset
+        self.max_windows = max_windows
+        self.parallel = parallel
+
+        self._samples = []
+        self._children = {}
+        self._forks = 0
+
+    def _run(self, cpus, insts):
+        """Run the given number of instructions. Returns None when the
+        instructions were committed and the exit event otherwise."""
+
+        if insts <= 0:
+            return None
+
+        cpus[0].scheduleInstStop(0, insts, _phase_cause)
+        exit_event = simulate()
+        if exit_event.getCause() == _phase_cause:
+            return None
+        return exit_event
+
+    def _switch(self, old_cpus, new_cpus):
+        switchCpus(self.system, list(zip(old_cpus, new_cpus)), verbose=False)
+
+    def _measure(self):
+        values = {}
+        stats.prepare()
+        for name, metric in self.metrics.items():
+            if callable(metric):
+                values[name] = metric(_lookup_stat)
+            else:
+                values[name] = _lookup_stat(metric)
+        return values
+
+    def _detailed(self):
+        """Switch to the detailed CPUs, warm them up and measure one
+        window. Returns the measured values, or None if the simulation
+        exited first, along with the exit event."""
+
+        self._switch(self.fast_cpus, self.detailed_cpus)
+
+        exit_event = self._run(self.detailed_cpus, self.warmup)
+        if exit_event is None:
+            stats.reset()
+            exit_event = self._run(self.detailed_cpus, self.window)
+
+        values = None
+        if exit_event is None:
+            values = self._measure()
+            stats.dump()
+
+        return values, exit_event
+
+    def _fork_detailed(self):
+        """Run a detailed period in a child process."""
+
+        while len(self._children) >= self.parallel:
+            self._wait_child()
+
+        outdir = os.path.join(options.outdir, "window%d" % self._forks)
+        self._forks += 1
+
+        pid = fork(outdir.replace("%", "%%"))
+        if pid != 0:
+            self._children[pid] = outdir
+            return
+
+        values, _ = self._detailed()
+        with open(os.path.join(options.outdir, "sample.json"), "w") as f:
+            json.dump(values, f)
+        sys.stdout.flush()
+        sys.stderr.flush()
+        # Leave without the exit handlers, they would dump stats again
+        os._exit(0)
+
+    def _wait_child(self):
+        """Wait for a forked window and collect its values."""
+
+        pid, status = os.waitpid(-1, 0)
+        outdir = self._children.pop(pid, None)
+        if outdir is None:
+            return
+
+        try:
+            with open(os.path.join(outdir, "sample.json")) as f:
+                values = json.load(f)
+        except (IOError, ValueError):
+            values = None
+        if values is not None:
+            self._samples.append(values)
+
+    def run(self):
+        """Run the sampled simulation until the workload exits or the
+        maximum number of windows is reached. Returns the exit event
+        that ended the simulation, or None if it was stopped after the
+        last window."""
+
+        if self.parallel and not _m5.core.listenersDisabled():
+            fatal("Forked sampling windows require disabled listeners.")
+
+        exit_event = self._run(self.fast_cpus, self.offset)
+        windows = 0
+        while exit_event is None:
+            if self.max_windows is not None and windows >= self.max_windows:
+                break
+            windows += 1
+
+            if self.parallel:
+                self._fork_detailed()
+                exit_event = self._run(self.fast_cpus, self.period)
+                continue
+
+            values, exit_event = self._detailed()
+            if values is not None:
+                self._samples.append(values)
+            if exit_event is not None:
+                break
+
+            self._switch(self.detailed_cpus, self.fast_cpus)
+            exit_event = self._run(self.fast_cpus,
+                                   self.period - self.warmup - self.window)
+
+        while self._children:
+            self._wait_child()
+
+        self.write_results()
+        return exit_event
+
+    def samples(self):
+        """Values measured in each window, in simulation order for
+        sequential runs."""
+        return list(self._samples)
+
+    def results(self):
+        """Estimates of every metric, as SampleResult objects."""
+        return { name : SampleResult(
+                    [ s[name] for s in self._samples if name in s ],
+                    self.confidence)
+                 for name in self.metrics }
+
+    def write_results(self, filename="sampling.json"):
+        results = { name : r.to_dict() for name, r in self.results().items() }
+        with open(os.path.join(options.outdir, filename), "w") as f:
+            json.dump({ "results" : results, "samples" : self._samples },
+                      f, indent=4)
@@ -51,6 +51,7 @@ from . import SimObject
 from . import ticks
 from . import objects
 from . import params
+from . import proxy
 from m5.util.dot_writer import do_dot, do_dvfs_dot
 from m5.util.dot_writer_ruby import do_ruby_dot
 
@@ -64,6 +65,25 @@ _drain_manager = _m5.drain.DrainManager.instance()
 
 _instantiated = False # Has m5.instantiate() been called?
 
+# Independent event queues (Root.independent_eventqs) run without ever
+# synchronizing, so no port may connect objects on different queues.
+def checkIndependentEventQueues(root):
+    for obj in root.descendants():
+        for ref in obj._port_refs.values():
+            if isinstance(ref, params.VectorPortRef):
+                refs = ref.elements
+            else:
+                refs = [ ref ]
+            for ref in refs:
+                if not ref.peer or proxy.isproxy(ref.peer):
+                    continue
+                peer = ref.peer.simobj
+                if peer.eventq_index != obj.eventq_index:
+                    fatal("%s (event queue %d) is connected to %s (event "
+                          "queue %d), but the event queues are independent.",
+                          ref, obj.eventq_index, ref.peer,
+                          peer.eventq_index)
+
 # The final call to instantiate the SimObject graph and initialize the
 # system.
 def instantiate(ckpt_dir=None):
@@ -90,6 +110,9 @@ def instantiate(ckpt_dir=None):
     # Unproxy in sorted order for determinism
     for obj in root.descendants(): obj.unproxyParams()
 
+    if root.independent_eventqs:
+        checkIndependentEventQueues(root)
+
     if options.dump_config:
         ini_file = open(os.path.join(options.outdir, options.dump_config), 'w')
         # Print ini sections in sorted order for easier diffing
@@ -210,10 +233,16 @@ def drain():
             return True
 
         # WARNING: if a valid exit event occurs while draining, it
-        # will not get returned to the user script
-        exit_event = _m5.event.simulate()
-        while exit_event.getCause() != 'Finished drain':
-            exit_event = simulate()
+        # will not get returned to the user script. With independent
+        # event queues, another queue may have stopped for another
+        # cause first, so look at the exit events of all of them.
+        def _finished():
+            return any(event.getCause() == 'Finished drain'
+                       for event in _m5.event.getExitEvents())
+
+        _m5.event.simulate()
+        while not _finished():
+            simulate()
 
         return False
 
@@ -388,3 +417,4 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
 from _m5.core import disableAllListeners, listenersDisabled
 from _m5.core import listenersLoopbackOnly
 from _m5.core import curTick
+from _m5.event import getExitEvents
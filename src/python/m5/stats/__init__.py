@@ -183,6 +183,29 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "col", "columnar", ])
+def _columnarFactory(fn, desc=True, formulas=True, delta=True, compress=True):
+    """Output stats in a binary columnar format.
+
+    The names of the stats are written once, and each stat dump only
+    appends the vector of values, which makes frequent periodic dumps
+    cheap to write and fast to load. util/columnar_stats.py reads the
+    files into NumPy arrays or pandas data frames.
+
+    Parameters:
+      * desc (bool): Output stat descriptions (default: True)
+      * formulas (bool): Output derived stats (default: True)
+      * delta (bool): Encode values relative to the previous dump
+                      (default: True)
+      * compress (bool): Compress the values with zlib (default: True)
+
+    Example:
+      col://stats.col?desc=False;formulas=False
+
+    """
+
+    return _m5.stats.initColumnar(fn, desc, formulas, delta, compress)
+
 @_url_factory(["json"])
 def _jsonFactory(fn):
     """Output stats in JSON format.
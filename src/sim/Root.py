@@ -67,6 +67,13 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Set this if the objects on different event queues never interact,
+    # e.g. because each queue simulates a separate System. The queues then
+    # run without a quantum, each one has its own current tick, and
+    # simulate() returns once every queue has exited on its own.
+    independent_eventqs = Param.Bool(False,
+        "event queues do not interact and run without a quantum")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
@@ -74,3 +81,8 @@ class Root(SimObject):
     time_sync_period = Param.Clock("100ms", "how often to sync with real time")
     time_sync_spin_threshold = \
             Param.Clock("100us", "when less than this much time is left, spin")
+
+    # Host time profiling of the events, reported per event and per owning
+    # SimObject in event_profile.txt whenever the stats are dumped.
+    profile_events = Param.Bool(False,
+        "account host time to the events and the objects that own them")
@@ -91,6 +91,21 @@ class System(SimObject):
         "shmem segment file upon destruction. This is used only if "
         "shared_backstore is non-empty.")
 
+    # Physical memory checkpoints. With a non-zero chunk size, each
+    # backing store is written as independently compressed chunks with an
+    # index, in parallel, and chunks that are unchanged since the base
+    # checkpoint refer to the base instead of being written again.
+    memory_checkpoint_chunk_size = Param.MemorySize("0", "Size of the "
+        "chunks of memory checkpoints, 0 to write a single gzip file")
+    memory_checkpoint_threads = Param.Unsigned(0, "Threads used to write "
+        "and restore chunked memory checkpoints, 0 for one per host CPU")
+    memory_checkpoint_compression = Param.Int(1, "zlib compression level "
+        "of checkpoint chunks, 0 to store them uncompressed")
+    memory_checkpoint_base = Param.String("", "Checkpoint directory that "
+        "chunked memory checkpoints are taken incrementally against")
+    memory_checkpoint_lazy_restore = Param.Bool(False, "Map uncompressed "
+        "checkpoint chunks into memory on restore instead of reading them")
+
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
     redirect_paths = VectorParam.RedirectPath([], "Path redirections")
@@ -43,6 +43,8 @@
 #include "base/named.hh"
 #include "base/trace.hh"
 #include "debug/Drain.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
 
 namespace gem5
@@ -151,7 +153,12 @@ DrainManager::signalDrainDone()
     assert(_count > 0);
     if (--_count == 0) {
         DPRINTF(Drain, "All %u objects drained..\n", drainableCount());
-        exitSimLoop("Finished drain", 0);
+        // exitSimLoop() would only stop the queue of this thread if the
+        // queues are independent, but the drain has to stop all of them
+        if (inParallelMode && independentEventQueues)
+            new GlobalSimLoopExitEvent(curTick(), "Finished drain", 0);
+        else
+            exitSimLoop("Finished drain", 0);
     }
 }
 
@@ -0,0 +1,164 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_profile.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <utility>
+
+#include "base/cprintf.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+EventProfile::EventProfile()
+{
+    clear();
+}
+
+void
+EventProfile::record(const Event *event, uint64_t cycles)
+{
+    Entry *entry;
+    if (event->isAutoDelete()) {
+        entry = &byName[event->name()];
+    } else {
+        entry = &byEvent[event];
+        // Most events are EventFunctionWrappers with the same
+        // description, so only the name tells them apart.
+        std::string name = event->name();
+        if (entry->description != event->description() ||
+                entry->name != name) {
+            // A new event, or a deleted one whose address was reused
+            if (entry->count) {
+                Entry &old = byName[entry->name];
+                old.count += entry->count;
+                old.cycles += entry->cycles;
+            }
+            *entry = Entry();
+            entry->name = std::move(name);
+            entry->description = event->description();
+        }
+    }
+
+    entry->count++;
+    entry->cycles += cycles;
+}
+
+void
+EventProfile::clear()
+{
+    byEvent.clear();
+    byName.clear();
+    startCycles = cycles();
+    startTime = std::chrono::steady_clock::now();
+}
+
+namespace
+{
+
+typedef std::map<std::string, EventProfile::Entry> Totals;
+
+void
+add(Totals &totals, const std::string &name, const EventProfile::Entry &e)
+{
+    auto &total = totals[name];
+    total.count += e.count;
+    total.cycles += e.cycles;
+}
+
+void
+printTotals(std::ostream &os, const char *title, const Totals &totals,
+            uint64_t all_cycles, double cycles_per_second)
+{
+    std::vector<Totals::const_iterator> sorted;
+    for (auto it = totals.begin(); it != totals.end(); ++it)
+        sorted.push_back(it);
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](Totals::const_iterator l, Totals::const_iterator r) {
+            return l->second.cycles > r->second.cycles;
+        });
+
+    ccprintf(os, "\n%s:\n", title);
+    ccprintf(os, "%12s %7s %14s %12s  %s\n",
+             "host_s", "share", "events", "cycles/event", "name");
+    for (auto it : sorted) {
+        const auto &e = it->second;
+        ccprintf(os, "%12.6f %6.2f%% %14d %12.1f  %s\n",
+                 cycles_per_second ? e.cycles / cycles_per_second : 0.0,
+                 all_cycles ? 100.0 * e.cycles / all_cycles : 0.0,
+                 e.count, e.count ? double(e.cycles) / e.count : 0.0,
+                 it->first);
+    }
+}
+
+} // anonymous namespace
+
+void
+EventProfile::report(std::ostream &os,
+                     const std::vector<const EventProfile *> &profiles,
+                     const std::function<std::string(
+                         const std::string &)> &owner)
+{
+    Totals events;
+    for (auto *profile : profiles) {
+        for (const auto &e : profile->byEvent)
+            add(events, e.second.name, e.second);
+        for (const auto &e : profile->byName)
+            add(events, e.first, e.second);
+    }
+
+    Totals objects;
+    uint64_t all_cycles = 0;
+    uint64_t all_count = 0;
+    for (const auto &e : events) {
+        add(objects, owner(e.first), e.second);
+        all_cycles += e.second.cycles;
+        all_count += e.second.count;
+    }
+
+    // Calibrate the cycle counter against the host clock over the time
+    // the first profile has been recording
+    double cycles_per_second = 0;
+    if (!profiles.empty()) {
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - profiles[0]->startTime;
+        if (elapsed.count() > 0) {
+            cycles_per_second =
+                (cycles() - profiles[0]->startCycles) / elapsed.count();
+        }
+    }
+
+    ccprintf(os, "Event profile: %d events, %d host cycles (%.6f s)\n",
+             all_count, all_cycles,
+             cycles_per_second ? all_cycles / cycles_per_second : 0.0);
+    printTotals(os, "Objects", objects, all_cycles, cycles_per_second);
+    printTotals(os, "Events", events, all_cycles, cycles_per_second);
+}
+
+} // namespace gem5
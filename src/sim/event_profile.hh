@@ -0,0 +1,122 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_EVENT_PROFILE_HH__
+#define __SIM_EVENT_PROFILE_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace gem5
+{
+
+class Event;
+
+/**
+ * Host time spent in, and number of, the events serviced by an event
+ * queue, per event. A queue only records into a profile while one is
+ * installed (see EventQueue::profile()), so profiling costs a null check
+ * per event when it is disabled.
+ */
+class EventProfile
+{
+  public:
+    struct Entry
+    {
+        std::string name;
+        const char *description = nullptr;
+        uint64_t count = 0;
+        uint64_t cycles = 0;
+    };
+
+    EventProfile();
+
+    /**
+     * A cheap host cycle counter, e.g. the TSC. Only differences between
+     * readings on the same host are meaningful.
+     */
+    static uint64_t
+    cycles()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t count;
+        asm volatile("mrs %0, cntvct_el0" : "=r" (count));
+        return count;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /** Account one servicing of event, which took cycles host cycles. */
+    void record(const Event *event, uint64_t cycles);
+
+    /** Forget all recorded events, e.g. when the stats are reset. */
+    void clear();
+
+    /**
+     * Write a report of the events of all profiles, and of the objects
+     * that own them, sorted by host time. Events with the same name are
+     * merged.
+     *
+     * @param owner Name of the object that owns an event, given its name.
+     */
+    static void report(std::ostream &os,
+                       const std::vector<const EventProfile *> &profiles,
+                       const std::function<std::string(
+                           const std::string &)> &owner);
+
+  private:
+    /**
+     * Events that persist, e.g. members of a SimObject, are looked up by
+     * address so that their names are only stored once.
+     */
+    std::unordered_map<const Event *, Entry> byEvent;
+
+    /**
+     * Events that are deleted after they are processed, and events whose
+     * address was reused by another event, by name.
+     */
+    std::unordered_map<std::string, Entry> byName;
+
+    /** Cycle counter and host time when the profile was last cleared. */
+    uint64_t startCycles;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+} // namespace gem5
+
+#endif // __SIM_EVENT_PROFILE_HH__
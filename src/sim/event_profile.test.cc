@@ -0,0 +1,233 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sim/event_profile.hh"
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** An event with a fixed name. */
+class NamedEvent : public Event
+{
+  private:
+    std::string _name;
+    const char *desc;
+
+  public:
+    NamedEvent(const std::string &name, const char *desc = "named event",
+               bool del = false)
+        : _name(name), desc(desc)
+    {
+        if (del)
+            setFlags(AutoDelete);
+    }
+
+    void process() override {}
+    const std::string name() const override { return _name; }
+    const char *description() const override { return desc; }
+};
+
+std::string
+ownerOf(const std::string &name)
+{
+    return name.substr(0, name.find('.'));
+}
+
+/** The lines of a report section, without its header. */
+std::vector<std::string>
+section(const std::string &report, const std::string &title)
+{
+    std::istringstream is(report.substr(report.find(title + ":\n")));
+    std::vector<std::string> lines;
+    std::string line;
+    std::getline(is, line);
+    std::getline(is, line);
+    while (std::getline(is, line) && !line.empty())
+        lines.push_back(line);
+    return lines;
+}
+
+/** Check that line is about name and that many events. */
+void
+expectLine(const std::string &line, const std::string &name, int count)
+{
+    std::istringstream is(line);
+    double seconds, share, per_event;
+    std::string percent;
+    int events;
+    std::string line_name;
+    is >> seconds >> percent >> events >> per_event >> line_name;
+    EXPECT_EQ(line_name, name);
+    EXPECT_EQ(events, count);
+}
+
+} // anonymous namespace
+
+/** Events are sorted by host time and merged by name across profiles. */
+TEST(EventProfileTest, ReportSortedAndMerged)
+{
+    NamedEvent a("cpu.tick"), b("cpu.fetch"), c("mem.respond");
+    NamedEvent a_too("cpu.tick");
+    EventProfile p0, p1;
+
+    p0.record(&a, 100);
+    p0.record(&a, 100);
+    p0.record(&b, 50);
+    p1.record(&a_too, 150);
+    p1.record(&c, 300);
+
+    std::ostringstream os;
+    EventProfile::report(os, {&p0, &p1}, ownerOf);
+    std::string report = os.str();
+    EXPECT_EQ(report.find("Event profile: 5 events, 700 host cycles"), 0);
+
+    auto events = section(report, "Events");
+    ASSERT_EQ(events.size(), 3);
+    expectLine(events[0], "cpu.tick", 3);
+    expectLine(events[1], "mem.respond", 1);
+    expectLine(events[2], "cpu.fetch", 1);
+
+    auto objects = section(report, "Objects");
+    ASSERT_EQ(objects.size(), 2);
+    expectLine(objects[0], "cpu", 4);
+    expectLine(objects[1], "mem", 1);
+}
+
+/** Events that are deleted once processed are accounted by name. */
+TEST(EventProfileTest, AutoDeleteEventsByName)
+{
+    EventProfile profile;
+    for (int i = 0; i < 3; ++i) {
+        NamedEvent event(i < 2 ? "dev.irq" : "dev.dma", "transient", true);
+        profile.record(&event, 10);
+    }
+
+    std::ostringstream os;
+    EventProfile::report(os, {&profile}, ownerOf);
+    auto events = section(os.str(), "Events");
+    ASSERT_EQ(events.size(), 2);
+    expectLine(events[0], "dev.irq", 2);
+    expectLine(events[1], "dev.dma", 1);
+}
+
+/** An event of another kind at the address of a deleted one is separate. */
+TEST(EventProfileTest, ReusedAddress)
+{
+    EventProfile profile;
+    alignas(NamedEvent) unsigned char storage[sizeof(NamedEvent)];
+
+    auto *first = new (storage) NamedEvent("a.first", "first kind");
+    profile.record(first, 15);
+    first->~NamedEvent();
+
+    auto *second = new (storage) NamedEvent("b.second", "second kind");
+    profile.record(second, 10);
+    profile.record(second, 10);
+    second->~NamedEvent();
+
+    std::ostringstream os;
+    EventProfile::report(os, {&profile}, ownerOf);
+    auto events = section(os.str(), "Events");
+    ASSERT_EQ(events.size(), 2);
+    expectLine(events[0], "b.second", 2);
+    expectLine(events[1], "a.first", 1);
+}
+
+/** So is an event of the same kind at that address, with another name. */
+TEST(EventProfileTest, ReusedAddressSameDescription)
+{
+    EventProfile profile;
+    alignas(NamedEvent) unsigned char storage[sizeof(NamedEvent)];
+
+    auto *first = new (storage) NamedEvent("a.wrapped", "wrapped");
+    profile.record(first, 15);
+    first->~NamedEvent();
+
+    auto *second = new (storage) NamedEvent("b.wrapped", "wrapped");
+    profile.record(second, 10);
+    profile.record(second, 10);
+    second->~NamedEvent();
+
+    std::ostringstream os;
+    EventProfile::report(os, {&profile}, ownerOf);
+    auto events = section(os.str(), "Events");
+    ASSERT_EQ(events.size(), 2);
+    expectLine(events[0], "b.wrapped", 2);
+    expectLine(events[1], "a.wrapped", 1);
+}
+
+/** Clearing a profile forgets everything recorded so far. */
+TEST(EventProfileTest, Clear)
+{
+    NamedEvent event("cpu.tick");
+    EventProfile profile;
+    profile.record(&event, 10);
+    profile.clear();
+    profile.record(&event, 5);
+
+    std::ostringstream os;
+    EventProfile::report(os, {&profile}, ownerOf);
+    EXPECT_EQ(os.str().find("Event profile: 1 events, 5 host cycles"), 0);
+}
+
+/** An event queue only profiles while a profile is installed. */
+TEST(EventProfileTest, EventQueueProfile)
+{
+    EventQueue eq("eq");
+    EventProfile profile;
+    NamedEvent event("cpu.tick");
+
+    EventQueue *prev_queue = curEventQueue();
+    curEventQueue(&eq);
+
+    eq.schedule(&event, 1);
+    eq.serviceOne();
+
+    eq.profile(&profile);
+    EXPECT_EQ(eq.profile(), &profile);
+    eq.schedule(&event, 2);
+    eq.serviceOne();
+    eq.schedule(&event, 3);
+    eq.serviceOne();
+    eq.profile(nullptr);
+
+    curEventQueue(prev_queue);
+
+    std::ostringstream os;
+    EventProfile::report(os, {&profile}, ownerOf);
+    auto events = section(os.str(), "Events");
+    ASSERT_EQ(events.size(), 1);
+    expectLine(events[0], "cpu.tick", 2);
+}
@@ -30,22 +30,28 @@
 
 #include "sim/eventq.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
+#include "sim/event_profile.hh"
 
 namespace gem5
 {
 
 Tick simQuantum = 0;
+bool independentEventQueues = false;
 
 //
 // Main Event Queues
@@ -108,9 +114,63 @@ Event::insertBefore(Event *event, Event *curr)
     return event;
 }
 
+namespace
+{
+
+EventQueue::Backend
+backendFromEnvironment()
+{
+    const char *name = std::getenv("GEM5_EVENTQ_BACKEND");
+    if (!name || !std::strcmp(name, "list"))
+        return EventQueue::Backend::List;
+    else if (!std::strcmp(name, "heap"))
+        return EventQueue::Backend::Heap;
+    else if (!std::strcmp(name, "calendar"))
+        return EventQueue::Backend::Calendar;
+
+    fatal("Unknown event queue backend '%s' in GEM5_EVENTQ_BACKEND", name);
+}
+
+EventQueue::Backend &
+defaultBackendRef()
+{
+    static EventQueue::Backend backend = backendFromEnvironment();
+    return backend;
+}
+
+// The calendar never shrinks below this many buckets.
+const size_t minCalendarBuckets = 16;
+
+} // anonymous namespace
+
+EventQueue::Backend
+EventQueue::defaultBackend()
+{
+    return defaultBackendRef();
+}
+
+void
+EventQueue::defaultBackend(Backend backend)
+{
+    defaultBackendRef() = backend;
+}
+
 void
 EventQueue::insert(Event *event)
 {
+    switch (backend) {
+      case Backend::Heap:
+        event->queueOrder = ++nextOrder;
+        heapInsert(event);
+        return;
+      case Backend::Calendar:
+        event->queueOrder = ++nextOrder;
+        calendarInsert(event);
+        return;
+      default:
+        break;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -170,6 +230,17 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    switch (backend) {
+      case Backend::Heap:
+        heapRemove(event);
+        return;
+      case Backend::Calendar:
+        calendarRemove(event);
+        return;
+      default:
+        break;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -194,6 +265,218 @@ EventQueue::remove(Event *event)
     prev->nextBin = Event::removeItem(event, curr);
 }
 
+void
+EventQueue::heapInsert(Event *event)
+{
+    event->queueIndex = heap.size();
+    heap.push_back(event);
+    heapSiftUp(event->queueIndex);
+    head = heap.front();
+}
+
+void
+EventQueue::heapRemove(Event *event)
+{
+    size_t i = event->queueIndex;
+    if (i >= heap.size() || heap[i] != event)
+        panic("event not found!");
+
+    Event *last = heap.back();
+    heap.pop_back();
+    if (last != event) {
+        heap[i] = last;
+        last->queueIndex = i;
+        heapSiftDown(i);
+        heapSiftUp(last->queueIndex);
+    }
+
+    head = heap.empty() ? nullptr : heap.front();
+}
+
+void
+EventQueue::heapSiftUp(size_t i)
+{
+    Event *event = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!before(event, heap[parent]))
+            break;
+        heap[i] = heap[parent];
+        heap[i]->queueIndex = i;
+        i = parent;
+    }
+    heap[i] = event;
+    event->queueIndex = i;
+}
+
+void
+EventQueue::heapSiftDown(size_t i)
+{
+    Event *event = heap[i];
+    const size_t size = heap.size();
+    while (true) {
+        size_t child = 2 * i + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && before(heap[child + 1], heap[child]))
+            ++child;
+        if (!before(heap[child], event))
+            break;
+        heap[i] = heap[child];
+        heap[i]->queueIndex = i;
+        i = child;
+    }
+    heap[i] = event;
+    event->queueIndex = i;
+}
+
+size_t
+EventQueue::calendarBucket(Tick when) const
+{
+    return (when >> calendarShift) & (calendar.size() - 1);
+}
+
+void
+EventQueue::calendarInsert(Event *event)
+{
+    if (calendar.empty())
+        calendar.resize(minCalendarBuckets, nullptr);
+
+    // Keep each bucket sorted in service order
+    Event **link = &calendar[calendarBucket(event->when())];
+    while (*link && before(*link, event))
+        link = &(*link)->nextBin;
+    event->nextBin = *link;
+    event->nextInBin = nullptr;
+    *link = event;
+
+    if (!head || before(event, head))
+        head = event;
+
+    if (++calendarSize > 2 * calendar.size())
+        calendarResize(2 * calendar.size());
+}
+
+void
+EventQueue::calendarRemove(Event *event)
+{
+    Event **link = &calendar[calendarBucket(event->when())];
+    while (*link && *link != event)
+        link = &(*link)->nextBin;
+    if (!*link)
+        panic("event not found!");
+    *link = event->nextBin;
+    --calendarSize;
+    ++calendarRemoved;
+
+    bool searched_all = false;
+    if (event == head)
+        head = calendarFindMin(event->when(), searched_all);
+
+    if (calendar.size() > minCalendarBuckets &&
+            calendarSize < calendar.size() / 2) {
+        calendarResize(calendar.size() / 2);
+    } else if (searched_all && calendarRemoved >= calendar.size()) {
+        // The buckets are too narrow for the spacing of the events,
+        // recompute their width. A new width does not help every sparse
+        // pattern, so resize at most once per calendar.size() removals
+        // to keep the cost of resizing amortized constant.
+        calendarResize(calendar.size());
+    }
+}
+
+Event *
+EventQueue::calendarFindMin(Tick from, bool &searched_all) const
+{
+    searched_all = false;
+    if (calendarSize == 0)
+        return nullptr;
+
+    // Visit the buckets in order, one "year" at a time, starting from the
+    // bucket of the previous minimum. The first event that falls into the
+    // current year of its bucket is the minimum. All pending events are
+    // at or after 'from', so years are counted relative to it, which
+    // cannot overflow even for events at MaxTick.
+    const Tick year = from >> calendarShift;
+    size_t i = calendarBucket(from);
+    for (size_t n = 0; n < calendar.size(); ++n) {
+        Event *first = calendar[i];
+        if (first && (first->when() >> calendarShift) - year <= n)
+            return first;
+        i = (i + 1) & (calendar.size() - 1);
+    }
+
+    // The events are sparse, search all buckets directly
+    searched_all = true;
+    Event *min = nullptr;
+    for (Event *first : calendar) {
+        if (first && (!min || before(first, min)))
+            min = first;
+    }
+    return min;
+}
+
+void
+EventQueue::calendarResize(size_t buckets)
+{
+    std::vector<Event *> events = sortedEvents();
+
+    // Make buckets about three times as wide as the average distance
+    // between the first events, which are the ones serviced next. Events
+    // at MaxTick, like the limit event of simulate(), would stretch the
+    // buckets over the whole tick range and are left out.
+    size_t samples = std::min<size_t>(events.size(), 32);
+    while (samples > 0 && events[samples - 1]->when() == MaxTick)
+        --samples;
+    Tick span = samples > 1 ?
+        events[samples - 1]->when() - events[0]->when() : 0;
+    Tick gap = samples > 1 ? span / (samples - 1) : 0;
+    Tick width = gap > MaxTick / 3 ? MaxTick : 3 * gap;
+    calendarShift = width > 1 ? std::min(ceilLog2(width), 63) : 0;
+
+    calendar.assign(buckets, nullptr);
+    calendarSize = 0;
+    calendarRemoved = 0;
+    head = nullptr;
+
+    // Inserting in reverse order keeps the insertion at the front of
+    // each bucket
+    for (auto it = events.rbegin(); it != events.rend(); ++it) {
+        Event *event = *it;
+        Event *&first = calendar[calendarBucket(event->when())];
+        event->nextBin = first;
+        first = event;
+        ++calendarSize;
+    }
+
+    head = events.empty() ? nullptr : events.front();
+}
+
+std::vector<Event *>
+EventQueue::sortedEvents() const
+{
+    std::vector<Event *> events;
+
+    if (backend == Backend::Heap) {
+        events = heap;
+    } else if (backend == Backend::Calendar) {
+        events.reserve(calendarSize);
+        for (Event *event : calendar) {
+            for (; event; event = event->nextBin)
+                events.push_back(event);
+        }
+    } else {
+        for (Event *bin = head; bin; bin = bin->nextBin) {
+            for (Event *event = bin; event; event = event->nextInBin)
+                events.push_back(event);
+        }
+        return events;
+    }
+
+    std::sort(events.begin(), events.end(), before);
+    return events;
+}
+
 Event *
 EventQueue::serviceOne()
 {
@@ -202,7 +485,9 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (backend != Backend::List) {
+        remove(event);
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -220,7 +505,13 @@ EventQueue::serviceOne()
         setCurTick(event->when());
         if (debug::Event)
             event->trace("executed");
-        event->process();
+        if (_profile) {
+            uint64_t start = EventProfile::cycles();
+            event->process();
+            _profile->record(event, EventProfile::cycles() - start);
+        } else {
+            event->process();
+        }
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -294,7 +585,10 @@ EventQueue::dump() const
 
     if (empty())
         cprintf("<No Events>\n");
-    else {
+    else if (backend != Backend::List) {
+        for (Event *event : sortedEvents())
+            event->dump();
+    } else {
         Event *nextBin = head;
         while (nextBin) {
             Event *nextInBin = nextBin;
@@ -318,6 +612,34 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
+    if (backend == Backend::Heap) {
+        for (size_t i = 0; i < heap.size(); ++i) {
+            if (heap[i]->queueIndex != i ||
+                    (i > 0 && before(heap[i], heap[(i - 1) / 2]))) {
+                cprintf("heap order violated!");
+                heap[i]->dump();
+                return false;
+            }
+        }
+        return head == (heap.empty() ? nullptr : heap.front());
+    } else if (backend == Backend::Calendar) {
+        size_t count = 0;
+        for (size_t i = 0; i < calendar.size(); ++i) {
+            for (Event *event = calendar[i]; event; event = event->nextBin) {
+                if (calendarBucket(event->when()) != i ||
+                        (event->nextBin && before(event->nextBin, event))) {
+                    cprintf("calendar bucket corrupted!");
+                    event->dump();
+                    return false;
+                }
+                ++count;
+            }
+        }
+        auto events = sortedEvents();
+        return count == calendarSize &&
+            head == (events.empty() ? nullptr : events.front());
+    }
+
     Event *nextBin = head;
     while (nextBin) {
         Event *nextInBin = nextBin;
@@ -355,8 +677,42 @@ EventQueue::debugVerify() const
 Event*
 EventQueue::replaceHead(Event* s)
 {
-    Event* t = head;
-    head = s;
+    if (backend == Backend::List) {
+        Event* t = head;
+        head = s;
+        return t;
+    }
+
+    // Hand out the pending events as a list of bins linked by nextBin,
+    // and take back such a list
+    std::vector<Event *> events = sortedEvents();
+    Event *t = nullptr;
+    for (auto it = events.rbegin(); it != events.rend(); ++it) {
+        (*it)->nextBin = t;
+        (*it)->nextInBin = nullptr;
+        t = *it;
+    }
+
+    head = nullptr;
+    heap.clear();
+    calendar.clear();
+    calendarSize = 0;
+
+    // Only the top of each bin has a valid nextBin pointer. Keep the
+    // insertion stamps so that the service order is preserved
+    for (Event *bin = s; bin; ) {
+        Event *next_bin = bin->nextBin;
+        for (Event *event = bin; event; ) {
+            Event *next = event->nextInBin;
+            if (backend == Backend::Heap)
+                heapInsert(event);
+            else
+                calendarInsert(event);
+            event = next;
+        }
+        bin = next_bin;
+    }
+
     return t;
 }
 
@@ -416,30 +772,51 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : EventQueue(n, defaultBackend())
+{
+}
+
+EventQueue::EventQueue(const std::string &n, Backend backend)
+    : objName(n), head(NULL), _curTick(0), backend(backend), nextOrder(0),
+      calendarShift(0), calendarSize(0), calendarRemoved(0),
+      async_queue(nullptr), _profile(nullptr)
 {
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex.lock();
-    async_queue.push_back(event);
-    async_queue_mutex.unlock();
+    event->nextBin = async_queue.load(std::memory_order_relaxed);
+    while (!async_queue.compare_exchange_weak(event->nextBin, event,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
 }
 
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex.lock();
+    if (!async_queue.load(std::memory_order_relaxed))
+        return;
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    // Take all pending events at once and insert them oldest first, in
+    // the order they were scheduled.
+    Event *pending = async_queue.exchange(nullptr, std::memory_order_acquire);
+    Event *oldest = nullptr;
+    while (pending) {
+        Event *next = pending->nextBin;
+        pending->nextBin = oldest;
+        oldest = pending;
+        pending = next;
     }
 
-    async_queue_mutex.unlock();
+    while (oldest) {
+        Event *next = oldest->nextBin;
+        if (independentEventQueues && oldest->when() < getCurTick())
+            oldest->setWhen(getCurTick(), this);
+        insert(oldest);
+        oldest = next;
+    }
 }
 
 } // namespace gem5
@@ -36,6 +36,7 @@
 #define __SIM_EVENTQ_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <functional>
@@ -43,6 +44,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
@@ -57,6 +59,7 @@ namespace gem5
 
 class EventQueue;       // forward declaration
 class BaseGlobalEvent;
+class EventProfile;
 
 //! Simulation Quantum for multiple eventq simulation.
 //! The quantum value is the period length after which the queues
@@ -65,6 +68,12 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Set if the main event queues do not interact, e.g. because each one
+//! simulates a separate System. The queues then run without a quantum,
+//! each one has its own current tick, and an exit only stops the queue
+//! that requested it (see simulate()).
+extern bool independentEventQueues;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -265,6 +274,14 @@ class Event : public EventBase, public Serializable
     Event *nextBin;
     Event *nextInBin;
 
+    // The heap and calendar queues (see EventQueue::Backend) order events
+    // in the same bin by these insertion stamps, latest first, to match
+    // the LIFO order of the 'in bin' lists. The heap also keeps track of
+    // the position of each event so that it can be removed quickly. These
+    // 16 bytes are part of every event, whichever backend its queue uses.
+    uint64_t queueOrder;
+    size_t queueIndex;
+
     static Event *insertBefore(Event *event, Event *curr);
     static Event *removeItem(Event *event, Event *last);
 
@@ -412,7 +429,8 @@ class Event : public EventBase, public Serializable
      * @ingroup api_eventq
      */
     Event(Priority p = Default_Pri, Flags f = 0)
-        : nextBin(nullptr), nextInBin(nullptr), _when(0), _priority(p),
+        : nextBin(nullptr), nextInBin(nullptr), queueOrder(0),
+          queueIndex(0), _when(0), _priority(p),
           flags(Initialized | f)
     {
         assert(f.noneSet(~PublicWrite));
@@ -612,8 +630,8 @@ operator!=(const Event &l, const Event &r)
  * schedule() method with the 'global' parameter set to true. Unlike
  * the previous queue migration strategy, this strategy is fully
  * deterministic. This causes the event to be inserted in a separate
- * queue of asynchronous events (async_queue), which is merged main
- * event queue at the end of each simulation quantum (by calling the
+ * queue of asynchronous events (async_queue), which is merged into the
+ * main event queue at the end of each simulation quantum (by calling the
  * handleAsyncInsertions() method). Note that this implies that such
  * events must happen at least one simulation quantum into the future,
  * otherwise they risk being scheduled in the past by
@@ -621,18 +639,66 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue
 {
+  public:
+    /**
+     * Data structures that can hold the pending events. All of them
+     * service events in the same order.
+     *
+     * - List: a sorted list of bins (the default). Insertion and removal
+     *   are linear in the number of distinct pending (tick, priority)
+     *   pairs.
+     * - Heap: a binary heap, logarithmic insertion and removal.
+     * - Calendar: a calendar queue (R. Brown, CACM 1988) that resizes
+     *   itself as the queue grows and shrinks, amortized constant
+     *   insertion and removal.
+     *
+     * The default can be changed with the GEM5_EVENTQ_BACKEND environment
+     * variable (list, heap or calendar).
+     */
+    enum class Backend
+    {
+        List,
+        Heap,
+        Calendar
+    };
+
+    static Backend defaultBackend();
+    static void defaultBackend(Backend backend);
+
   private:
     friend void curEventQueue(EventQueue *);
 
     std::string objName;
+
+    //! The next event to service. With the List backend, this is also the
+    //! first bin of the list.
     Event *head;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    UncontendedMutex async_queue_mutex;
+    const Backend backend;
+
+    //! Insertion stamp for the next event (Heap and Calendar).
+    uint64_t nextOrder;
+
+    //! Heap backend: events in heap order.
+    std::vector<Event *> heap;
+
+    //! Calendar backend: one list of events per bucket, sorted and linked
+    //! by nextBin. Buckets are 2^calendarShift ticks wide.
+    std::vector<Event *> calendar;
+    unsigned calendarShift;
+    size_t calendarSize;
+    //! Calendar backend: events removed since the last resize.
+    size_t calendarRemoved;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    //! Events added by other threads to this event queue, most recent
+    //! first. This is a lock-free stack linked through Event::nextBin,
+    //! which is unused until the event is inserted into the main queue.
+    //! Any thread may push, only the owning thread takes the events.
+    std::atomic<Event *> async_queue;
+
+    //! Host time profile of the serviced events, if profiling is enabled.
+    EventProfile *_profile;
 
     /**
      * Lock protecting event handling.
@@ -661,6 +727,27 @@ class EventQueue
     void insert(Event *event);
     void remove(Event *event);
 
+    //! Service order of events in the Heap and Calendar backends.
+    static bool
+    before(const Event *l, const Event *r)
+    {
+        return *l < *r || (*l == *r && l->queueOrder > r->queueOrder);
+    }
+
+    void heapInsert(Event *event);
+    void heapRemove(Event *event);
+    void heapSiftUp(size_t i);
+    void heapSiftDown(size_t i);
+
+    void calendarInsert(Event *event);
+    void calendarRemove(Event *event);
+    size_t calendarBucket(Tick when) const;
+    Event *calendarFindMin(Tick from, bool &searched_all) const;
+    void calendarResize(size_t buckets);
+
+    //! All pending events in service order.
+    std::vector<Event *> sortedEvents() const;
+
     //! Function for adding events to the async queue. The added events
     //! are added to main event queue later. Threads, other than the
     //! owning thread, should call this function instead of insert().
@@ -746,6 +833,7 @@ class EventQueue
      * @ingroup api_eventq
      */
     EventQueue(const std::string &n);
+    EventQueue(const std::string &n, Backend backend);
 
     /**
      * @ingroup api_eventq
@@ -753,6 +841,13 @@ class EventQueue
      */
     virtual const std::string name() const { return objName; }
     void name(const std::string &st) { objName = st; }
+
+    /**
+     * Record the host time of the serviced events into a profile, or stop
+     * profiling if profile is nullptr. The queue does not own the profile.
+     */
+    void profile(EventProfile *profile) { _profile = profile; }
+    EventProfile *profile() const { return _profile; }
     /** @}*/ //end of api_eventq group
 
     /**
@@ -763,11 +858,19 @@ class EventQueue
     void
     schedule(Event *event, Tick when, bool global=false)
     {
-        assert(when >= getCurTick());
+        // Independent queues do not share a current tick, so events that
+        // another queue posts here may be in the past. They are moved to
+        // the current tick when they are inserted.
+        assert((independentEventQueues && this != curEventQueue()) ||
+               when >= getCurTick());
         assert(!event->scheduled());
         assert(event->initialized());
 
         event->setWhen(when, this);
+        // Mark the event before it is published to another thread's
+        // async queue.
+        event->flags.set(Event::Scheduled);
+        event->acquire();
 
         // The check below is to make sure of two things
         // a. A thread schedules local events on other queues through the
@@ -781,8 +884,6 @@ class EventQueue
         } else {
             insert(event);
         }
-        event->flags.set(Event::Scheduled);
-        event->acquire();
 
         if (debug::Event)
             event->trace("scheduled");
@@ -0,0 +1,341 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** An event that appends its id to a log when it is processed. */
+class LogEvent : public Event
+{
+  private:
+    std::vector<int> &log;
+    const int id;
+
+  public:
+    LogEvent(std::vector<int> &log, int id, Priority p = Default_Pri)
+        : Event(p), log(log), id(id)
+    {}
+
+    void process() override { log.push_back(id); }
+    const char *description() const override { return "log event"; }
+};
+
+/**
+ * Schedule a pseudo-random mix of events, some of which are descheduled or
+ * rescheduled, and return the order in which they are serviced.
+ */
+std::vector<int>
+runRandomSchedule(EventQueue::Backend backend, int num_events, Tick spread)
+{
+    EventQueue eq("eq", backend);
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+    std::mt19937 rng(1234);
+
+    for (int i = 0; i < num_events; ++i) {
+        Event::Priority prio = (rng() % 3) - 1;
+        events.emplace_back(new LogEvent(log, i, prio));
+        eq.schedule(events.back().get(), rng() % spread);
+    }
+
+    for (int i = 0; i < num_events; i += 7)
+        eq.deschedule(events[i].get());
+    for (int i = 3; i < num_events; i += 11)
+        eq.reschedule(events[i].get(), rng() % spread, true);
+
+    while (!eq.empty()) {
+        Event *event = eq.getHead();
+        eq.setCurTick(event->when());
+        eq.serviceOne();
+
+        // Keep adding events while the queue drains
+        if (log.size() % 5 == 0 && log.size() < num_events) {
+            events.emplace_back(new LogEvent(log, events.size()));
+            eq.schedule(events.back().get(),
+                        eq.getCurTick() + rng() % spread);
+        }
+    }
+
+    return log;
+}
+
+} // anonymous namespace
+
+class EventQueueBackendTest :
+    public testing::TestWithParam<EventQueue::Backend>
+{
+};
+
+/** Events are serviced by time, then by priority. */
+TEST_P(EventQueueBackendTest, TimeAndPriorityOrder)
+{
+    EventQueue eq("eq", GetParam());
+    std::vector<int> log;
+
+    LogEvent e0(log, 0), e1(log, 1, Event::Maximum_Pri),
+        e2(log, 2, Event::Minimum_Pri), e3(log, 3);
+
+    eq.schedule(&e0, 20);
+    eq.schedule(&e1, 10);
+    eq.schedule(&e2, 10);
+    eq.schedule(&e3, 5);
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    EXPECT_EQ(log, std::vector<int>({3, 2, 1, 0}));
+    EXPECT_EQ(eq.getCurTick(), 20);
+}
+
+/** Events with the same time and priority are serviced LIFO. */
+TEST_P(EventQueueBackendTest, LifoWithinBin)
+{
+    EventQueue eq("eq", GetParam());
+    std::vector<int> log;
+
+    LogEvent e0(log, 0), e1(log, 1), e2(log, 2);
+
+    eq.schedule(&e0, 10);
+    eq.schedule(&e1, 10);
+    eq.schedule(&e2, 10);
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    EXPECT_EQ(log, std::vector<int>({2, 1, 0}));
+}
+
+/** Descheduled events are not serviced and rescheduled events move. */
+TEST_P(EventQueueBackendTest, DescheduleReschedule)
+{
+    EventQueue eq("eq", GetParam());
+    std::vector<int> log;
+
+    LogEvent e0(log, 0), e1(log, 1), e2(log, 2);
+
+    eq.schedule(&e0, 10);
+    eq.schedule(&e1, 20);
+    eq.schedule(&e2, 30);
+
+    eq.deschedule(&e0);
+    EXPECT_FALSE(e0.scheduled());
+    EXPECT_EQ(eq.nextTick(), 20);
+
+    eq.reschedule(&e2, 5);
+    EXPECT_EQ(eq.nextTick(), 5);
+    EXPECT_TRUE(eq.debugVerify());
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    EXPECT_EQ(log, std::vector<int>({2, 1}));
+}
+
+/** Handing out and restoring the pending events keeps their order. */
+TEST_P(EventQueueBackendTest, ReplaceHead)
+{
+    EventQueue eq("eq", GetParam());
+    std::vector<int> log;
+
+    LogEvent e0(log, 0), e1(log, 1), e2(log, 2), e3(log, 3);
+
+    eq.schedule(&e0, 10);
+    eq.schedule(&e1, 10);
+    eq.schedule(&e2, 15);
+    eq.schedule(&e3, 30);
+
+    Event *saved = eq.replaceHead(nullptr);
+    EXPECT_TRUE(eq.empty());
+    eq.replaceHead(saved);
+    EXPECT_TRUE(eq.debugVerify());
+
+    while (!eq.empty())
+        eq.serviceOne();
+
+    EXPECT_EQ(log, std::vector<int>({1, 0, 2, 3}));
+}
+
+/** A large random schedule stays consistent. */
+TEST_P(EventQueueBackendTest, RandomScheduleConsistent)
+{
+    auto log = runRandomSchedule(GetParam(), 2000, 100000);
+    EXPECT_GE(log.size(), 2000 - 2000 / 7);
+}
+
+/**
+ * A pending event at MaxTick, like the limit event of simulate(), does not
+ * disturb the order of the other events when the calendar is resized.
+ */
+TEST_P(EventQueueBackendTest, MaxTickEventPending)
+{
+    EventQueue eq("eq", GetParam());
+    std::vector<int> log;
+
+    LogEvent limit(log, -1), e1(log, 1), e2(log, 2), e3(log, 3);
+    std::vector<std::unique_ptr<LogEvent>> sparse;
+
+    eq.schedule(&limit, MaxTick);
+    for (int i = 0; i < 16; ++i) {
+        sparse.emplace_back(new LogEvent(log, 0));
+        eq.schedule(sparse.back().get(), 100 * (i + 1));
+    }
+    eq.schedule(&e1, 100000);
+
+    // The events are sparse, so servicing them makes the calendar
+    // recompute its bucket width with only 100000 and MaxTick pending
+    for (int i = 0; i < 16; ++i)
+        eq.serviceOne();
+    EXPECT_TRUE(eq.debugVerify());
+
+    eq.schedule(&e2, 100010);
+    eq.schedule(&e3, 100005);
+    EXPECT_TRUE(eq.debugVerify());
+
+    while (eq.nextTick() < MaxTick)
+        eq.serviceOne();
+
+    std::vector<int> expected(16, 0);
+    expected.insert(expected.end(), {1, 3, 2});
+    EXPECT_EQ(log, expected);
+    EXPECT_EQ(eq.getHead(), &limit);
+    eq.deschedule(&limit);
+    EXPECT_TRUE(eq.empty());
+}
+
+/**
+ * Events scheduled by other threads in parallel mode all reach the queue
+ * and keep the LIFO order within a bin.
+ */
+TEST_P(EventQueueBackendTest, AsyncInsertFromThreads)
+{
+    const int num_threads = 4;
+    const int per_thread = 5000;
+
+    EventQueue eq("eq", GetParam());
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+    for (int i = 0; i < num_threads * per_thread + 3; ++i)
+        events.emplace_back(new LogEvent(log, i));
+
+    EventQueue *prev_queue = curEventQueue();
+    curEventQueue(&eq);
+    inParallelMode = true;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = t; i < num_threads * per_thread; i += num_threads)
+                eq.schedule(events[i].get(), 10 + i);
+        });
+    }
+    for (auto &thread: threads)
+        thread.join();
+
+    // Three events in the same bin, scheduled in order from one thread
+    std::thread([&]() {
+        for (int i = 0; i < 3; ++i)
+            eq.schedule(events[num_threads * per_thread + i].get(), 1);
+    }).join();
+
+    EXPECT_TRUE(eq.empty());
+    eq.handleAsyncInsertions();
+    inParallelMode = false;
+
+    while (!eq.empty()) {
+        eq.setCurTick(eq.getHead()->when());
+        eq.serviceOne();
+    }
+    curEventQueue(prev_queue);
+
+    std::vector<int> expected;
+    for (int i = 2; i >= 0; --i)
+        expected.push_back(num_threads * per_thread + i);
+    for (int i = 0; i < num_threads * per_thread; ++i)
+        expected.push_back(i);
+    EXPECT_EQ(log, expected);
+}
+
+/**
+ * Independent queues do not share a current tick, so an event that another
+ * thread posts in the past of the queue is moved to the current tick.
+ */
+TEST_P(EventQueueBackendTest, IndependentAsyncInsertInThePast)
+{
+    EventQueue eq("eq", GetParam());
+    std::vector<int> log;
+    LogEvent past(log, 0), future(log, 1);
+
+    EventQueue *prev_queue = curEventQueue();
+    curEventQueue(&eq);
+    eq.setCurTick(100);
+    inParallelMode = true;
+    independentEventQueues = true;
+
+    std::thread([&]() {
+        eq.schedule(&past, 50);
+        eq.schedule(&future, 150);
+    }).join();
+    eq.handleAsyncInsertions();
+
+    independentEventQueues = false;
+    inParallelMode = false;
+
+    EXPECT_EQ(past.when(), 100);
+    EXPECT_EQ(future.when(), 150);
+    while (!eq.empty())
+        eq.serviceOne();
+    curEventQueue(prev_queue);
+
+    EXPECT_EQ(log, std::vector<int>({0, 1}));
+}
+
+INSTANTIATE_TEST_SUITE_P(EventQueue, EventQueueBackendTest,
+    testing::Values(EventQueue::Backend::List, EventQueue::Backend::Heap,
+                    EventQueue::Backend::Calendar));
+
+/** All backends service a random schedule in exactly the same order. */
+TEST(EventQueueBackendEquivalenceTest, SameServiceOrder)
+{
+    for (Tick spread: {Tick(10), Tick(1000), Tick(1000000)}) {
+        auto list = runRandomSchedule(EventQueue::Backend::List, 3000,
+                                      spread);
+        EXPECT_EQ(list, runRandomSchedule(EventQueue::Backend::Heap, 3000,
+                                          spread));
+        EXPECT_EQ(list, runRandomSchedule(EventQueue::Backend::Calendar,
+                                          3000, spread));
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Measures the throughput of the event queue backends. A fixed population
+ * of self-rescheduling events is kept pending, which models the "hold"
+ * pattern of a running simulation: every serviced event schedules itself
+ * again a pseudo-random delay into the future.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class HoldEvent : public Event
+{
+  private:
+    EventQueue &eq;
+    std::minstd_rand &rng;
+    const Tick maxDelay;
+
+  public:
+    HoldEvent(EventQueue &eq, std::minstd_rand &rng, Tick max_delay,
+              Priority p)
+        : Event(p), eq(eq), rng(rng), maxDelay(max_delay)
+    {}
+
+    void
+    process() override
+    {
+        eq.schedule(this, eq.getCurTick() + 1 + rng() % maxDelay);
+    }
+
+    const char *description() const override { return "hold"; }
+};
+
+double
+eventsPerSecond(EventQueue::Backend backend, size_t num_events,
+                Tick max_delay, uint64_t iterations)
+{
+    EventQueue eq("eq", backend);
+    std::minstd_rand rng(1);
+    std::vector<std::unique_ptr<HoldEvent>> events;
+
+    for (size_t i = 0; i < num_events; ++i) {
+        events.emplace_back(new HoldEvent(eq, rng, max_delay,
+                                          Event::Default_Pri + i % 3));
+        eq.schedule(events.back().get(), rng() % max_delay);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        eq.setCurTick(eq.nextTick());
+        eq.serviceOne();
+    }
+    std::chrono::duration<double> secs =
+        std::chrono::steady_clock::now() - start;
+
+    for (auto &event : events)
+        eq.deschedule(event.get());
+
+    return iterations / secs.count();
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    const struct
+    {
+        EventQueue::Backend backend;
+        const char *name;
+    } backends[] = {
+        { EventQueue::Backend::List, "list" },
+        { EventQueue::Backend::Heap, "heap" },
+        { EventQueue::Backend::Calendar, "calendar" },
+    };
+
+    std::cout << std::setw(10) << "events" << std::setw(12) << "delay";
+    for (const auto &b : backends)
+        std::cout << std::setw(14) << b.name;
+    std::cout << "  (events/s)" << std::endl;
+
+    for (size_t num_events : {16, 256, 4096, 65536}) {
+        for (Tick max_delay : {Tick(1000), Tick(1000000)}) {
+            // The list backend is linear in the number of bins
+            uint64_t iterations = 2000000;
+            std::cout << std::setw(10) << num_events
+                      << std::setw(12) << max_delay;
+            for (const auto &b : backends) {
+                uint64_t n = b.backend == EventQueue::Backend::List ?
+                    std::min<uint64_t>(iterations,
+                                       400000000 / num_events) :
+                    iterations;
+                std::cout << std::setw(14) << std::fixed
+                          << std::setprecision(0)
+                          << eventsPerSecond(b.backend, num_events,
+                                             max_delay, n)
+                          << std::flush;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -29,6 +29,7 @@
 
 #include "sim/global_event.hh"
 
+#include "base/logging.hh"
 #include "sim/cur_tick.hh"
 
 namespace gem5
@@ -112,6 +113,34 @@ void BaseGlobalEvent::reschedule(Tick when)
     globalQMutex.unlock();
 }
 
+void BaseGlobalEvent::rescheduleAfter(Tick delay)
+{
+    assert(!inParallelMode);
+    globalQMutex.lock();
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        EventQueue *q = mainEventQueue[i];
+        Tick now = q->getCurTick();
+        Tick when = delay < MaxTick - now ? now + delay : MaxTick;
+        q->reschedule(barrierEvent[i], when, true);
+    }
+
+    globalQMutex.unlock();
+}
+
+void BaseGlobalEvent::scheduleLocal(Tick when)
+{
+    EventQueue *q = curEventQueue();
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        if (mainEventQueue[i] == q) {
+            q->schedule(barrierEvent[i], when);
+            return;
+        }
+    }
+
+    panic("%s: not scheduled from a main event queue", description());
+}
+
 BaseGlobalEvent::BarrierEvent::~BarrierEvent()
 {
     // if AutoDelete is set, local events will get deleted in event
@@ -129,6 +158,14 @@ BaseGlobalEvent::BarrierEvent::~BarrierEvent()
 void
 GlobalEvent::BarrierEvent::process()
 {
+    // Independent queues do not wait for each other. An exit event just
+    // stops the queue that reaches it (see simulate()).
+    if (inParallelMode && independentEventQueues) {
+        panic_if(!isExitEvent(), "%s is not supported with independent "
+                 "event queues", _globalEvent->description());
+        return;
+    }
+
     // wait for all queues to arrive at barrier, then process event
     if (globalBarrier()) {
         _globalEvent->process();
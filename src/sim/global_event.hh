@@ -144,6 +144,20 @@ class BaseGlobalEvent : public EventBase
 
     void deschedule();
     void reschedule(Tick when);
+
+    /**
+     * Reschedule the event delay ticks after the current tick of each
+     * event queue. Independent event queues (see independentEventQueues)
+     * do not share a current tick. Must not be called while the queues
+     * are running.
+     */
+    void rescheduleAfter(Tick delay);
+
+    /**
+     * Schedule the event on the event queue of the calling thread only,
+     * e.g. to stop just that queue when the queues are independent.
+     */
+    void scheduleLocal(Tick when);
 };
 
 
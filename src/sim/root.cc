@@ -41,6 +41,7 @@
 
 #include "base/hostinfo.hh"
 #include "base/logging.hh"
+#include "base/output.hh"
 #include "base/trace.hh"
 #include "debug/TimeSync.hh"
 #include "sim/core.hh"
@@ -177,7 +178,8 @@ Root::timeSyncSpinThreshold(Time newThreshold)
 
 Root::Root(const RootParams &p, int)
     : SimObject(p), _enabled(false), _periodTick(p.time_sync_period),
-      syncEvent([this]{ timeSync(); }, name())
+      syncEvent([this]{ timeSync(); }, name()),
+      eventProfileStream(nullptr)
 {
     _period.setTick(p.time_sync_period);
     _spinThreshold.setTick(p.time_sync_spin_threshold);
@@ -187,6 +189,9 @@ Root::Root(const RootParams &p, int)
     lastTime.setTimer();
 
     simQuantum = p.sim_quantum;
+    independentEventQueues = p.independent_eventqs;
+    warn_if(independentEventQueues && simQuantum,
+            "sim_quantum is ignored with independent event queues.");
 
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
@@ -199,6 +204,49 @@ void
 Root::startup()
 {
     timeSyncEnable(params().time_sync_enable);
+
+    if (params().profile_events) {
+        for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+            eventProfiles.emplace_back(new EventProfile);
+            mainEventQueue[i]->profile(eventProfiles.back().get());
+        }
+        eventProfileStream = simout.create("event_profile.txt");
+
+        statistics::registerDumpCallback([this]() { dumpEventProfile(); });
+        statistics::registerResetCallback([this]() {
+            for (auto &profile : eventProfiles)
+                profile->clear();
+        });
+    }
+}
+
+void
+Root::dumpEventProfile()
+{
+    std::vector<const EventProfile *> profiles;
+    for (auto &profile : eventProfiles)
+        profiles.push_back(profile.get());
+
+    // Events are usually named after their owner, e.g.
+    // "system.cpu.wrapped_function_event", so the owner is the longest
+    // prefix of the name that is a SimObject
+    auto owner = [](const std::string &event) {
+        std::string name = event;
+        for (auto pos = name.rfind('.'); pos != std::string::npos;
+                pos = name.rfind('.')) {
+            name.resize(pos);
+            if (SimObject::find(name.c_str()))
+                return name;
+        }
+        return std::string("(unknown)");
+    };
+
+    std::ostream &os = *eventProfileStream->stream();
+    ccprintf(os, "\n---------- Begin Event Profile (tick %d) ----------\n",
+             curTick());
+    EventProfile::report(os, profiles, owner);
+    ccprintf(os, "\n---------- End Event Profile ----------\n");
+    os.flush();
 }
 
 void
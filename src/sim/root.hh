@@ -51,10 +51,14 @@
 #ifndef __SIM_ROOT_HH__
 #define __SIM_ROOT_HH__
 
+#include <memory>
+#include <vector>
+
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "base/types.hh"
 #include "params/Root.hh"
+#include "sim/event_profile.hh"
 #include "sim/eventq.hh"
 #include "sim/globals.hh"
 #include "sim/sim_object.hh"
@@ -62,6 +66,8 @@
 namespace gem5
 {
 
+class OutputStream;
+
 class Root : public SimObject
 {
   private:
@@ -80,6 +86,13 @@ class Root : public SimObject
     void timeSync();
     EventFunctionWrapper syncEvent;
 
+    /// Host time profiles of the main event queues, if profile_events
+    std::vector<std::unique_ptr<EventProfile>> eventProfiles;
+    OutputStream *eventProfileStream;
+
+    /// Append a report of the event profiles to event_profile.txt
+    void dumpEventProfile();
+
   public:
     /**
      * Use this function to get a pointer to the single Root object in the
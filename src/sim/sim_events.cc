@@ -45,6 +45,7 @@
 #include <string>
 
 #include "base/callback.hh"
+#include "base/logging.hh"
 #include "sim/eventq.hh"
 #include "sim/sim_exit.hh"
 #include "sim/stats.hh"
@@ -67,6 +68,14 @@ GlobalSimLoopExitEvent::GlobalSimLoopExitEvent(const std::string &_cause,
 {
 }
 
+GlobalSimLoopExitEvent::GlobalSimLoopExitEvent(Priority p,
+                                               const std::string &_cause,
+                                               int c, Tick r)
+    : GlobalEvent(p, IsExitEvent),
+      cause(_cause), code(c), repeat(r)
+{
+}
+
 const char *
 GlobalSimLoopExitEvent::description() const
 {
@@ -84,6 +93,22 @@ GlobalSimLoopExitEvent::process()
     }
 }
 
+/**
+ * Stop only the event queue of the calling thread. Independent main event
+ * queues (see independentEventQueues) do not stop each other.
+ */
+static void
+exitEventQueue(const std::string &message, int exit_code, Tick when,
+               Tick repeat, Event::Priority priority)
+{
+    assert(independentEventQueues);
+    warn_if(repeat, "Repeating exits are not supported with independent "
+            "event queues.");
+
+    auto *event = new GlobalSimLoopExitEvent(priority, message, exit_code);
+    event->scheduleLocal(when);
+}
+
 void
 exitSimLoop(const std::string &message, int exit_code, Tick when, Tick repeat,
             bool serialize)
@@ -92,6 +117,12 @@ exitSimLoop(const std::string &message, int exit_code, Tick when, Tick repeat,
             "exitSimLoop called with a delay and auto serialization. This is "
             "currently unsupported.");
 
+    if (inParallelMode && independentEventQueues) {
+        exitEventQueue(message, exit_code, when, repeat,
+                       Event::Sim_Exit_Pri);
+        return;
+    }
+
     new GlobalSimLoopExitEvent(when + simQuantum, message, exit_code, repeat);
 }
 
@@ -99,6 +130,12 @@ void
 exitSimLoopNow(const std::string &message, int exit_code, Tick repeat,
                bool serialize)
 {
+    if (inParallelMode && independentEventQueues) {
+        exitEventQueue(message, exit_code, curTick(), repeat,
+                       Event::Minimum_Pri);
+        return;
+    }
+
     new GlobalSimLoopExitEvent(message, exit_code, repeat);
 }
 
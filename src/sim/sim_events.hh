@@ -64,6 +64,9 @@ class GlobalSimLoopExitEvent : public GlobalEvent
     GlobalSimLoopExitEvent(Tick when, const std::string &_cause, int c,
                            Tick repeat = 0);
     GlobalSimLoopExitEvent(const std::string &_cause, int c, Tick repeat = 0);
+    /** Create an exit event without scheduling it. */
+    GlobalSimLoopExitEvent(Priority p, const std::string &_cause, int c,
+                           Tick repeat = 0);
 
     const std::string getCause() const { return cause; }
     int getCode() const { return code; }
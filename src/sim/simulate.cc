@@ -73,7 +73,9 @@ class SimulatorThreads
     SimulatorThreads(uint32_t num_queues)
         : terminate(false),
           numQueues(num_queues),
-          barrier(num_queues)
+          barrier(num_queues),
+          stopEvents(num_queues, nullptr),
+          stopBarrier(num_queues)
     {
         threads.reserve(num_queues);
     }
@@ -101,8 +103,8 @@ class SimulatorThreads
             // We'll call these the "subordinate" threads.
             for (uint32_t i = 1; i < numQueues; i++) {
                 threads.emplace_back(
-                    [this](EventQueue *eq) {
-                        thread_main(eq);
+                    [this, i](EventQueue *eq) {
+                        thread_main(eq, i);
                     }, mainEventQueue[i]);
             }
         }
@@ -114,6 +116,28 @@ class SimulatorThreads
         barrier.wait();
     }
 
+    /**
+     * Wait until all independent event queues have stopped (see
+     * independentEventQueues), after the main thread's queue stopped at
+     * exit_event.
+     *
+     * @return The exit event of the lowest numbered queue that did not
+     * stop at the simulate() limit, or the limit if they all did.
+     */
+    Event *
+    waitUntilStopped(Event *exit_event)
+    {
+        stopped(0, exit_event);
+        for (Event *event : stopEvents) {
+            if (event->globalEvent() != simulate_limit_event)
+                return event;
+        }
+        return stopEvents[0];
+    }
+
+    /** The exit events at which the queues stopped. */
+    const std::vector<Event *> &getStopEvents() const { return stopEvents; }
+
     void
     terminateThreads()
     {
@@ -148,25 +172,81 @@ class SimulatorThreads
      * repeated until the simulation terminates.
      */
     void
-    thread_main(EventQueue *queue)
+    thread_main(EventQueue *queue, uint32_t index)
     {
         /* Wait for all initialisation to complete */
         barrier.wait();
 
         while (!terminate) {
-            doSimLoop(queue);
+            Event *exit_event = doSimLoop(queue);
+            if (independentEventQueues)
+                stopped(index, exit_event);
             barrier.wait();
         }
     }
 
+    /**
+     * Independent event queues stop one at a time, each at its own exit
+     * event. Record where queue index stopped and wait for the others.
+     */
+    void
+    stopped(uint32_t index, Event *exit_event)
+    {
+        stopEvents[index] = exit_event;
+        stopBarrier.wait();
+    }
+
     std::atomic<bool> terminate;
     uint32_t numQueues;
     std::vector<std::thread> threads;
     Barrier barrier;
+
+    std::vector<Event *> stopEvents;
+    Barrier stopBarrier;
 };
 
 static std::unique_ptr<SimulatorThreads> simulatorThreads;
 
+static std::vector<GlobalSimLoopExitEvent *> exitEvents;
+
+static GlobalSimLoopExitEvent *
+globalExitEvent(Event *local_event)
+{
+    // locate the global exit event behind a queue's local exit event
+    BaseGlobalEvent *global_event = local_event->globalEvent();
+    assert(global_event);
+
+    GlobalSimLoopExitEvent *global_exit_event =
+        dynamic_cast<GlobalSimLoopExitEvent *>(global_event);
+    assert(global_exit_event);
+
+    return global_exit_event;
+}
+
+/**
+ * A broadcast exit, e.g. a user interrupt, stops every independent event
+ * queue that reaches it before its own exit. Remove the copies that the
+ * other queues have not reached, so that they do not stop the next
+ * simulate() call right away. Must be called after the queues stopped.
+ */
+static void
+discardStopEvents(const std::vector<Event *> &stop_events)
+{
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        curEventQueue(mainEventQueue[i]);
+        mainEventQueue[i]->handleAsyncInsertions();
+    }
+    curEventQueue(mainEventQueue[0]);
+
+    for (Event *event : stop_events) {
+        BaseGlobalEvent *global_event = event->globalEvent();
+        if (global_event && global_event != simulate_limit_event &&
+                global_event->scheduled()) {
+            global_event->deschedule();
+        }
+    }
+}
+
 struct DescheduleDeleter
 {
     void operator()(BaseGlobalEvent *event)
@@ -182,6 +262,13 @@ struct DescheduleDeleter
 /** Simulate for num_cycles additional cycles.  If num_cycles is -1
  * (the default), do not limit simulation; some other event must
  * terminate the loop.  Exported to Python.
+ *
+ * Independent event queues each stop at their own exit event. Then the
+ * exit event of the lowest numbered queue that did not reach the
+ * simulate() limit is returned, so that a cause such as m5_exit is not
+ * hidden by another queue reaching the limit; getExitEvents() has the
+ * exit event of every queue.
+ *
  * @return The SimLoopExitEvent that caused the loop to exit.
  */
 GlobalSimLoopExitEvent *
@@ -201,15 +288,22 @@ simulate(Tick num_cycles)
             mainEventQueue[0]->getCurTick(),
             "simulate() limit reached", 0);
     }
-    simulate_limit_event->reschedule(exit_tick);
+    // Independent event queues each have their own current tick, so each
+    // one runs for num_cycles of its own time.
+    if (independentEventQueues)
+        simulate_limit_event->rescheduleAfter(num_cycles);
+    else
+        simulate_limit_event->reschedule(exit_tick);
 
     if (numMainEventQueues > 1) {
-        fatal_if(simQuantum == 0,
-                 "Quantum for multi-eventq simulation not specified");
+        if (!independentEventQueues) {
+            fatal_if(simQuantum == 0,
+                     "Quantum for multi-eventq simulation not specified");
 
-        quantum_event.reset(
-            new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
-                                EventBase::Progress_Event_Pri, 0));
+            quantum_event.reset(
+                new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
+                                    EventBase::Progress_Event_Pri, 0));
+        }
 
         inParallelMode = true;
     }
@@ -218,19 +312,36 @@ simulate(Tick num_cycles)
     Event *local_event = doSimLoop(mainEventQueue[0]);
     assert(local_event);
 
+    exitEvents.clear();
+    if (independentEventQueues && numMainEventQueues > 1) {
+        local_event = simulatorThreads->waitUntilStopped(local_event);
+
+        const auto &stop_events = simulatorThreads->getStopEvents();
+        for (uint32_t i = 0; i < stop_events.size(); ++i) {
+            exitEvents.push_back(globalExitEvent(stop_events[i]));
+            inform("Event queue %d exited @ %d because %s\n", i,
+                   stop_events[i]->when(), exitEvents.back()->getCause());
+        }
+    }
+
     inParallelMode = false;
 
-    // locate the global exit event and return it to Python
-    BaseGlobalEvent *global_event = local_event->globalEvent();
-    assert(global_event);
+    if (independentEventQueues && numMainEventQueues > 1)
+        discardStopEvents(simulatorThreads->getStopEvents());
 
-    GlobalSimLoopExitEvent *global_exit_event =
-        dynamic_cast<GlobalSimLoopExitEvent *>(global_event);
-    assert(global_exit_event);
+    GlobalSimLoopExitEvent *global_exit_event = globalExitEvent(local_event);
+    if (exitEvents.empty())
+        exitEvents.push_back(global_exit_event);
 
     return global_exit_event;
 }
 
+const std::vector<GlobalSimLoopExitEvent *> &
+getExitEvents()
+{
+    return exitEvents;
+}
+
 void
 terminateEventQueueThreads()
 {
@@ -284,7 +395,13 @@ doSimLoop(EventQueue *eventq)
             // routines want to schedule new events.
             std::lock_guard<EventQueue> lock(*eventq);
             if (async_statdump || async_statreset) {
-                statistics::schedStatEvent(async_statdump, async_statreset);
+                if (inParallelMode && independentEventQueues) {
+                    warn("Ignoring the stats dump/reset request, they are "
+                         "not supported with independent event queues.");
+                } else {
+                    statistics::schedStatEvent(async_statdump,
+                                               async_statreset);
+                }
                 async_statdump = false;
                 async_statreset = false;
             }
@@ -296,7 +413,13 @@ doSimLoop(EventQueue *eventq)
 
             if (async_exit) {
                 async_exit = false;
-                exitSimLoop("user interrupt received");
+                // exitSimLoop() would only stop this queue if the queues
+                // are independent
+                if (independentEventQueues)
+                    new GlobalSimLoopExitEvent(curTick(),
+                                               "user interrupt received", 0);
+                else
+                    exitSimLoop("user interrupt received");
             }
 
             if (async_exception) {
@@ -305,6 +428,11 @@ doSimLoop(EventQueue *eventq)
             }
         }
 
+        // Independent queues never synchronize, so they pick up the
+        // events that other threads post here as they go.
+        if (independentEventQueues)
+            eventq->handleAsyncInsertions();
+
         Event *exit_event = eventq->serviceOne();
         if (exit_event != NULL) {
             return exit_event;
@@ -38,6 +38,8 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <vector>
+
 #include "base/types.hh"
 
 namespace gem5
@@ -47,6 +49,13 @@ class GlobalSimLoopExitEvent;
 
 GlobalSimLoopExitEvent *simulate(Tick num_cycles = MaxTick);
 
+/**
+ * The exit events at which the last simulate() call stopped, indexed by
+ * main event queue when the queues are independent (see
+ * independentEventQueues). Otherwise, only the returned exit event.
+ */
+const std::vector<GlobalSimLoopExitEvent *> &getExitEvents();
+
 /**
  * Terminate helper threads when running in parallel mode.
  *
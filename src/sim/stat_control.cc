@@ -50,6 +50,7 @@
 #include <list>
 
 #include "base/callback.hh"
+#include "base/logging.hh"
 #include "base/statistics.hh"
 #include "base/time.hh"
 #include "sim/global_event.hh"
@@ -110,6 +111,15 @@ schedStatEvent(bool dump, bool reset, Tick when, Tick repeat)
     // dumped so as to ensure that this event happens only after the next
     // sync amongst the event queues.  Asingle event queue simulation
     // should remain unaffected.
+    // A guest of one System must not stop the others, so ignore the
+    // request like the asynchronous one in doSimLoop()
+    if (independentEventQueues && numMainEventQueues > 1) {
+        warn("Ignoring the stats dump/reset request, they are not "
+             "supported with independent event queues. Dump or reset "
+             "them from Python between simulate() calls instead.");
+        return;
+    }
+
     dumpEvent = new StatEvent(when + simQuantum, dump, reset, repeat);
 }
 
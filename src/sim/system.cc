@@ -175,6 +175,23 @@ System::Threads::quiesceTick(ContextID id, Tick when)
 
 int System::numSystemsRunning = 0;
 
+namespace
+{
+
+memory::StoreCheckpointConfig
+storeCheckpointConfig(const SystemParams &p)
+{
+    memory::StoreCheckpointConfig config;
+    config.chunkSize = p.memory_checkpoint_chunk_size;
+    config.threads = p.memory_checkpoint_threads;
+    config.compression = p.memory_checkpoint_compression;
+    config.base = p.memory_checkpoint_base;
+    config.lazyRestore = p.memory_checkpoint_lazy_restore;
+    return config;
+}
+
+} // anonymous namespace
+
 System::System(const Params &p)
     : SimObject(p), _systemPort("system_port", this),
       multiThread(p.multi_thread),
@@ -182,7 +199,8 @@ System::System(const Params &p)
       physProxy(_systemPort, p.cache_line_size),
       workload(p.workload),
       physmem(name() + ".physmem", p.memories, p.mmap_using_noreserve,
-              p.shared_backstore, p.auto_unlink_shared_backstore),
+              p.shared_backstore, p.auto_unlink_shared_backstore,
+              storeCheckpointConfig(p)),
       ShadowRomRanges(p.shadow_rom_ranges.begin(),
                       p.shadow_rom_ranges.end()),
       memoryMode(p.mem_mode),
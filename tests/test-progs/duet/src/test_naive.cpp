@@ -99,5 +99,5 @@ int main(int argc, char *argv[]) {
         printf ( "Pass!\n" );
     }
 
-    return 0;
+    return mismatch ? 1 : 0;
 }
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Reader for gem5's binary columnar stat files.
+
+The files are written by the columnar stat output, enabled with
+--stats-file=col://stats.col. Each file holds one or more segments. A
+segment is a list of column names followed by the values of every stat
+dump taken while the set of stats did not change.
+
+Example:
+    import columnar_stats
+    df = columnar_stats.to_dataframe("m5out/stats.col",
+                                     columns=r".*\\.duet\\..*")
+
+As a script, it prints the selected columns as CSV:
+    columnar_stats.py m5out/stats.col -c 'system\\.cpu\\.numCycles'
+"""
+
+import argparse
+import re
+import struct
+import sys
+import zlib
+
+MAGIC = b"gem5col\0"
+VERSION = 1
+
+SCHEMA_RECORD = 1
+VALUES_RECORD = 2
+
+FLAG_DELTA = 0x1
+FLAG_COMPRESSED = 0x2
+
+class Segment(object):
+    """Stat dumps that share the same columns.
+
+    Attributes:
+      * names: list of column names
+      * descs: list of column descriptions
+      * rows: list of dumps, each an array of float64 values, or a
+              2-dimensional NumPy array after to_numpy()
+    """
+
+    def __init__(self, names, descs):
+        self.names = names
+        self.descs = descs
+        self.rows = []
+
+    def to_numpy(self):
+        import numpy
+        return numpy.array(self.rows, dtype=numpy.float64).reshape(
+            len(self.rows), len(self.names))
+
+def _unpack_values(payload, flags, count, last):
+    if flags & FLAG_COMPRESSED:
+        (raw_size, ) = struct.unpack_from("=Q", payload)
+        payload = zlib.decompress(payload[8:])
+        if len(payload) != raw_size:
+            raise ValueError("Corrupt values record")
+
+    if len(payload) != 8 * count:
+        raise ValueError("Values record doesn't match the schema")
+
+    if flags & FLAG_DELTA:
+        bits = struct.unpack("=%dQ" % count, payload)
+        bits = [ b ^ l for b, l in zip(bits, last) ]
+        payload = struct.pack("=%dQ" % count, *bits)
+
+    return payload
+
+def read(path):
+    """Read a columnar stat file.
+
+    Returns a list of Segment objects, in file order.
+    """
+
+    segments = []
+    with open(path, "rb") as f:
+        header = f.read(16)
+        if len(header) != 16 or header[:8] != MAGIC:
+            raise ValueError("%s is not a columnar stat file" % path)
+        (version, ) = struct.unpack_from("=I", header, 8)
+        if version != VERSION:
+            raise ValueError("Unsupported version %d" % version)
+
+        last = None
+        while True:
+            record = f.read(16)
+            if len(record) < 16:
+                # A truncated record at the end is a dump in progress
+                break
+            rtype, flags, size = struct.unpack("=IIQ", record)
+            payload = f.read(size)
+            if len(payload) < size:
+                break
+
+            if rtype == SCHEMA_RECORD:
+                (count, ) = struct.unpack_from("=I", payload)
+                pos = 4
+                names, descs = [], []
+                for _ in range(count):
+                    for strings in (names, descs):
+                        (length, ) = struct.unpack_from("=I", payload, pos)
+                        pos += 4
+                        strings.append(
+                            payload[pos:pos + length].decode("utf-8"))
+                        pos += length
+                segments.append(Segment(names, descs))
+                last = None
+            elif rtype == VALUES_RECORD:
+                if not segments:
+                    raise ValueError("Values record without a schema")
+                segment = segments[-1]
+                count = len(segment.names)
+                raw = _unpack_values(payload, flags, count, last)
+                last = struct.unpack("=%dQ" % count, raw)
+                segment.rows.append(struct.unpack("=%dd" % count, raw))
+            else:
+                raise ValueError("Unknown record type %d" % rtype)
+
+    return segments
+
+def to_dataframe(path, columns=None):
+    """Read a columnar stat file into a pandas DataFrame.
+
+    Each row is a stat dump. Columns that are missing from some dumps,
+    because the set of stats changed, are NaN in those dumps.
+
+    Parameters:
+      * columns: optional regular expression that selects the columns
+                 to load
+    """
+
+    import pandas
+
+    pattern = re.compile(columns) if columns else None
+    frames = []
+    for segment in read(path):
+        frame = pandas.DataFrame(segment.to_numpy(), columns=segment.names)
+        if pattern:
+            frame = frame[[ n for n in segment.names
+                            if pattern.fullmatch(n) ]]
+        frames.append(frame)
+
+    if not frames:
+        return pandas.DataFrame()
+    return pandas.concat(frames, ignore_index=True, sort=False)
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Print gem5 columnar stats as CSV")
+    parser.add_argument("file", help="Columnar stat file")
+    parser.add_argument("-c", "--columns", default=None,
+                        help="Regular expression selecting the columns")
+    parser.add_argument("-l", "--list", action="store_true",
+                        help="List the columns and their descriptions")
+    args = parser.parse_args()
+
+    pattern = re.compile(args.columns) if args.columns else None
+    for segment in read(args.file):
+        selected = [ i for i, n in enumerate(segment.names)
+                     if not pattern or pattern.fullmatch(n) ]
+        if args.list:
+            for i in selected:
+                print("%s: %s" % (segment.names[i], segment.descs[i]))
+            continue
+
+        print(",".join(segment.names[i] for i in selected))
+        for row in segment.rows:
+            print(",".join(repr(row[i]) for i in selected))
+
+if __name__ == "__main__":
+    main()